@@ -216,20 +216,6 @@ static const Player players[] = {
     {720, "Usman Ghani", "Afghanistan", "Batsman", 1050, 26.9, 77.4, 0, 0.0}
 };
 
-static const char* teams[] = {
-    "Afghanistan",
-    "Australia",
-    "Bangladesh",
-    "England",
-    "India",
-    "New Zealand",
-    "Pakistan",
-    "South Africa",
-    "Sri Lanka",
-    "West Indies"
-};
-
-static int teamCount = sizeof(teams) / sizeof(teams[0]);
 static int playerCount = sizeof(players) / sizeof(players[0]);
 
 #endif
\ No newline at end of file
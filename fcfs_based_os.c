@@ -3,15 +3,49 @@
 #include <string.h>
 #include <ctype.h>
 #include <stdbool.h>
+#include <limits.h>
+#include <math.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
-#define MAX_PROCESS_TABLE_BUCKETS 1009
+#define INITIAL_PROCESS_TABLE_CAPACITY 1024
 #define MAX_PROCESS_NAME_LEN 64
-#define MAX_PROCESSES 1000
-#define MAX_KILL_EVENTS 1000
+#define PROCESS_POOL_CHUNK_SIZE 4096
+#define TIMELINE_LINK_CHUNK_SIZE 65536
 #define MAX_INT_STR_LEN 16
+#define PROCESS_LINE_FIELDS 7
+#define INITIAL_EVENT_HEAP_CAPACITY 64
+#define INITIAL_KILL_EVENT_CAPACITY 64
+#define INITIAL_PROCESS_HEAP_CAPACITY 64
+#define DEFAULT_TIME_QUANTUM 4
+#define DEFAULT_PROCESS_PRIORITY 20
+#define MLFQ_LEVEL_COUNT 3
+#define MAX_SIMULATED_CPUS 256
+#define MAX_SWEEP_VALUES 16
+#define MAX_SWEEP_IO_PERCENT 100000
+#define MAX_SWEEP_THREADS 1024
+#define SCHEDULER_LOG_MAGIC "FCFSLOG1"
+#define SCHEDULER_LOG_MAGIC_LEN 8
+#define SCHEDULER_LOG_BUFFER_RECORDS 4096
+#define CHECKPOINT_MAGIC "FCFSCKP2"
+#define CHECKPOINT_MAGIC_LEN 8
+#define MAX_WORKLOAD_PROCESSES 10000000
+#define WORKLOAD_MAX_SAMPLE_TICKS 1000000
+#define WORKLOAD_PARETO_SHAPE 1.5
+#define CFS_TIMELINE_LEVELS 12
+#define CFS_TIMELINE_SEED 2463534242u
+#define CFS_TARGET_LATENCY 12
+#define CFS_MIN_GRANULARITY 2
+#define CFS_WAKEUP_GRANULARITY 1
+#define CFS_VRUNTIME_UNIT 1024
+#define CFS_DEFAULT_NICE_INDEX 20
 
 typedef enum
 {
+    STATE_NEW,
     STATE_READY,
     STATE_RUNNING,
     STATE_WAITING,
@@ -28,41 +62,255 @@ typedef struct ProcessControlRecord
     int io_duration_ticks;
     int remaining_io_ticks;
     int executed_cpu_time;
-    int completion_tick;
+    long long completion_tick;
     int configured_io_duration;
     int terminated_by_kill;
-    int killed_at_tick;
+    long long killed_at_tick;
+    long long dispatched_at_tick;
+    long long io_entered_tick;
+    long long io_completion_tick;
+    int heap_index;
+    int dispatch_count;
+    long long dispatch_sequence;
+    long long arrival_tick;
+    long long ready_sequence;
+    int scheduling_priority;
+    int queue_level;
+    long long level_ticks_used;
+    long long virtual_runtime;
+    int timeline_level;
+    int cpu_index;
+    int migration_count;
+    int registry_index;
+    struct ProcessControlRecord **timeline_forward;
     ProcessExecutionState execution_state;
     struct ProcessControlRecord *next_process;
+    struct ProcessControlRecord *previous_process;
+    struct ProcessLinkedQueue *owning_queue;
 } ProcessControlRecord;
 
+/* Intrusive and doubly linked; every queued PCB points back at its queue, so any member unlinks in O(1). */
 typedef struct ProcessLinkedQueue
 {
     ProcessControlRecord *front_process;
     ProcessControlRecord *rear_process;
 } ProcessLinkedQueue;
 
-typedef struct ProcessHashEntry
+typedef struct ProcessIndexSlot
 {
     int process_id_key;
     ProcessControlRecord *process_record;
-    struct ProcessHashEntry *next_entry;
-} ProcessHashEntry;
+} ProcessIndexSlot;
 
 typedef struct KillEventRecord
 {
     int kill_pid;
-    int kill_time;
+    long long kill_time;
+    int kill_sequence;
 } KillEventRecord;
 
-typedef struct RawProcessLine
+/* CPU releases fire at the end of event_tick in CPU order, ahead of any I/O completions due on the same tick;
+   event_sequence holds the dispatch it belongs to so releases left over from a preemption are ignored. */
+typedef struct SchedulerEvent
 {
-    char raw_name[MAX_PROCESS_NAME_LEN];
-    char raw_pid_str[MAX_INT_STR_LEN];
-    char raw_burst_str[MAX_INT_STR_LEN];
-    char raw_io_start_str[MAX_INT_STR_LEN];
-    char raw_io_duration_str[MAX_INT_STR_LEN];
-} RawProcessLine;
+    long long event_tick;
+    int event_cpu;
+    long long event_sequence;
+    ProcessControlRecord *event_process;
+} SchedulerEvent;
+
+typedef struct SchedulerEventHeap
+{
+    SchedulerEvent *heap_events;
+    int event_count;
+    int event_capacity;
+} SchedulerEventHeap;
+
+/* An indexed binary heap; a process sits in at most one heap at a time, so heap_index is shared. */
+typedef struct ProcessHeap
+{
+    ProcessControlRecord **heap_processes;
+    int process_count;
+    int heap_capacity;
+    bool (*precedes)(const ProcessControlRecord *first_process, const ProcessControlRecord *second_process);
+} ProcessHeap;
+
+/* Every CPU owns one; each policy only uses the ready structure it needs. */
+typedef struct RunQueue
+{
+    ProcessLinkedQueue fifo_queue;
+    ProcessHeap ready_heap;
+    ProcessLinkedQueue multilevel_queues[MLFQ_LEVEL_COUNT];
+    ProcessControlRecord *timeline_head[CFS_TIMELINE_LEVELS];
+    long long timeline_weight;
+    long long minimum_virtual_runtime;
+    int ready_count;
+    struct SimulationContext *simulation;
+} RunQueue;
+
+typedef struct SimulatedCpu
+{
+    ProcessControlRecord *running_process;
+    RunQueue run_queue;
+    long long busy_ticks;
+    int migrations_in;
+    int migrations_out;
+} SimulatedCpu;
+
+/* Optional hooks may be NULL. The engine skips idle ticks, so on_tick is charged in batches of ticks_run
+   and time_slice bounds how long a process may run before the policy is consulted again. */
+typedef struct SchedulingPolicy
+{
+    const char *policy_name;
+    bool (*ready_order)(const ProcessControlRecord *first_process, const ProcessControlRecord *second_process);
+    void (*on_arrive)(RunQueue *run_queue, ProcessControlRecord *process_record);
+    ProcessControlRecord *(*pick_next)(RunQueue *run_queue);
+    void (*remove_ready)(RunQueue *run_queue, ProcessControlRecord *process_record);
+    long long (*time_slice)(RunQueue *run_queue, const ProcessControlRecord *process_record);
+    void (*on_tick)(RunQueue *run_queue, ProcessControlRecord *process_record, long long ticks_run);
+    void (*on_preempt)(RunQueue *run_queue, ProcessControlRecord *process_record);
+    void (*on_block)(RunQueue *run_queue, ProcessControlRecord *process_record);
+    void (*on_migrate)(RunQueue *source_queue, RunQueue *target_queue, ProcessControlRecord *process_record);
+    bool (*should_preempt)(RunQueue *run_queue, const ProcessControlRecord *running_process);
+} SchedulingPolicy;
+
+typedef enum
+{
+    LOG_DISPATCH,
+    LOG_IO_START,
+    LOG_IO_END,
+    LOG_PREEMPT,
+    LOG_KILL,
+    LOG_FINISH,
+    LOG_KIND_COUNT
+} SchedulerLogKind;
+
+/* Fixed 16-byte records written in host byte order after the SCHEDULER_LOG_MAGIC header. */
+typedef struct SchedulerLogRecord
+{
+    int record_tick;
+    int record_pid;
+    int record_ready_depth;
+    short record_cpu;
+    unsigned char record_kind;
+    unsigned char record_padding;
+} SchedulerLogRecord;
+
+typedef struct SimulationSettings
+{
+    const SchedulingPolicy *selected_policy;
+    int time_quantum;
+    int simulated_cpu_count;
+    int io_duration_percent;
+} SimulationSettings;
+
+/* Everything one run mutates. The loaded trace (PID table, PCB pool, kill list) is shared read-only,
+   so a run either works on the pool directly or on its own copy of it. */
+typedef struct SimulationContext
+{
+    const SchedulingPolicy *selected_policy;
+    int time_quantum;
+    int simulated_cpu_count;
+    int io_duration_percent;
+    SimulatedCpu simulated_cpus[MAX_SIMULATED_CPUS];
+    ProcessControlRecord **process_chunks;
+    int owned_chunk_count;
+    ProcessLinkedQueue finished_queue;
+    ProcessHeap waiting_heap;
+    ProcessHeap arrival_heap;
+    SchedulerEventHeap event_heap;
+    long long current_tick;
+    int terminated_count;
+    int next_initial_cpu;
+    long long next_dispatch_sequence;
+    int next_kill_event_index;
+    int ready_process_count;
+    long long next_ready_sequence;
+    unsigned int timeline_random_state;
+    ProcessControlRecord ***timeline_link_chunks;
+    int timeline_link_chunk_count;
+    int timeline_link_chunk_capacity;
+    int timeline_links_used;
+    FILE *event_log;
+    SchedulerLogRecord *log_records;
+    int log_record_count;
+    long long scheduler_event_count;
+} SimulationContext;
+
+/* One comma-separated command-line list; policies are stored as indices into scheduling_policies. */
+typedef struct SweepAxis
+{
+    int axis_values[MAX_SWEEP_VALUES];
+    int value_count;
+} SweepAxis;
+
+typedef struct SweepRunResult
+{
+    SimulationSettings run_settings;
+    bool run_failed;
+    int completed_count;
+    int killed_count;
+    int unfinished_count;
+    long long makespan;
+    double average_turnaround;
+    double average_waiting;
+    long long busy_ticks;
+} SweepRunResult;
+
+typedef struct OnlineRunTotals
+{
+    int completed_count;
+    int killed_count;
+    long long last_completion_tick;
+    long long turnaround_total;
+} OnlineRunTotals;
+
+typedef struct SweepWorkQueue
+{
+    SweepRunResult *run_results;
+    int run_count;
+    const struct CheckpointImage *resume_image;
+    int next_run_index;
+    pthread_mutex_t queue_mutex;
+} SweepWorkQueue;
+
+typedef enum
+{
+    TRACE_PROCESS_SECTION,
+    TRACE_KILL_SECTION,
+    TRACE_FINISHED
+} TraceSection;
+
+typedef struct TraceToken
+{
+    const char *token_start;
+    int token_length;
+} TraceToken;
+
+typedef enum
+{
+    DISTRIBUTION_UNIFORM,
+    DISTRIBUTION_EXPONENTIAL,
+    DISTRIBUTION_PARETO
+} WorkloadDistribution;
+
+/* Durations are drawn around their mean; kills hit kill_percent of the processes, starting at kill_start_percent of
+   the expected single-CPU makespan and spread over kill_spread_percent of it (0 puts the whole storm on one tick).
+   A non-zero arrival_burst_size releases processes in groups of that size, arrival_burst_gap ticks apart. */
+typedef struct WorkloadProfile
+{
+    const char *workload_name;
+    WorkloadDistribution burst_distribution;
+    int mean_burst;
+    WorkloadDistribution io_distribution;
+    int io_percent;
+    int mean_io_duration;
+    int kill_percent;
+    int kill_start_percent;
+    int kill_spread_percent;
+    int arrival_burst_size;
+    int arrival_burst_gap;
+} WorkloadProfile;
 
 typedef struct ProcessSpecification
 {
@@ -71,98 +319,527 @@ typedef struct ProcessSpecification
     int spec_burst;
     int spec_io_start;
     int spec_io_duration;
+    int spec_priority;
+    int spec_arrival;
 } ProcessSpecification;
 
-static ProcessHashEntry *process_table[MAX_PROCESS_TABLE_BUCKETS];
-static ProcessLinkedQueue ready_queue;
-static ProcessLinkedQueue waiting_queue;
-static ProcessLinkedQueue finished_queue;
-static ProcessControlRecord *registered_processes[MAX_PROCESSES];
-static KillEventRecord kill_event_list[MAX_KILL_EVENTS];
+/* A checkpoint file is CHECKPOINT_MAGIC, this header, one CheckpointCpu per CPU, the pending CPU releases, one
+   CheckpointProcess per PCB, the structure lists, the sorted kill list and the process names, all in host byte order.
+   Pointers are never stored: every queue, heap and timeline is a counted list of registry indices in its saved order. */
+typedef struct CheckpointHeader
+{
+    int policy_index;
+    int time_quantum;
+    int simulated_cpu_count;
+    int io_duration_percent;
+    int registered_process_count;
+    int total_process_count;
+    int kill_event_count;
+    int next_kill_event_index;
+    int terminated_count;
+    int next_initial_cpu;
+    int ready_process_count;
+    int event_count;
+    long long current_tick;
+    long long next_dispatch_sequence;
+    long long next_ready_sequence;
+    long long scheduler_event_count;
+    unsigned int timeline_random_state;
+    int header_padding;
+} CheckpointHeader;
+
+typedef struct CheckpointCpu
+{
+    long long busy_ticks;
+    long long timeline_weight;
+    long long minimum_virtual_runtime;
+    int running_index;
+    int ready_count;
+    int migrations_in;
+    int migrations_out;
+} CheckpointCpu;
+
+typedef struct CheckpointEvent
+{
+    long long event_tick;
+    long long event_sequence;
+    int event_cpu;
+    int event_index;
+} CheckpointEvent;
+
+/* io_duration_ticks is left out because restore rescales it from configured_io_duration. */
+typedef struct CheckpointProcess
+{
+    long long io_completion_tick;
+    long long dispatch_sequence;
+    long long ready_sequence;
+    long long level_ticks_used;
+    long long virtual_runtime;
+    long long completion_tick;
+    long long killed_at_tick;
+    long long dispatched_at_tick;
+    long long io_entered_tick;
+    long long arrival_tick;
+    int process_id;
+    int total_cpu_burst;
+    int remaining_cpu_burst;
+    int io_start_tick;
+    int remaining_io_ticks;
+    int executed_cpu_time;
+    int configured_io_duration;
+    int dispatch_count;
+    int scheduling_priority;
+    int migration_count;
+    short cpu_index;
+    unsigned char execution_state;
+    unsigned char terminated_by_kill;
+    unsigned char queue_level;
+    unsigned char timeline_level;
+    unsigned char name_length;
+} CheckpointProcess;
+
+/* The whole file stays in memory; its PCBs and kill list go into the loaded trace, the rest is read by every restore. */
+typedef struct CheckpointImage
+{
+    char *image_buffer;
+    const CheckpointHeader *checkpoint_header;
+    const CheckpointCpu *checkpoint_cpus;
+    const CheckpointEvent *checkpoint_events;
+    const int *structure_lists;
+    const int *structure_lists_end;
+} CheckpointImage;
+
+static ProcessIndexSlot *process_table = NULL;
+static int process_table_capacity = 0;
+static int process_table_count = 0;
+static ProcessControlRecord **process_pool_chunks = NULL;
+static int process_pool_chunk_count = 0;
+static int process_pool_chunk_capacity = 0;
+static KillEventRecord *kill_event_list = NULL;
 static int registered_process_count = 0;
 static int kill_event_count = 0;
+static int kill_event_capacity = 0;
 static int total_process_count = 0;
+static ProcessControlRecord *free_process_records = NULL;
+static bool online_mode = false;
+static SweepAxis policy_axis;
+static SweepAxis quantum_axis;
+static SweepAxis cpu_axis;
+static SweepAxis io_percent_axis;
+static const char *sweep_csv_path = NULL;
+static int sweep_thread_count = 0;
+static const char *event_log_path = NULL;
+static const char *convert_log_path = NULL;
+static const char *convert_csv_path = NULL;
+static const char *convert_trace_path = NULL;
+static const WorkloadProfile *generate_workload = NULL;
+static int generate_process_count = 0;
+static int benchmark_process_count = 0;
+static unsigned long long workload_seed = 1;
+static const char *checkpoint_path = NULL;
+static int checkpoint_interval = 0;
+static const char *resume_path = NULL;
 
-int compute_bucket_index(int key);
-void process_table_insert(int key, ProcessControlRecord *process_record);
+int compute_slot_index(int key, int capacity);
+bool grow_process_table();
+bool claim_process_slot(int key, ProcessIndexSlot **claimed_slot);
 ProcessControlRecord *process_table_lookup(int key);
+void remove_process_slot(int key);
+void release_process_record(ProcessControlRecord *process_record);
+ProcessControlRecord *allocate_process_record();
+ProcessControlRecord *simulation_process_at(SimulationContext *simulation, int registry_index);
+ProcessControlRecord **allocate_timeline_links(SimulationContext *simulation, int timeline_level);
 void init_queue(ProcessLinkedQueue *queue);
 void enqueue(ProcessLinkedQueue *queue, ProcessControlRecord *process_record);
 ProcessControlRecord *dequeue(ProcessLinkedQueue *queue);
-ProcessControlRecord *remove_from_queue_by_pid(ProcessLinkedQueue *queue, int process_id);
+void unlink_from_queue(ProcessControlRecord *process_record);
 void queue_for_each(ProcessLinkedQueue *queue, void (*operation)(ProcessControlRecord *));
 ProcessControlRecord *create_process_record(const ProcessSpecification *process_spec);
-void trim_string(char *input_string);
-bool is_valid_process_name(const char name[MAX_PROCESS_NAME_LEN]);
 bool is_valid_integer_string(const char num_string[MAX_INT_STR_LEN]);
-bool is_dash_or_integer(const char value[MAX_INT_STR_LEN]);
-bool validate_raw_input(const RawProcessLine *raw_input);
-bool is_valid_kill_input(const char pid_str[MAX_INT_STR_LEN], const char time_string[MAX_INT_STR_LEN]);
-void parse_input_line(char *line);
-void decrement_io_for_process(ProcessControlRecord *process_record);
-void move_completed_io_to_ready();
-void mark_process_terminated(ProcessControlRecord *process_record, int current_time);
-static void kill_running_process(ProcessControlRecord **running_process_pointer, int current_time, int *terminated_counter_pointer);
-static void kill_queued_process(int target_pid, int current_time, int *terminated_counter_pointer);
-static void handle_kill_event(int current_time, int target_pid, ProcessControlRecord **running_process_pointer,int *terminated_counter_pointer);
-void apply_pending_kill_events(int current_time, ProcessControlRecord **running_process_pointer, int *terminated_counter_pointer);
-void execute_scheduler();
+bool append_kill_event(int pid_value, int time_value);
+const char *next_trace_token(const char *cursor, const char *line_end, int max_length, TraceToken *token);
+bool parse_trace_integer(const TraceToken *token, int *parsed_value);
+bool parse_optional_trace_integer(const TraceToken *token, int default_value, int *parsed_value);
+bool is_kill_verb(const TraceToken *token);
+void parse_kill_fields(const TraceToken *pid_token, const TraceToken *time_token);
+ProcessControlRecord *parse_process_line(const char *cursor, const char *line_end);
+TraceSection parse_trace_line(const char *line_start, const char *line_end, TraceSection section);
+void parse_trace_buffer(const char *trace_buffer, size_t buffer_size);
+size_t load_trace_stream();
+size_t load_trace_input();
+void report_load_throughput(size_t trace_bytes, const struct timespec *load_started, const struct timespec *load_finished);
+bool open_scheduler_log(SimulationContext *simulation, const char *log_path);
+void flush_scheduler_log(SimulationContext *simulation);
+void close_scheduler_log(SimulationContext *simulation);
+void append_scheduler_log_record(SimulationContext *simulation, SchedulerLogKind record_kind, long long boundary_tick,
+                                 const ProcessControlRecord *process_record, int cpu_index);
+static inline void log_scheduler_event(SimulationContext *simulation, SchedulerLogKind record_kind, long long boundary_tick,
+                                       const ProcessControlRecord *process_record, int cpu_index);
+void mark_process_terminated(SimulationContext *simulation, ProcessControlRecord *process_record, long long current_time);
+static void kill_running_process(SimulationContext *simulation, SimulatedCpu *cpu, long long current_time, int *terminated_counter_pointer);
+static void kill_queued_process(SimulationContext *simulation, ProcessControlRecord *process_record, long long current_time, int *terminated_counter_pointer);
+static void handle_kill_event(SimulationContext *simulation, long long current_time, int target_pid, int *terminated_counter_pointer);
+int compare_kill_event_by_time(const void *left_pointer, const void *right_pointer);
+void apply_pending_kill_events(SimulationContext *simulation, long long current_time, int *terminated_counter_pointer);
+bool event_precedes(const SchedulerEvent *first_event, const SchedulerEvent *second_event);
+bool push_scheduler_event(SchedulerEventHeap *event_heap, SchedulerEvent scheduler_event);
+SchedulerEvent pop_scheduler_event(SchedulerEventHeap *event_heap);
+void init_process_heap(ProcessHeap *process_heap, bool (*precedes)(const ProcessControlRecord *, const ProcessControlRecord *));
+void place_heap_process(ProcessHeap *process_heap, ProcessControlRecord *process_record, int heap_index);
+void sift_heap_process_up(ProcessHeap *process_heap, int heap_index);
+void sift_heap_process_down(ProcessHeap *process_heap, int heap_index);
+bool push_heap_process(ProcessHeap *process_heap, ProcessControlRecord *process_record);
+void remove_heap_process(ProcessHeap *process_heap, ProcessControlRecord *process_record);
+ProcessControlRecord *pop_heap_process(ProcessHeap *process_heap);
+void destroy_process_heap(ProcessHeap *process_heap);
+bool waiting_process_precedes(const ProcessControlRecord *first_process, const ProcessControlRecord *second_process);
+bool arrival_process_precedes(const ProcessControlRecord *first_process, const ProcessControlRecord *second_process);
+bool shorter_remaining_precedes(const ProcessControlRecord *first_process, const ProcessControlRecord *second_process);
+bool higher_priority_precedes(const ProcessControlRecord *first_process, const ProcessControlRecord *second_process);
+void init_run_queue(SimulationContext *simulation, RunQueue *run_queue);
+void fifo_on_arrive(RunQueue *run_queue, ProcessControlRecord *process_record);
+ProcessControlRecord *fifo_pick_next(RunQueue *run_queue);
+void fifo_remove_ready(RunQueue *run_queue, ProcessControlRecord *process_record);
+long long round_robin_time_slice(RunQueue *run_queue, const ProcessControlRecord *process_record);
+void heap_on_arrive(RunQueue *run_queue, ProcessControlRecord *process_record);
+ProcessControlRecord *heap_pick_next(RunQueue *run_queue);
+void heap_remove_ready(RunQueue *run_queue, ProcessControlRecord *process_record);
+bool shortest_remaining_should_preempt(RunQueue *run_queue, const ProcessControlRecord *running_process);
+bool priority_should_preempt(RunQueue *run_queue, const ProcessControlRecord *running_process);
+long long multilevel_quantum(int base_quantum, int queue_level);
+void multilevel_on_arrive(RunQueue *run_queue, ProcessControlRecord *process_record);
+ProcessControlRecord *multilevel_pick_next(RunQueue *run_queue);
+void multilevel_remove_ready(RunQueue *run_queue, ProcessControlRecord *process_record);
+long long multilevel_time_slice(RunQueue *run_queue, const ProcessControlRecord *process_record);
+void multilevel_on_tick(RunQueue *run_queue, ProcessControlRecord *process_record, long long ticks_run);
+void multilevel_on_preempt(RunQueue *run_queue, ProcessControlRecord *process_record);
+void multilevel_on_block(RunQueue *run_queue, ProcessControlRecord *process_record);
+bool multilevel_should_preempt(RunQueue *run_queue, const ProcessControlRecord *running_process);
+int fair_share_weight(const ProcessControlRecord *process_record);
+bool timeline_precedes(const ProcessControlRecord *first_process, const ProcessControlRecord *second_process);
+void find_timeline_links(RunQueue *run_queue, const ProcessControlRecord *process_record, ProcessControlRecord **links[CFS_TIMELINE_LEVELS]);
+int random_timeline_level(SimulationContext *simulation);
+void insert_into_timeline(RunQueue *run_queue, ProcessControlRecord *process_record);
+void remove_from_timeline(RunQueue *run_queue, ProcessControlRecord *process_record);
+void fair_share_on_arrive(RunQueue *run_queue, ProcessControlRecord *process_record);
+void fair_share_on_preempt(RunQueue *run_queue, ProcessControlRecord *process_record);
+ProcessControlRecord *fair_share_pick_next(RunQueue *run_queue);
+long long fair_share_time_slice(RunQueue *run_queue, const ProcessControlRecord *process_record);
+void fair_share_on_tick(RunQueue *run_queue, ProcessControlRecord *process_record, long long ticks_run);
+void fair_share_on_migrate(RunQueue *source_queue, RunQueue *target_queue, ProcessControlRecord *process_record);
+bool fair_share_should_preempt(RunQueue *run_queue, const ProcessControlRecord *running_process);
+const SchedulingPolicy *find_scheduling_policy(const char *policy_name);
+void make_process_ready(SimulationContext *simulation, ProcessControlRecord *process_record, bool was_preempted);
+ProcessControlRecord *steal_ready_process(SimulationContext *simulation, int thief_index);
+void dispatch_next_process(SimulationContext *simulation, SchedulerEventHeap *event_heap, int cpu_index, long long current_time);
+void schedule_cpu_release(SimulationContext *simulation, SchedulerEventHeap *event_heap, int cpu_index, long long current_time);
+void charge_running_process(SimulationContext *simulation, SimulatedCpu *cpu, long long end_tick);
+void release_running_process(SimulationContext *simulation, SimulatedCpu *cpu, long long end_tick, int *terminated_counter_pointer);
+int complete_due_io(SimulationContext *simulation, long long current_tick);
+int process_events_through(SimulationContext *simulation, SchedulerEventHeap *event_heap, long long last_event_tick, int *terminated_counter_pointer);
+void preempt_for_arrivals(SimulationContext *simulation, long long end_tick);
+bool any_cpu_idle(SimulationContext *simulation);
+void admit_process(SimulationContext *simulation, ProcessControlRecord *process_record);
+void submit_process(SimulationContext *simulation, ProcessControlRecord *process_record);
+int admit_due_arrivals(SimulationContext *simulation, long long current_tick);
+void start_scheduler(SimulationContext *simulation);
+void advance_scheduler(SimulationContext *simulation, long long horizon_tick);
+void execute_scheduler(SimulationContext *simulation);
+bool scheduler_has_pending_events(SimulationContext *simulation);
 int compare_process_by_pid(const void *left_pointer, const void *right_pointer);
 void destroy_process_table();
 void destroy_process_records();
-void print_result_table();
-void read_kill_events_after_process_input();
+void destroy_kill_events();
+void sort_kill_events();
+bool copy_process_pool(SimulationContext *simulation);
+SimulationContext *create_simulation_context(const SimulationSettings *run_settings, bool copy_processes);
+void destroy_simulation_context(SimulationContext *simulation);
+void scale_io_duration(SimulationContext *simulation, ProcessControlRecord *process_record);
+void drain_finished_processes(SimulationContext *simulation, OnlineRunTotals *run_totals);
+bool run_online_simulation(SimulationContext *simulation);
+void summarize_simulation(SimulationContext *simulation, SweepRunResult *run_result);
+void *run_sweep_worker(void *worker_argument);
+bool write_sweep_csv(const SweepRunResult *run_results, int run_count);
+bool run_parameter_sweep(const struct CheckpointImage *resume_image);
+void write_trace_event_separator(FILE *trace_file, bool *first_trace_event);
+void write_trace_events(FILE *trace_file, const SchedulerLogRecord *log_record, bool cpu_named[MAX_SIMULATED_CPUS], bool *first_trace_event);
+bool convert_scheduler_log(const char *log_path, const char *csv_path, const char *trace_path);
+unsigned long long next_workload_random(unsigned long long *random_state);
+double next_workload_unit(unsigned long long *random_state);
+int sample_workload_ticks(unsigned long long *random_state, WorkloadDistribution distribution, int mean_ticks);
+const WorkloadProfile *find_workload_profile(const char *workload_name);
+void write_workload_trace(FILE *trace_file, const WorkloadProfile *profile, int process_count, unsigned long long trace_seed);
+void reset_loaded_trace();
+bool run_workload_benchmark(const SimulationSettings *run_settings);
+void write_checkpoint_queue(FILE *checkpoint_file, const ProcessLinkedQueue *queue);
+void write_checkpoint_heap(FILE *checkpoint_file, const ProcessHeap *process_heap);
+void write_checkpoint_timeline(FILE *checkpoint_file, const RunQueue *run_queue);
+void pack_checkpoint_process(const ProcessControlRecord *process_record, CheckpointProcess *checkpoint_process);
+void unpack_checkpoint_process(const CheckpointProcess *checkpoint_process, const char *process_name, ProcessControlRecord *process_record);
+bool save_checkpoint(SimulationContext *simulation, const char *checkpoint_file_path);
+bool validate_checkpoint_lists(const int *list_cursor, const int *lists_end, int list_count, int process_count);
+bool validate_checkpoint_process(const CheckpointProcess *checkpoint_process, int simulated_cpu_count);
+CheckpointImage *load_checkpoint(const char *checkpoint_file_path);
+void destroy_checkpoint_image(CheckpointImage *checkpoint_image);
+void restore_checkpoint_queue(SimulationContext *simulation, ProcessLinkedQueue *queue, const int **list_cursor);
+bool restore_checkpoint_heap(SimulationContext *simulation, ProcessHeap *process_heap, const int **list_cursor);
+void restore_checkpoint_timeline(SimulationContext *simulation, RunQueue *run_queue, const int **list_cursor);
+bool restore_checkpoint(SimulationContext *simulation, const CheckpointImage *checkpoint_image);
+SimulationContext *resume_simulation_context(const SimulationSettings *run_settings, const CheckpointImage *checkpoint_image, bool copy_processes);
+void run_checkpointed_scheduler(SimulationContext *simulation);
+bool resume_from_checkpoint();
+bool parse_sweep_axis(const char *axis_text, SweepAxis *axis, bool policy_names, int minimum_value, int maximum_value);
+void set_single_axis_value(SweepAxis *axis, int axis_value);
+void set_default_axis_value(SweepAxis *axis, int axis_value);
+bool parse_command_line(int argc, char *argv[]);
+void print_result_table(SimulationContext *simulation);
+void print_cpu_summary(SimulationContext *simulation);
 void cleanup_all_memory();
 
-int compute_bucket_index(int key)
+/* Linux's sched_prio_to_weight table, indexed by nice + 20. */
+static const int nice_to_weight[40] =
+{
+    88761, 71755, 56483, 46273, 36291,
+    29154, 23254, 18705, 14949, 11916,
+    9548, 7620, 6100, 4904, 3906,
+    3121, 2501, 1991, 1586, 1277,
+    1024, 820, 655, 526, 423,
+    335, 272, 215, 172, 137,
+    110, 87, 70, 56, 45,
+    36, 29, 23, 18, 15
+};
+
+static const char *scheduler_log_kind_names[LOG_KIND_COUNT] = {"dispatch", "io_start", "io_end", "preempt", "kill", "finish"};
+
+static const SchedulingPolicy scheduling_policies[] =
+{
+    {"fcfs", NULL, fifo_on_arrive, fifo_pick_next, fifo_remove_ready, NULL, NULL, NULL, NULL, NULL, NULL},
+    {"sjf", shorter_remaining_precedes, heap_on_arrive, heap_pick_next, heap_remove_ready, NULL, NULL, NULL, NULL, NULL, NULL},
+    {"srtf", shorter_remaining_precedes, heap_on_arrive, heap_pick_next, heap_remove_ready, NULL, NULL, NULL, NULL, NULL,
+     shortest_remaining_should_preempt},
+    {"rr", NULL, fifo_on_arrive, fifo_pick_next, fifo_remove_ready, round_robin_time_slice, NULL, NULL, NULL, NULL, NULL},
+    {"priority", higher_priority_precedes, heap_on_arrive, heap_pick_next, heap_remove_ready, NULL, NULL, NULL, NULL, NULL,
+     priority_should_preempt},
+    {"mlfq", NULL, multilevel_on_arrive, multilevel_pick_next, multilevel_remove_ready, multilevel_time_slice,
+     multilevel_on_tick, multilevel_on_preempt, multilevel_on_block, NULL, multilevel_should_preempt},
+    {"cfs", NULL, fair_share_on_arrive, fair_share_pick_next, remove_from_timeline, fair_share_time_slice,
+     fair_share_on_tick, fair_share_on_preempt, NULL, fair_share_on_migrate, fair_share_should_preempt}
+};
+
+static const WorkloadProfile workload_profiles[] =
+{
+    {"uniform", DISTRIBUTION_UNIFORM, 20, DISTRIBUTION_UNIFORM, 50, 10, 0, 0, 0, 0, 0},
+    {"exponential", DISTRIBUTION_EXPONENTIAL, 20, DISTRIBUTION_UNIFORM, 30, 10, 0, 0, 0, 0, 0},
+    {"heavy-io", DISTRIBUTION_EXPONENTIAL, 10, DISTRIBUTION_PARETO, 80, 8, 0, 0, 0, 0, 0},
+    {"kill-storm", DISTRIBUTION_UNIFORM, 20, DISTRIBUTION_UNIFORM, 30, 10, 25, 25, 0, 0, 0},
+    {"arrival-burst", DISTRIBUTION_EXPONENTIAL, 20, DISTRIBUTION_UNIFORM, 30, 10, 0, 0, 0, 256, 4096},
+    {"mixed", DISTRIBUTION_EXPONENTIAL, 20, DISTRIBUTION_PARETO, 40, 8, 5, 0, 100, 0, 0}
+};
+
+int compute_slot_index(int key, int capacity)
 {
-    int computed_index = key % MAX_PROCESS_TABLE_BUCKETS;
-    return (computed_index < 0 ? computed_index + MAX_PROCESS_TABLE_BUCKETS : computed_index);
+    unsigned int mixed_key = (unsigned int)key;
+
+    mixed_key ^= mixed_key >> 16;
+    mixed_key *= 0x45d9f3bu;
+    mixed_key ^= mixed_key >> 16;
+    return (int)(mixed_key & (unsigned int)(capacity - 1));
 }
 
-void process_table_insert(int key, ProcessControlRecord *process_record)
+/* Open addressing with linear probing; the capacity stays a power of two and at most half full. */
+bool grow_process_table()
 {
-    int bucket_index = compute_bucket_index(key);
-    ProcessHashEntry *entry_pointer = process_table[bucket_index];
+    int new_capacity = process_table_capacity ? process_table_capacity * 2 : INITIAL_PROCESS_TABLE_CAPACITY;
+    ProcessIndexSlot *new_slots = (ProcessIndexSlot *)calloc(new_capacity, sizeof(ProcessIndexSlot));
+    if (new_slots == NULL) {
+        printf("Memory allocation failed!!!");
+        return false;
+    }
 
-    while (entry_pointer)
+    for (int index = 0; index < process_table_capacity; index++)
     {
-        if (entry_pointer->process_id_key == key)
+        if (process_table[index].process_record == NULL)
         {
-            return;
+            continue;
+        }
+        int slot_index = compute_slot_index(process_table[index].process_id_key, new_capacity);
+        while (new_slots[slot_index].process_record)
+        {
+            slot_index = (slot_index + 1) & (new_capacity - 1);
         }
-        entry_pointer = entry_pointer->next_entry;
+        new_slots[slot_index] = process_table[index];
     }
 
-    ProcessHashEntry *new_entry = (ProcessHashEntry *)malloc(sizeof(ProcessHashEntry));
-    if (new_entry == NULL) {
-        printf("Memory allocation failed!!!");
-        return;
+    free(process_table);
+    process_table = new_slots;
+    process_table_capacity = new_capacity;
+    return true;
+}
+
+/* One probe both rejects duplicates and reserves the slot; *claimed_slot is NULL when key is already present. */
+bool claim_process_slot(int key, ProcessIndexSlot **claimed_slot)
+{
+    *claimed_slot = NULL;
+    if ((process_table_count + 1) * 2 > process_table_capacity && !grow_process_table())
+    {
+        return false;
+    }
+
+    int slot_index = compute_slot_index(key, process_table_capacity);
+    while (process_table[slot_index].process_record)
+    {
+        if (process_table[slot_index].process_id_key == key)
+        {
+            return true;
+        }
+        slot_index = (slot_index + 1) & (process_table_capacity - 1);
     }
 
-    new_entry->process_id_key = key;
-    new_entry->process_record = process_record;
-    new_entry->next_entry = process_table[bucket_index];
-    process_table[bucket_index] = new_entry;
+    process_table[slot_index].process_id_key = key;
+    process_table_count++;
+    *claimed_slot = &process_table[slot_index];
+    return true;
 }
 
 ProcessControlRecord *process_table_lookup(int key)
 {
-    int bucket_index = compute_bucket_index(key);
-    ProcessHashEntry *entry_pointer = process_table[bucket_index];
+    if (process_table_capacity == 0)
+    {
+        return NULL;
+    }
 
-    while (entry_pointer)
+    int slot_index = compute_slot_index(key, process_table_capacity);
+    while (process_table[slot_index].process_record)
     {
-        if (entry_pointer->process_id_key == key)
+        if (process_table[slot_index].process_id_key == key)
         {
-            return entry_pointer->process_record;
+            return process_table[slot_index].process_record;
         }
-        entry_pointer = entry_pointer->next_entry;
+        slot_index = (slot_index + 1) & (process_table_capacity - 1);
     }
 
     return NULL;
 }
 
+/* Backward-shift delete: later members of the probe cluster move up so lookups never stop at a hole. */
+void remove_process_slot(int key)
+{
+    int slot_index = compute_slot_index(key, process_table_capacity);
+
+    while (process_table[slot_index].process_record && process_table[slot_index].process_id_key != key)
+    {
+        slot_index = (slot_index + 1) & (process_table_capacity - 1);
+    }
+    if (process_table[slot_index].process_record == NULL)
+    {
+        return;
+    }
+
+    int empty_index = slot_index;
+    int probe_index = slot_index;
+    while (true)
+    {
+        probe_index = (probe_index + 1) & (process_table_capacity - 1);
+        if (process_table[probe_index].process_record == NULL)
+        {
+            break;
+        }
+        int home_index = compute_slot_index(process_table[probe_index].process_id_key, process_table_capacity);
+        bool home_between = (empty_index <= probe_index) ? (home_index > empty_index && home_index <= probe_index)
+                                                         : (home_index > empty_index || home_index <= probe_index);
+        if (!home_between)
+        {
+            process_table[empty_index] = process_table[probe_index];
+            empty_index = probe_index;
+        }
+    }
+    process_table[empty_index].process_record = NULL;
+    process_table_count--;
+}
+
+void release_process_record(ProcessControlRecord *process_record)
+{
+    remove_process_slot(process_record->process_id);
+    process_record->next_process = free_process_records;
+    free_process_records = process_record;
+}
+
+/* PCBs live in fixed-size chunks so queue and heap pointers stay valid as the pool grows. Records released by
+   the online mode are reused first and keep their registry slot and CFS timeline links. */
+ProcessControlRecord *allocate_process_record()
+{
+    int chunk_offset = registered_process_count % PROCESS_POOL_CHUNK_SIZE;
+
+    if (free_process_records)
+    {
+        ProcessControlRecord *recycled_record = free_process_records;
+        free_process_records = recycled_record->next_process;
+        return recycled_record;
+    }
+
+    if (chunk_offset == 0)
+    {
+        if (process_pool_chunk_count == process_pool_chunk_capacity)
+        {
+            int new_capacity = process_pool_chunk_capacity ? process_pool_chunk_capacity * 2 : 16;
+            ProcessControlRecord **new_chunks = (ProcessControlRecord **)realloc(process_pool_chunks, new_capacity * sizeof(ProcessControlRecord *));
+            if (new_chunks == NULL) {
+                printf("Memory allocation failed!!!");
+                return NULL;
+            }
+            process_pool_chunks = new_chunks;
+            process_pool_chunk_capacity = new_capacity;
+        }
+        ProcessControlRecord *new_chunk = (ProcessControlRecord *)malloc(PROCESS_POOL_CHUNK_SIZE * sizeof(ProcessControlRecord));
+        if (new_chunk == NULL) {
+            printf("Memory allocation failed!!!");
+            return NULL;
+        }
+        process_pool_chunks[process_pool_chunk_count++] = new_chunk;
+    }
+
+    ProcessControlRecord *process_record = &process_pool_chunks[process_pool_chunk_count - 1][chunk_offset];
+    process_record->registry_index = registered_process_count++;
+    process_record->timeline_level = 0;
+    process_record->timeline_forward = NULL;
+    return process_record;
+}
+
+ProcessControlRecord *simulation_process_at(SimulationContext *simulation, int registry_index)
+{
+    return &simulation->process_chunks[registry_index / PROCESS_POOL_CHUNK_SIZE][registry_index % PROCESS_POOL_CHUNK_SIZE];
+}
+
+/* Skip-list forward links are carved from a bump arena; a process keeps its level for the whole run. */
+ProcessControlRecord **allocate_timeline_links(SimulationContext *simulation, int timeline_level)
+{
+    if (simulation->timeline_links_used + timeline_level > TIMELINE_LINK_CHUNK_SIZE)
+    {
+        if (simulation->timeline_link_chunk_count == simulation->timeline_link_chunk_capacity)
+        {
+            int new_capacity = simulation->timeline_link_chunk_capacity ? simulation->timeline_link_chunk_capacity * 2 : 16;
+            ProcessControlRecord ***new_chunks = (ProcessControlRecord ***)realloc(simulation->timeline_link_chunks, new_capacity * sizeof(ProcessControlRecord **));
+            if (new_chunks == NULL) {
+                printf("Memory allocation failed!!!");
+                return NULL;
+            }
+            simulation->timeline_link_chunks = new_chunks;
+            simulation->timeline_link_chunk_capacity = new_capacity;
+        }
+        ProcessControlRecord **new_chunk = (ProcessControlRecord **)malloc(TIMELINE_LINK_CHUNK_SIZE * sizeof(ProcessControlRecord *));
+        if (new_chunk == NULL) {
+            printf("Memory allocation failed!!!");
+            return NULL;
+        }
+        simulation->timeline_link_chunks[simulation->timeline_link_chunk_count++] = new_chunk;
+        simulation->timeline_links_used = 0;
+    }
+
+    ProcessControlRecord **timeline_links = &simulation->timeline_link_chunks[simulation->timeline_link_chunk_count - 1][simulation->timeline_links_used];
+    simulation->timeline_links_used += timeline_level;
+    return timeline_links;
+}
+
 void init_queue(ProcessLinkedQueue *queue)
 {
     queue->front_process = queue->rear_process = NULL;
@@ -171,6 +848,8 @@ void init_queue(ProcessLinkedQueue *queue)
 void enqueue(ProcessLinkedQueue *queue, ProcessControlRecord *process_record)
 {
     process_record->next_process = NULL;
+    process_record->previous_process = queue->rear_process;
+    process_record->owning_queue = queue;
 
     if (queue->rear_process)
     {
@@ -191,48 +870,35 @@ ProcessControlRecord *dequeue(ProcessLinkedQueue *queue)
     }
 
     ProcessControlRecord *process_record = queue->front_process;
-    queue->front_process = process_record->next_process;
-
-    if (!queue->front_process)
-    {
-        queue->rear_process = NULL;
-    }
-
+    unlink_from_queue(process_record);
     return process_record;
 }
 
-ProcessControlRecord *remove_from_queue_by_pid(ProcessLinkedQueue *queue, int process_id)
+void unlink_from_queue(ProcessControlRecord *process_record)
 {
-    ProcessControlRecord *current_process = queue->front_process;
-    ProcessControlRecord *previous_process = NULL;
+    ProcessLinkedQueue *queue = process_record->owning_queue;
 
-    while (current_process)
+    if (process_record->previous_process)
     {
-        if (current_process->process_id == process_id)
-        {
-            if (previous_process)
-            {
-                previous_process->next_process = current_process->next_process;
-            }
-            else
-            {
-                queue->front_process = current_process->next_process;
-            }
-
-            if (current_process == queue->rear_process)
-            {
-                queue->rear_process = previous_process;
-            }
-
-            current_process->next_process = NULL;
-            return current_process;
-        }
+        process_record->previous_process->next_process = process_record->next_process;
+    }
+    else
+    {
+        queue->front_process = process_record->next_process;
+    }
 
-        previous_process = current_process;
-        current_process = current_process->next_process;
+    if (process_record->next_process)
+    {
+        process_record->next_process->previous_process = process_record->previous_process;
+    }
+    else
+    {
+        queue->rear_process = process_record->previous_process;
     }
 
-    return NULL;
+    process_record->next_process = NULL;
+    process_record->previous_process = NULL;
+    process_record->owning_queue = NULL;
 }
 
 void queue_for_each(ProcessLinkedQueue *queue, void (*operation)(ProcessControlRecord *))
@@ -249,9 +915,8 @@ void queue_for_each(ProcessLinkedQueue *queue, void (*operation)(ProcessControlR
 
 ProcessControlRecord *create_process_record(const ProcessSpecification *process_spec)
 {
-    ProcessControlRecord *process_record = (ProcessControlRecord *)malloc(sizeof(ProcessControlRecord));
+    ProcessControlRecord *process_record = allocate_process_record();
     if (process_record == NULL) {
-        printf("Memory allocation failed!!!");
         return NULL;
     }
 
@@ -267,52 +932,27 @@ ProcessControlRecord *create_process_record(const ProcessSpecification *process_
     process_record->completion_tick = -1;
     process_record->terminated_by_kill = 0;
     process_record->killed_at_tick = -1;
-    process_record->execution_state = STATE_READY;
+    process_record->dispatched_at_tick = -1;
+    process_record->io_entered_tick = -1;
+    process_record->io_completion_tick = -1;
+    process_record->heap_index = -1;
+    process_record->dispatch_count = 0;
+    process_record->dispatch_sequence = 0;
+    process_record->arrival_tick = process_spec->spec_arrival;
+    process_record->ready_sequence = 0;
+    process_record->scheduling_priority = process_spec->spec_priority;
+    process_record->queue_level = 0;
+    process_record->level_ticks_used = 0;
+    process_record->virtual_runtime = 0;
+    process_record->cpu_index = 0;
+    process_record->migration_count = 0;
+    process_record->execution_state = STATE_NEW;
     process_record->next_process = NULL;
+    process_record->previous_process = NULL;
+    process_record->owning_queue = NULL;
     return process_record;
 }
 
-void trim_string(char *input_string)
-{
-    int start_index = 0;
-    int write_index = 0;
-
-    while (isspace((unsigned char)input_string[start_index]))
-    {
-        start_index++;
-    }
-
-    while (input_string[start_index])
-    {
-        input_string[write_index++] = input_string[start_index++];
-    }
-
-    input_string[write_index] = '\0';
-
-    while (write_index > 0 && isspace((unsigned char)input_string[write_index - 1]))
-    {
-        input_string[--write_index] = '\0';
-    }
-}
-
-bool is_valid_process_name(const char name[MAX_PROCESS_NAME_LEN])
-{
-    int name_index = 0;
-
-    while (name[name_index] == ' ')
-    {
-        name_index++;
-    }
-
-    if (name[name_index] == '\0')
-    {
-        printf("Process name can't be empty.\n");
-        return false;
-    }
-
-    return true;
-}
-
 bool is_valid_integer_string(const char number_string[MAX_INT_STR_LEN])
 {
     int char_index = 0;
@@ -334,515 +974,3149 @@ bool is_valid_integer_string(const char number_string[MAX_INT_STR_LEN])
     return true;
 }
 
-bool is_dash_or_integer(const char value[MAX_INT_STR_LEN])
+bool append_kill_event(int pid_value, int time_value)
 {
-    if (strcmp(value, "-") == 0)
+    if (kill_event_count == kill_event_capacity)
     {
-        return true;
+        int new_capacity = kill_event_capacity ? kill_event_capacity * 2 : INITIAL_KILL_EVENT_CAPACITY;
+        KillEventRecord *new_list = (KillEventRecord *)realloc(kill_event_list, new_capacity * sizeof(KillEventRecord));
+        if (new_list == NULL) {
+            printf("Memory allocation failed!!!");
+            return false;
+        }
+        kill_event_list = new_list;
+        kill_event_capacity = new_capacity;
     }
-    return is_valid_integer_string(value);
+
+    kill_event_list[kill_event_count].kill_pid = pid_value;
+    kill_event_list[kill_event_count].kill_time = time_value;
+    kill_event_list[kill_event_count].kill_sequence = kill_event_count;
+    kill_event_count++;
+    return true;
 }
 
-bool validate_raw_input(const RawProcessLine *raw_input)
+/* Tokens stop at whitespace or after max_length characters, like a bounded %s conversion. */
+const char *next_trace_token(const char *cursor, const char *line_end, int max_length, TraceToken *token)
 {
-    if (!is_valid_process_name(raw_input->raw_name))
+    while (cursor < line_end && isspace((unsigned char)*cursor))
     {
-        return false;
+        cursor++;
     }
 
-    if (!is_valid_integer_string(raw_input->raw_pid_str))
+    token->token_start = cursor;
+    while (cursor < line_end && !isspace((unsigned char)*cursor) && cursor - token->token_start < max_length)
     {
-        printf("Invalid input. Process ID must be an integer.\n");
-        return false;
+        cursor++;
     }
+    token->token_length = (int)(cursor - token->token_start);
+    return cursor;
+}
+
+bool parse_trace_integer(const TraceToken *token, int *parsed_value)
+{
+    long long accumulated_value = 0;
 
-    if (!is_valid_integer_string(raw_input->raw_burst_str))
+    if (token->token_length == 0 || token->token_length >= MAX_INT_STR_LEN)
     {
-        printf("Invalid input. Burst must be an integer.\n");
         return false;
     }
 
-    if (!is_dash_or_integer(raw_input->raw_io_start_str))
+    for (int char_index = 0; char_index < token->token_length; char_index++)
     {
-        printf("Invalid input. I/O start must be integer or '-'.\n");
-        return false;
+        char digit = token->token_start[char_index];
+        if (digit < '0' || digit > '9')
+        {
+            return false;
+        }
+        accumulated_value = accumulated_value * 10 + (digit - '0');
     }
 
-    if (!is_dash_or_integer(raw_input->raw_io_duration_str))
+    if (accumulated_value > INT_MAX)
     {
-        printf("Invalid input. I/O duration must be integer or '-'.\n");
         return false;
     }
 
-    int pid_value = atoi(raw_input->raw_pid_str);
+    *parsed_value = (int)accumulated_value;
+    return true;
+}
 
-    if (process_table_lookup(pid_value))
+bool parse_optional_trace_integer(const TraceToken *token, int default_value, int *parsed_value)
+{
+    if (token->token_length == 0 || (token->token_length == 1 && token->token_start[0] == '-'))
     {
-        printf("Duplicate PID %d detected.\n", pid_value);
-        return false;
+        *parsed_value = default_value;
+        return true;
     }
+    return parse_trace_integer(token, parsed_value);
+}
 
-    return true;
+bool is_kill_verb(const TraceToken *token)
+{
+    return token->token_length == 4 && strncasecmp(token->token_start, "KILL", 4) == 0;
 }
 
-bool is_valid_kill_input(const char pid_str[MAX_INT_STR_LEN], const char time_string[MAX_INT_STR_LEN])
+void parse_kill_fields(const TraceToken *pid_token, const TraceToken *time_token)
 {
-    if (!is_valid_integer_string(pid_str))
+    int pid_value;
+    int time_value;
+
+    if (!parse_trace_integer(pid_token, &pid_value))
     {
         printf("Invalid input. Kill PID must be an integer.\n");
-        return false;
+        return;
     }
 
-    if (!is_valid_integer_string(time_string))
+    if (!parse_trace_integer(time_token, &time_value))
     {
         printf("Invalid input. Kill time must be an integer.\n");
-        return false;
+        return;
     }
 
-    return true;
+    append_kill_event(pid_value, time_value);
 }
 
-void parse_input_line(char *line)
+ProcessControlRecord *parse_process_line(const char *cursor, const char *line_end)
 {
-    char first_word[16];
-    sscanf(line, "%s", first_word);
+    static const int field_limits[PROCESS_LINE_FIELDS] = {MAX_PROCESS_NAME_LEN - 1, MAX_INT_STR_LEN - 1, MAX_INT_STR_LEN - 1,
+                                                          MAX_INT_STR_LEN - 1, MAX_INT_STR_LEN - 1, MAX_INT_STR_LEN - 1,
+                                                          MAX_INT_STR_LEN - 1};
+    TraceToken fields[PROCESS_LINE_FIELDS];
+    int parsed_fields = 0;
 
-    if (strcasecmp(first_word, "KILL") == 0)
+    for (int field_index = 0; field_index < PROCESS_LINE_FIELDS; field_index++)
     {
-        char kill_pid_str[MAX_INT_STR_LEN];
-        char kill_time_str[MAX_INT_STR_LEN];
-        sscanf(line + strlen(first_word), "%s %s", kill_pid_str, kill_time_str);
-
-        if (!is_valid_kill_input(kill_pid_str, kill_time_str))
+        cursor = next_trace_token(cursor, line_end, field_limits[field_index], &fields[field_index]);
+        if (fields[field_index].token_length > 0 && parsed_fields == field_index)
         {
-            return;
+            parsed_fields++;
         }
-
-        int pid_value = atoi(kill_pid_str);
-        int time_value = atoi(kill_time_str);
-        kill_event_list[kill_event_count].kill_pid = pid_value;
-        kill_event_list[kill_event_count].kill_time = time_value;
-        kill_event_count++;
-        return;
     }
 
-    RawProcessLine raw_input;
-    memset(&raw_input, 0, sizeof(raw_input));
-
-    char io_start_buffer[MAX_INT_STR_LEN];
-    char io_duration_buffer[MAX_INT_STR_LEN];
-    char pid_buffer[MAX_INT_STR_LEN];
-    char burst_buffer[MAX_INT_STR_LEN];
-    char name_buffer[MAX_PROCESS_NAME_LEN];
+    if (parsed_fields < 3)
+    {
+        return NULL;
+    }
 
-    int parsed_items = sscanf(line, "%63s %15s %15s %15s %15s", name_buffer, pid_buffer, burst_buffer, io_start_buffer, io_duration_buffer);
+    ProcessSpecification process_specification;
+    memset(&process_specification, 0, sizeof(process_specification));
+    memcpy(process_specification.spec_name, fields[0].token_start, fields[0].token_length);
 
-    if (parsed_items < 3)
+    if (!parse_trace_integer(&fields[1], &process_specification.spec_pid))
     {
-        return;
+        printf("Invalid input. Process ID must be an integer.\n");
+        return NULL;
     }
 
-    strncpy(raw_input.raw_name, name_buffer, MAX_PROCESS_NAME_LEN - 1);
-    strncpy(raw_input.raw_pid_str, pid_buffer, MAX_INT_STR_LEN - 1);
-    strncpy(raw_input.raw_burst_str, burst_buffer, MAX_INT_STR_LEN - 1);
+    if (!parse_trace_integer(&fields[2], &process_specification.spec_burst))
+    {
+        printf("Invalid input. Burst must be an integer.\n");
+        return NULL;
+    }
 
-    if (parsed_items >= 4)
+    if (!parse_optional_trace_integer(&fields[3], -1, &process_specification.spec_io_start))
     {
-        strncpy(raw_input.raw_io_start_str, io_start_buffer, MAX_INT_STR_LEN - 1);
+        printf("Invalid input. I/O start must be integer or '-'.\n");
+        return NULL;
     }
-    else
+
+    if (!parse_optional_trace_integer(&fields[4], 0, &process_specification.spec_io_duration))
     {
-        strncpy(raw_input.raw_io_start_str, "-", MAX_INT_STR_LEN - 1);
+        printf("Invalid input. I/O duration must be integer or '-'.\n");
+        return NULL;
     }
 
-    if (parsed_items >= 5)
+    /* The original format ignored anything after the I/O duration, so the optional columns stop at the first token that is
+       neither an integer nor '-' and the rest of the line is treated as a comment. */
+    if (!parse_optional_trace_integer(&fields[5], DEFAULT_PROCESS_PRIORITY, &process_specification.spec_priority))
     {
-        strncpy(raw_input.raw_io_duration_str, io_duration_buffer, MAX_INT_STR_LEN - 1);
+        process_specification.spec_priority = DEFAULT_PROCESS_PRIORITY;
+        process_specification.spec_arrival = 0;
     }
-    else
+    else if (!parse_optional_trace_integer(&fields[6], 0, &process_specification.spec_arrival))
     {
-        strncpy(raw_input.raw_io_duration_str, "-", MAX_INT_STR_LEN - 1);
+        process_specification.spec_arrival = 0;
     }
 
-    if (!validate_raw_input(&raw_input))
+    ProcessIndexSlot *process_slot;
+    if (!claim_process_slot(process_specification.spec_pid, &process_slot))
     {
-        return;
+        return NULL;
+    }
+    if (process_slot == NULL)
+    {
+        printf("Duplicate PID %d detected.\n", process_specification.spec_pid);
+        return NULL;
     }
-
-    ProcessSpecification process_specification;
-    memset(&process_specification, 0, sizeof(process_specification));
-    strncpy(process_specification.spec_name, raw_input.raw_name, MAX_PROCESS_NAME_LEN - 1);
-
-    process_specification.spec_pid = atoi(raw_input.raw_pid_str);
-    process_specification.spec_burst = atoi(raw_input.raw_burst_str);
-    process_specification.spec_io_start = (strcmp(raw_input.raw_io_start_str, "-") != 0) ? atoi(raw_input.raw_io_start_str) : -1;
-    process_specification.spec_io_duration = (strcmp(raw_input.raw_io_duration_str, "-") != 0) ? atoi(raw_input.raw_io_duration_str) : 0;
 
     ProcessControlRecord *new_process_record = create_process_record(&process_specification);
     if (new_process_record == NULL) {
-        return;
+        return NULL;
     }
 
-    registered_processes[registered_process_count++] = new_process_record;
     total_process_count++;
-    process_table_insert(process_specification.spec_pid, new_process_record);
-    enqueue(&ready_queue, new_process_record);
+    process_slot->process_record = new_process_record;
+    return new_process_record;
 }
 
-void decrement_io_for_process(ProcessControlRecord *process_record)
+/* A blank line ends the process section; a second one ends the kill section. */
+TraceSection parse_trace_line(const char *line_start, const char *line_end, TraceSection section)
 {
-    if (process_record->remaining_io_ticks > 0)
+    int token_limit = (section == TRACE_KILL_SECTION) ? MAX_INT_STR_LEN - 1 : INT_MAX;
+    TraceToken verb_token;
+    TraceToken pid_token;
+    TraceToken time_token;
+    const char *cursor = next_trace_token(line_start, line_end, token_limit, &verb_token);
+
+    if (verb_token.token_length == 0)
+    {
+        return (section == TRACE_PROCESS_SECTION) ? TRACE_KILL_SECTION : TRACE_FINISHED;
+    }
+
+    if (section == TRACE_PROCESS_SECTION && !is_kill_verb(&verb_token))
+    {
+        parse_process_line(line_start, line_end);
+        return section;
+    }
+
+    cursor = next_trace_token(cursor, line_end, token_limit, &pid_token);
+    next_trace_token(cursor, line_end, token_limit, &time_token);
+
+    if (section == TRACE_KILL_SECTION &&
+        (time_token.token_length == 0 || !is_kill_verb(&verb_token)))
     {
-        process_record->remaining_io_ticks--;
+        return section;
     }
+
+    parse_kill_fields(&pid_token, &time_token);
+    return section;
 }
 
-void move_completed_io_to_ready()
+void parse_trace_buffer(const char *trace_buffer, size_t buffer_size)
 {
-    ProcessControlRecord *previous_process = NULL;
-    ProcessControlRecord *current_process = waiting_queue.front_process;
+    const char *cursor = trace_buffer;
+    const char *buffer_end = trace_buffer + buffer_size;
+    TraceSection section = TRACE_PROCESS_SECTION;
 
-    while (current_process)
+    while (cursor < buffer_end && section != TRACE_FINISHED)
     {
-        ProcessControlRecord *next_process = current_process->next_process;
-
-        if (current_process->remaining_io_ticks == 0)
+        const char *line_end = (const char *)memchr(cursor, '\n', buffer_end - cursor);
+        if (line_end == NULL)
         {
-            if (previous_process)
-            {
-                previous_process->next_process = current_process->next_process;
-            }
-            else
-            {
-                waiting_queue.front_process = current_process->next_process;
-            }
+            line_end = buffer_end;
+        }
+        section = parse_trace_line(cursor, line_end, section);
+        cursor = (line_end < buffer_end) ? line_end + 1 : buffer_end;
+    }
+}
 
-            if (current_process == waiting_queue.rear_process)
-            {
-                waiting_queue.rear_process = previous_process;
-            }
+size_t load_trace_stream()
+{
+    char *input_line = NULL;
+    size_t line_capacity = 0;
+    size_t bytes_read = 0;
+    ssize_t line_length;
+    TraceSection section = TRACE_PROCESS_SECTION;
 
-            current_process->execution_state = STATE_READY;
-            enqueue(&ready_queue, current_process);
-        }
-        else
+    while (section != TRACE_FINISHED && (line_length = getline(&input_line, &line_capacity, stdin)) != -1)
+    {
+        bytes_read += (size_t)line_length;
+        section = parse_trace_line(input_line, input_line + line_length, section);
+    }
+
+    free(input_line);
+    return bytes_read;
+}
+
+/* Regular files are mapped and parsed in place; pipes and terminals fall back to line reads. */
+size_t load_trace_input()
+{
+    struct stat input_status;
+
+    if (fstat(STDIN_FILENO, &input_status) == 0 && S_ISREG(input_status.st_mode) && input_status.st_size > 0)
+    {
+        size_t mapped_size = (size_t)input_status.st_size;
+        char *mapped_input = (char *)mmap(NULL, mapped_size, PROT_READ, MAP_PRIVATE, STDIN_FILENO, 0);
+        if (mapped_input != MAP_FAILED)
         {
-            previous_process = current_process;
+            madvise(mapped_input, mapped_size, MADV_SEQUENTIAL);
+            parse_trace_buffer(mapped_input, mapped_size);
+            munmap(mapped_input, mapped_size);
+            return mapped_size;
         }
+    }
 
-        current_process = next_process;
+    return load_trace_stream();
+}
+
+void report_load_throughput(size_t trace_bytes, const struct timespec *load_started, const struct timespec *load_finished)
+{
+    double elapsed_seconds = (double)(load_finished->tv_sec - load_started->tv_sec) +
+                             (double)(load_finished->tv_nsec - load_started->tv_nsec) / 1e9;
+    double trace_megabytes = (double)trace_bytes / (1024.0 * 1024.0);
+
+    fprintf(stderr, "Loaded %d processes and %d kill events (%.2f MB) in %.3f s, %.2f MB/s\n",
+            total_process_count, kill_event_count, trace_megabytes, elapsed_seconds,
+            elapsed_seconds > 0 ? trace_megabytes / elapsed_seconds : 0.0);
+}
+
+bool open_scheduler_log(SimulationContext *simulation, const char *log_path)
+{
+    simulation->event_log = fopen(log_path, "wb");
+    if (simulation->event_log == NULL)
+    {
+        printf("Could not open '%s' for writing.\n", log_path);
+        return false;
+    }
+
+    simulation->log_records = (SchedulerLogRecord *)malloc(SCHEDULER_LOG_BUFFER_RECORDS * sizeof(SchedulerLogRecord));
+    if (simulation->log_records == NULL) {
+        printf("Memory allocation failed!!!");
+        fclose(simulation->event_log);
+        simulation->event_log = NULL;
+        return false;
+    }
+    simulation->log_record_count = 0;
+    fwrite(SCHEDULER_LOG_MAGIC, 1, SCHEDULER_LOG_MAGIC_LEN, simulation->event_log);
+    return true;
+}
+
+void flush_scheduler_log(SimulationContext *simulation)
+{
+    if (fwrite(simulation->log_records, sizeof(SchedulerLogRecord), simulation->log_record_count, simulation->event_log) !=
+        (size_t)simulation->log_record_count)
+    {
+        printf("Could not write the event log; logging stopped.\n");
+        fclose(simulation->event_log);
+        simulation->event_log = NULL;
+    }
+    simulation->log_record_count = 0;
+}
+
+void close_scheduler_log(SimulationContext *simulation)
+{
+    if (simulation->event_log)
+    {
+        flush_scheduler_log(simulation);
+    }
+    if (simulation->event_log)
+    {
+        fclose(simulation->event_log);
+        simulation->event_log = NULL;
+    }
+    free(simulation->log_records);
+    simulation->log_records = NULL;
+}
+
+void append_scheduler_log_record(SimulationContext *simulation, SchedulerLogKind record_kind, long long boundary_tick,
+                                 const ProcessControlRecord *process_record, int cpu_index)
+{
+    SchedulerLogRecord *log_record = &simulation->log_records[simulation->log_record_count++];
+
+    log_record->record_tick = (int)boundary_tick;
+    log_record->record_pid = process_record->process_id;
+    log_record->record_ready_depth = simulation->ready_process_count;
+    log_record->record_cpu = (short)cpu_index;
+    log_record->record_kind = (unsigned char)record_kind;
+    log_record->record_padding = 0;
+    if (simulation->log_record_count == SCHEDULER_LOG_BUFFER_RECORDS)
+    {
+        flush_scheduler_log(simulation);
+    }
+}
+
+/* boundary_tick is the tick the event happens in front of; cpu_index is -1 for processes that are not running.
+   With logging off this is a counter bump and a single branch per event. */
+static inline void log_scheduler_event(SimulationContext *simulation, SchedulerLogKind record_kind, long long boundary_tick,
+                                       const ProcessControlRecord *process_record, int cpu_index)
+{
+    simulation->scheduler_event_count++;
+    if (simulation->event_log)
+    {
+        append_scheduler_log_record(simulation, record_kind, boundary_tick, process_record, cpu_index);
     }
 }
 
-void mark_process_terminated(ProcessControlRecord *process_record, int current_time)
+void mark_process_terminated(SimulationContext *simulation, ProcessControlRecord *process_record, long long current_time)
 {
     process_record->execution_state = STATE_TERMINATED;
     process_record->completion_tick = current_time;
-    enqueue(&finished_queue, process_record);
+    enqueue(&simulation->finished_queue, process_record);
 }
 
-static void kill_running_process(ProcessControlRecord **running_process_pointer, int current_time, int *terminated_counter_pointer)
+static void kill_running_process(SimulationContext *simulation, SimulatedCpu *cpu, long long current_time, int *terminated_counter_pointer)
 {
-    ProcessControlRecord *process_to_kill = *running_process_pointer;
+    ProcessControlRecord *process_to_kill = cpu->running_process;
 
-    *running_process_pointer = NULL;
+    int ticks_run = (int)(current_time - process_to_kill->dispatched_at_tick);
+
+    cpu->running_process = NULL;
+    cpu->busy_ticks += ticks_run;
+    process_to_kill->executed_cpu_time += ticks_run;
+    process_to_kill->remaining_cpu_burst -= ticks_run;
     process_to_kill->terminated_by_kill = 1;
     process_to_kill->killed_at_tick = current_time;
 
-    mark_process_terminated(process_to_kill, current_time);
+    mark_process_terminated(simulation, process_to_kill, current_time);
+    log_scheduler_event(simulation, LOG_KILL, current_time, process_to_kill, (int)(cpu - simulation->simulated_cpus));
     (*terminated_counter_pointer)++;
 }
 
-static void kill_queued_process(int target_pid, int current_time, int *terminated_counter_pointer)
+static void kill_queued_process(SimulationContext *simulation, ProcessControlRecord *process_record, long long current_time, int *terminated_counter_pointer)
 {
-    ProcessControlRecord *process_record = remove_from_queue_by_pid(&ready_queue, target_pid);
-
-    if (!process_record)
+    if (process_record->execution_state == STATE_READY)
     {
-        process_record = remove_from_queue_by_pid(&waiting_queue, target_pid);
+        RunQueue *run_queue = &simulation->simulated_cpus[process_record->cpu_index].run_queue;
+        simulation->selected_policy->remove_ready(run_queue, process_record);
+        run_queue->ready_count--;
+        simulation->ready_process_count--;
     }
-
-    if (!process_record)
+    else if (process_record->execution_state == STATE_NEW)
     {
-        return;
+        remove_heap_process(&simulation->arrival_heap, process_record);
+    }
+    else
+    {
+        remove_heap_process(&simulation->waiting_heap, process_record);
     }
 
     process_record->terminated_by_kill = 1;
     process_record->killed_at_tick = current_time;
 
-    mark_process_terminated(process_record, current_time);
+    mark_process_terminated(simulation, process_record, current_time);
+    log_scheduler_event(simulation, LOG_KILL, current_time, process_record, -1);
     (*terminated_counter_pointer)++;
 }
 
-static void handle_kill_event(int current_time, int target_pid, ProcessControlRecord **running_process_pointer, int *terminated_counter_pointer)
+static void handle_kill_event(SimulationContext *simulation, long long current_time, int target_pid, int *terminated_counter_pointer)
 {
-    ProcessControlRecord *target_process = process_table_lookup(target_pid);
+    ProcessControlRecord *loaded_process = process_table_lookup(target_pid);
+
+    if (!loaded_process)
+    {
+        return;
+    }
 
-    if (!target_process || target_process->execution_state == STATE_TERMINATED)
+    ProcessControlRecord *target_process = simulation_process_at(simulation, loaded_process->registry_index);
+    if (target_process->execution_state == STATE_TERMINATED)
     {
         return;
     }
 
-    if ((*running_process_pointer) && ((*running_process_pointer)->process_id == target_pid))
+    if (target_process->execution_state == STATE_RUNNING)
     {
-        kill_running_process(running_process_pointer, current_time, terminated_counter_pointer);
+        kill_running_process(simulation, &simulation->simulated_cpus[target_process->cpu_index], current_time, terminated_counter_pointer);
     }
     else
     {
-        kill_queued_process(target_pid, current_time, terminated_counter_pointer);
+        kill_queued_process(simulation, target_process, current_time, terminated_counter_pointer);
     }
 }
 
-void apply_pending_kill_events(int current_time, ProcessControlRecord **running_process_pointer, int *terminated_counter_pointer)
+int compare_kill_event_by_time(const void *left_pointer, const void *right_pointer)
 {
-    for (int event_index = 0; event_index < kill_event_count; event_index++)
+    const KillEventRecord *first_event = (const KillEventRecord *)left_pointer;
+    const KillEventRecord *second_event = (const KillEventRecord *)right_pointer;
+    if (first_event->kill_time != second_event->kill_time)
     {
-        if (kill_event_list[event_index].kill_time != current_time)
-        {
-            continue;
-        }
-
-        handle_kill_event(current_time, kill_event_list[event_index].kill_pid, running_process_pointer, terminated_counter_pointer);
+        return (first_event->kill_time < second_event->kill_time) ? -1 : 1;
     }
+    return first_event->kill_sequence - second_event->kill_sequence;
 }
 
-void execute_scheduler()
+/* kill_event_list is sorted by time (input order within a tick) once after loading; each run's cursor never moves back. */
+void apply_pending_kill_events(SimulationContext *simulation, long long current_time, int *terminated_counter_pointer)
 {
-    int time_tick = 0;
-    int terminated_counter = 0;
-    ProcessControlRecord *running_process = NULL;
-
-    while (terminated_counter < total_process_count)
+    while (simulation->next_kill_event_index < kill_event_count && kill_event_list[simulation->next_kill_event_index].kill_time <= current_time)
     {
-        apply_pending_kill_events(time_tick, &running_process, &terminated_counter);
-
-        if (!running_process)
-        {
-            running_process = dequeue(&ready_queue);
-
-            if (running_process)
-            {
-                running_process->execution_state = STATE_RUNNING;
-            }
-        }
-
-        if (running_process)
-        {
-            running_process->executed_cpu_time++;
-            running_process->remaining_cpu_burst--;
-        }
-
-        queue_for_each(&waiting_queue, decrement_io_for_process);
-
-        if (running_process)
-        {
-            if ((running_process->remaining_cpu_burst > 0) && 
-                (running_process->io_start_tick >= 0) && 
-                (running_process->executed_cpu_time == running_process->io_start_tick) && 
-                (running_process->io_duration_ticks > 0))
-            {
-                running_process->remaining_io_ticks = running_process->io_duration_ticks;
-                running_process->execution_state = STATE_WAITING;
-                enqueue(&waiting_queue, running_process);
-                running_process = NULL;
-            }
-            else if (running_process->remaining_cpu_burst == 0)
-            {
-                mark_process_terminated(running_process, time_tick + 1);
-                running_process = NULL;
-                terminated_counter++;
-            }
-        }
-
-        move_completed_io_to_ready();
-        time_tick++;
+        handle_kill_event(simulation, current_time, kill_event_list[simulation->next_kill_event_index].kill_pid, terminated_counter_pointer);
+        simulation->next_kill_event_index++;
     }
 }
 
-int compare_process_by_pid(const void *left_pointer, const void *right_pointer)
+bool event_precedes(const SchedulerEvent *first_event, const SchedulerEvent *second_event)
 {
-    ProcessControlRecord *first_process = *(ProcessControlRecord **)left_pointer;
-    ProcessControlRecord *second_process = *(ProcessControlRecord **)right_pointer;
-    return first_process->process_id - second_process->process_id;
+    if (first_event->event_tick != second_event->event_tick)
+    {
+        return first_event->event_tick < second_event->event_tick;
+    }
+    return first_event->event_cpu < second_event->event_cpu;
 }
 
-void print_result_table()
+bool push_scheduler_event(SchedulerEventHeap *event_heap, SchedulerEvent scheduler_event)
 {
-    ProcessControlRecord *sorted_list[MAX_PROCESSES];
-    int any_killed = 0;
+    if (event_heap->event_count == event_heap->event_capacity)
+    {
+        int new_capacity = event_heap->event_capacity ? event_heap->event_capacity * 2 : INITIAL_EVENT_HEAP_CAPACITY;
+        SchedulerEvent *new_events = (SchedulerEvent *)realloc(event_heap->heap_events, new_capacity * sizeof(SchedulerEvent));
+        if (new_events == NULL) {
+            printf("Memory allocation failed!!!");
+            return false;
+        }
+        event_heap->heap_events = new_events;
+        event_heap->event_capacity = new_capacity;
+    }
 
-    for (int registry_index = 0; registry_index < registered_process_count; registry_index++)
+    int child_index = event_heap->event_count++;
+    while (child_index > 0)
     {
-        sorted_list[registry_index] = registered_processes[registry_index];
-        if (sorted_list[registry_index]->terminated_by_kill)
+        int parent_index = (child_index - 1) / 2;
+        if (!event_precedes(&scheduler_event, &event_heap->heap_events[parent_index]))
         {
-            any_killed = 1;
+            break;
         }
+        event_heap->heap_events[child_index] = event_heap->heap_events[parent_index];
+        child_index = parent_index;
     }
+    event_heap->heap_events[child_index] = scheduler_event;
+    return true;
+}
 
-    qsort(sorted_list, registered_process_count, sizeof(ProcessControlRecord *), compare_process_by_pid);
+SchedulerEvent pop_scheduler_event(SchedulerEventHeap *event_heap)
+{
+    SchedulerEvent top_event = event_heap->heap_events[0];
+    SchedulerEvent last_event = event_heap->heap_events[--event_heap->event_count];
+    int parent_index = 0;
 
-    if (!any_killed)
+    while (true)
     {
-        printf("%-6s %-20s %-6s %-6s %-12s %-8s\n",
-               "PID", "Name", "CPU", "IO", "Turnaround", "Waiting");
-
-        for (int print_index = 0; print_index < registered_process_count; print_index++)
+        int child_index = 2 * parent_index + 1;
+        if (child_index >= event_heap->event_count)
         {
-            ProcessControlRecord *process_record = sorted_list[print_index];
-            int turnaround = process_record->completion_tick;
-            int waiting = turnaround - process_record->total_cpu_burst;
-            if (waiting < 0) waiting = 0;
-            printf("%-6d %-20s %-6d %-6d %-12d %-8d\n",
-                   process_record->process_id,
-                   process_record->process_name,
-                   process_record->total_cpu_burst,
-                   process_record->configured_io_duration,
-                   turnaround,
-                   waiting);
+            break;
+        }
+        if (child_index + 1 < event_heap->event_count &&
+            event_precedes(&event_heap->heap_events[child_index + 1], &event_heap->heap_events[child_index]))
+        {
+            child_index++;
         }
+        if (!event_precedes(&event_heap->heap_events[child_index], &last_event))
+        {
+            break;
+        }
+        event_heap->heap_events[parent_index] = event_heap->heap_events[child_index];
+        parent_index = child_index;
     }
-    else
+    if (event_heap->event_count > 0)
     {
-        printf("%-6s %-20s %-6s %-6s %-18s %-12s %-8s\n",
-               "PID", "Name", "CPU", "IO", "Status", "Turnaround", "Waiting");
+        event_heap->heap_events[parent_index] = last_event;
+    }
+    return top_event;
+}
 
-        for (int print_index = 0; print_index < registered_process_count; print_index++)
-        {
-            ProcessControlRecord *process_record = sorted_list[print_index];
 
-            if (process_record->terminated_by_kill)
-            {
-                char status_text[32];
-                snprintf(status_text, sizeof(status_text), "KILLED at %d", process_record->killed_at_tick);
-                printf("%-6d %-20s %-6d %-6d %-18s %-12s %-8s\n",
-                       process_record->process_id,
-                       process_record->process_name,
-                       process_record->total_cpu_burst,
-                       process_record->configured_io_duration,
-                       status_text,
-                       "-",
-                       "-");
-            }
-            else
-            {
-                int turnaround = process_record->completion_tick;
-                int waiting = turnaround - process_record->total_cpu_burst;
-                if (waiting < 0) waiting = 0;
-                printf("%-6d %-20s %-6d %-6d %-18s %-12d %-8d\n",
-                       process_record->process_id,
-                       process_record->process_name,
-                       process_record->total_cpu_burst,
-                       process_record->configured_io_duration,
-                       "OK",
-                       turnaround,
-                       waiting);
-            }
-        }
-    }
+void init_process_heap(ProcessHeap *process_heap, bool (*precedes)(const ProcessControlRecord *, const ProcessControlRecord *))
+{
+    process_heap->heap_processes = NULL;
+    process_heap->process_count = 0;
+    process_heap->heap_capacity = 0;
+    process_heap->precedes = precedes;
+}
+
+void place_heap_process(ProcessHeap *process_heap, ProcessControlRecord *process_record, int heap_index)
+{
+    process_heap->heap_processes[heap_index] = process_record;
+    process_record->heap_index = heap_index;
 }
 
-void read_kill_events_after_process_input()
+void sift_heap_process_up(ProcessHeap *process_heap, int heap_index)
 {
-    char buffer[256];
-    while (fgets(buffer, sizeof(buffer), stdin))
+    ProcessControlRecord *process_record = process_heap->heap_processes[heap_index];
+
+    while (heap_index > 0)
     {
-        trim_string(buffer);
-        if (strlen(buffer) == 0)
+        int parent_index = (heap_index - 1) / 2;
+        if (!process_heap->precedes(process_record, process_heap->heap_processes[parent_index]))
         {
             break;
         }
-        char verb_buffer[16];
-        char pid_string[MAX_INT_STR_LEN];
-        char time_string[MAX_INT_STR_LEN];
-        int fields_read = sscanf(buffer, "%15s %15s %15s", verb_buffer, pid_string, time_string);
-        if (fields_read != 3)
-        {
-            continue;
-        }
-        for (int char_index = 0; verb_buffer[char_index]; char_index++)
+        place_heap_process(process_heap, process_heap->heap_processes[parent_index], heap_index);
+        heap_index = parent_index;
+    }
+    place_heap_process(process_heap, process_record, heap_index);
+}
+
+void sift_heap_process_down(ProcessHeap *process_heap, int heap_index)
+{
+    ProcessControlRecord *process_record = process_heap->heap_processes[heap_index];
+
+    while (true)
+    {
+        int child_index = 2 * heap_index + 1;
+        if (child_index >= process_heap->process_count)
         {
-            verb_buffer[char_index] = (char) tolower((unsigned char)verb_buffer[char_index]);
+            break;
         }
-        if (strcmp(verb_buffer, "kill") != 0)
+        if (child_index + 1 < process_heap->process_count &&
+            process_heap->precedes(process_heap->heap_processes[child_index + 1], process_heap->heap_processes[child_index]))
         {
-            continue;
+            child_index++;
         }
-        if (!is_valid_kill_input(pid_string, time_string))
+        if (!process_heap->precedes(process_heap->heap_processes[child_index], process_record))
         {
-            continue;
+            break;
         }
-        int pid_value = atoi(pid_string);
-        int time_value = atoi(time_string);
-        kill_event_list[kill_event_count].kill_pid = pid_value;
-        kill_event_list[kill_event_count].kill_time = time_value;
-        kill_event_count++;
+        place_heap_process(process_heap, process_heap->heap_processes[child_index], heap_index);
+        heap_index = child_index;
     }
+    place_heap_process(process_heap, process_record, heap_index);
 }
 
-void destroy_process_table()
+bool push_heap_process(ProcessHeap *process_heap, ProcessControlRecord *process_record)
 {
-    for (int index = 0; index < MAX_PROCESS_TABLE_BUCKETS; index++)
+    if (process_heap->process_count == process_heap->heap_capacity)
     {
-        ProcessHashEntry *current = process_table[index];
-        while (current)
-        {
-            ProcessHashEntry *temporaryNode = current;
-            current = current->next_entry;
-            free(temporaryNode);
+        int new_capacity = process_heap->heap_capacity ? process_heap->heap_capacity * 2 : INITIAL_PROCESS_HEAP_CAPACITY;
+        ProcessControlRecord **new_heap = (ProcessControlRecord **)realloc(process_heap->heap_processes, new_capacity * sizeof(ProcessControlRecord *));
+        if (new_heap == NULL) {
+            printf("Memory allocation failed!!!");
+            return false;
         }
-        process_table[index] = NULL;
+        process_heap->heap_processes = new_heap;
+        process_heap->heap_capacity = new_capacity;
     }
+
+    process_heap->heap_processes[process_heap->process_count] = process_record;
+    sift_heap_process_up(process_heap, process_heap->process_count++);
+    return true;
 }
 
-void destroy_process_records()
+void remove_heap_process(ProcessHeap *process_heap, ProcessControlRecord *process_record)
 {
-    for (int index = 0; index < registered_process_count; index++)
+    int heap_index = process_record->heap_index;
+    ProcessControlRecord *last_process = process_heap->heap_processes[--process_heap->process_count];
+
+    process_record->heap_index = -1;
+    if (heap_index == process_heap->process_count)
+    {
+        return;
+    }
+
+    place_heap_process(process_heap, last_process, heap_index);
+    if (heap_index > 0 && process_heap->precedes(last_process, process_heap->heap_processes[(heap_index - 1) / 2]))
+    {
+        sift_heap_process_up(process_heap, heap_index);
+    }
+    else
     {
-        free(registered_processes[index]);
-        registered_processes[index] = NULL;
+        sift_heap_process_down(process_heap, heap_index);
     }
 }
 
-void cleanup_all_memory()
+ProcessControlRecord *pop_heap_process(ProcessHeap *process_heap)
 {
-    destroy_process_table();
-    destroy_process_records();
-    printf("Freeing up memory...Memory released!!!");
+    if (process_heap->process_count == 0)
+    {
+        return NULL;
+    }
+    ProcessControlRecord *process_record = process_heap->heap_processes[0];
+    remove_heap_process(process_heap, process_record);
+    return process_record;
 }
 
-int main()
+void destroy_process_heap(ProcessHeap *process_heap)
 {
-    init_queue(&ready_queue);
-    init_queue(&waiting_queue);
-    init_queue(&finished_queue);
-
-    printf("Enter the input in the given format :\n");
-    printf("<process_name>  <process_id>  <cpu_burst_time>  <io_start_time>  <io_duration_time>\n\n");
+    free(process_heap->heap_processes);
+    init_process_heap(process_heap, process_heap->precedes);
+}
 
-    char input_line[256];
+/* Equal completion ticks resolve in the order processes entered I/O, as the old FIFO waiting list did. */
+bool waiting_process_precedes(const ProcessControlRecord *first_process, const ProcessControlRecord *second_process)
+{
+    if (first_process->io_completion_tick != second_process->io_completion_tick)
+    {
+        return first_process->io_completion_tick < second_process->io_completion_tick;
+    }
+    return first_process->io_entered_tick < second_process->io_entered_tick;
+}
 
-    while (fgets(input_line, sizeof(input_line), stdin))
+bool arrival_process_precedes(const ProcessControlRecord *first_process, const ProcessControlRecord *second_process)
+{
+    if (first_process->arrival_tick != second_process->arrival_tick)
     {
-        trim_string(input_line);
+        return first_process->arrival_tick < second_process->arrival_tick;
+    }
+    return first_process->ready_sequence < second_process->ready_sequence;
+}
 
-        if (strlen(input_line) == 0)
-        {
-            read_kill_events_after_process_input();
-            break;
-        }
+bool shorter_remaining_precedes(const ProcessControlRecord *first_process, const ProcessControlRecord *second_process)
+{
+    if (first_process->remaining_cpu_burst != second_process->remaining_cpu_burst)
+    {
+        return first_process->remaining_cpu_burst < second_process->remaining_cpu_burst;
+    }
+    return first_process->ready_sequence < second_process->ready_sequence;
+}
 
-        parse_input_line(input_line);
+bool higher_priority_precedes(const ProcessControlRecord *first_process, const ProcessControlRecord *second_process)
+{
+    if (first_process->scheduling_priority != second_process->scheduling_priority)
+    {
+        return first_process->scheduling_priority < second_process->scheduling_priority;
     }
+    return first_process->ready_sequence < second_process->ready_sequence;
+}
 
-    if (total_process_count == 0)
+void init_run_queue(SimulationContext *simulation, RunQueue *run_queue)
+{
+    run_queue->simulation = simulation;
+    init_queue(&run_queue->fifo_queue);
+    init_process_heap(&run_queue->ready_heap, simulation->selected_policy->ready_order);
+    for (int queue_level = 0; queue_level < MLFQ_LEVEL_COUNT; queue_level++)
     {
-        printf("No valid processes entered.\n");
-        return 0;
+        init_queue(&run_queue->multilevel_queues[queue_level]);
+    }
+    memset(run_queue->timeline_head, 0, sizeof(run_queue->timeline_head));
+    run_queue->timeline_weight = 0;
+    run_queue->minimum_virtual_runtime = 0;
+    run_queue->ready_count = 0;
+}
+
+void fifo_on_arrive(RunQueue *run_queue, ProcessControlRecord *process_record)
+{
+    enqueue(&run_queue->fifo_queue, process_record);
+}
+
+ProcessControlRecord *fifo_pick_next(RunQueue *run_queue)
+{
+    return dequeue(&run_queue->fifo_queue);
+}
+
+void fifo_remove_ready(RunQueue *run_queue, ProcessControlRecord *process_record)
+{
+    (void)run_queue;
+    unlink_from_queue(process_record);
+}
+
+long long round_robin_time_slice(RunQueue *run_queue, const ProcessControlRecord *process_record)
+{
+    (void)run_queue;
+    (void)process_record;
+    return run_queue->simulation->time_quantum;
+}
+
+void heap_on_arrive(RunQueue *run_queue, ProcessControlRecord *process_record)
+{
+    push_heap_process(&run_queue->ready_heap, process_record);
+}
+
+ProcessControlRecord *heap_pick_next(RunQueue *run_queue)
+{
+    return pop_heap_process(&run_queue->ready_heap);
+}
+
+void heap_remove_ready(RunQueue *run_queue, ProcessControlRecord *process_record)
+{
+    remove_heap_process(&run_queue->ready_heap, process_record);
+}
+
+bool shortest_remaining_should_preempt(RunQueue *run_queue, const ProcessControlRecord *running_process)
+{
+    return run_queue->ready_heap.process_count > 0 &&
+           run_queue->ready_heap.heap_processes[0]->remaining_cpu_burst < running_process->remaining_cpu_burst;
+}
+
+bool priority_should_preempt(RunQueue *run_queue, const ProcessControlRecord *running_process)
+{
+    return run_queue->ready_heap.process_count > 0 &&
+           run_queue->ready_heap.heap_processes[0]->scheduling_priority < running_process->scheduling_priority;
+}
+
+long long multilevel_quantum(int base_quantum, int queue_level)
+{
+    return (long long)base_quantum << queue_level;
+}
+
+void multilevel_on_arrive(RunQueue *run_queue, ProcessControlRecord *process_record)
+{
+    enqueue(&run_queue->multilevel_queues[process_record->queue_level], process_record);
+}
+
+ProcessControlRecord *multilevel_pick_next(RunQueue *run_queue)
+{
+    for (int queue_level = 0; queue_level < MLFQ_LEVEL_COUNT; queue_level++)
+    {
+        if (run_queue->multilevel_queues[queue_level].front_process)
+        {
+            return dequeue(&run_queue->multilevel_queues[queue_level]);
+        }
+    }
+    return NULL;
+}
+
+void multilevel_remove_ready(RunQueue *run_queue, ProcessControlRecord *process_record)
+{
+    (void)run_queue;
+    unlink_from_queue(process_record);
+}
+
+long long multilevel_time_slice(RunQueue *run_queue, const ProcessControlRecord *process_record)
+{
+    return multilevel_quantum(run_queue->simulation->time_quantum, process_record->queue_level) - process_record->level_ticks_used;
+}
+
+void multilevel_on_tick(RunQueue *run_queue, ProcessControlRecord *process_record, long long ticks_run)
+{
+    (void)run_queue;
+    process_record->level_ticks_used += ticks_run;
+}
+
+/* A process that burns its whole allotment drops a level; one that yields for I/O keeps its level with a fresh allotment. */
+void multilevel_on_preempt(RunQueue *run_queue, ProcessControlRecord *process_record)
+{
+    if (process_record->level_ticks_used >= multilevel_quantum(run_queue->simulation->time_quantum, process_record->queue_level))
+    {
+        if (process_record->queue_level < MLFQ_LEVEL_COUNT - 1)
+        {
+            process_record->queue_level++;
+        }
+        process_record->level_ticks_used = 0;
+    }
+    multilevel_on_arrive(run_queue, process_record);
+}
+
+void multilevel_on_block(RunQueue *run_queue, ProcessControlRecord *process_record)
+{
+    (void)run_queue;
+    process_record->level_ticks_used = 0;
+}
+
+bool multilevel_should_preempt(RunQueue *run_queue, const ProcessControlRecord *running_process)
+{
+    for (int queue_level = 0; queue_level < running_process->queue_level; queue_level++)
+    {
+        if (run_queue->multilevel_queues[queue_level].front_process)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+int fair_share_weight(const ProcessControlRecord *process_record)
+{
+    int nice_index = process_record->scheduling_priority;
+    if (nice_index < 0)
+    {
+        nice_index = 0;
+    }
+    if (nice_index > 39)
+    {
+        nice_index = 39;
+    }
+    return nice_to_weight[nice_index];
+}
+
+bool timeline_precedes(const ProcessControlRecord *first_process, const ProcessControlRecord *second_process)
+{
+    if (first_process->virtual_runtime != second_process->virtual_runtime)
+    {
+        return first_process->virtual_runtime < second_process->virtual_runtime;
+    }
+    return first_process->ready_sequence < second_process->ready_sequence;
+}
+
+/* links[level] ends up pointing at the forward slot that should hold process_record on that level. */
+void find_timeline_links(RunQueue *run_queue, const ProcessControlRecord *process_record, ProcessControlRecord **links[CFS_TIMELINE_LEVELS])
+{
+    ProcessControlRecord **level_links = run_queue->timeline_head;
+
+    for (int level = CFS_TIMELINE_LEVELS - 1; level >= 0; level--)
+    {
+        while (level_links[level] && timeline_precedes(level_links[level], process_record))
+        {
+            level_links = level_links[level]->timeline_forward;
+        }
+        links[level] = &level_links[level];
+    }
+}
+
+int random_timeline_level(SimulationContext *simulation)
+{
+    int level = 1;
+
+    simulation->timeline_random_state ^= simulation->timeline_random_state << 13;
+    simulation->timeline_random_state ^= simulation->timeline_random_state >> 17;
+    simulation->timeline_random_state ^= simulation->timeline_random_state << 5;
+    unsigned int random_bits = simulation->timeline_random_state;
+    while (level < CFS_TIMELINE_LEVELS && (random_bits & 3) == 0)
+    {
+        level++;
+        random_bits >>= 2;
+    }
+    return level;
+}
+
+void insert_into_timeline(RunQueue *run_queue, ProcessControlRecord *process_record)
+{
+    ProcessControlRecord **links[CFS_TIMELINE_LEVELS];
+
+    find_timeline_links(run_queue, process_record, links);
+    if (process_record->timeline_forward == NULL)
+    {
+        int timeline_level = random_timeline_level(run_queue->simulation);
+        process_record->timeline_forward = allocate_timeline_links(run_queue->simulation, timeline_level);
+        if (process_record->timeline_forward == NULL)
+        {
+            return;
+        }
+        process_record->timeline_level = timeline_level;
+    }
+    for (int level = 0; level < process_record->timeline_level; level++)
+    {
+        process_record->timeline_forward[level] = *links[level];
+        *links[level] = process_record;
+    }
+    run_queue->timeline_weight += fair_share_weight(process_record);
+}
+
+void remove_from_timeline(RunQueue *run_queue, ProcessControlRecord *process_record)
+{
+    ProcessControlRecord **links[CFS_TIMELINE_LEVELS];
+
+    find_timeline_links(run_queue, process_record, links);
+    for (int level = 0; level < process_record->timeline_level; level++)
+    {
+        if (*links[level] == process_record)
+        {
+            *links[level] = process_record->timeline_forward[level];
+        }
+    }
+    run_queue->timeline_weight -= fair_share_weight(process_record);
+}
+
+/* New processes start at the current minimum; sleepers are credited at most half a latency period. */
+void fair_share_on_arrive(RunQueue *run_queue, ProcessControlRecord *process_record)
+{
+    long long sleeper_floor = run_queue->minimum_virtual_runtime - (CFS_TARGET_LATENCY * CFS_VRUNTIME_UNIT) / 2;
+
+    if (process_record->dispatch_count == 0)
+    {
+        process_record->virtual_runtime = run_queue->minimum_virtual_runtime;
+    }
+    else if (process_record->virtual_runtime < sleeper_floor)
+    {
+        process_record->virtual_runtime = sleeper_floor;
+    }
+    insert_into_timeline(run_queue, process_record);
+}
+
+void fair_share_on_preempt(RunQueue *run_queue, ProcessControlRecord *process_record)
+{
+    insert_into_timeline(run_queue, process_record);
+}
+
+ProcessControlRecord *fair_share_pick_next(RunQueue *run_queue)
+{
+    ProcessControlRecord *process_record = run_queue->timeline_head[0];
+
+    if (process_record)
+    {
+        remove_from_timeline(run_queue, process_record);
+    }
+    return process_record;
+}
+
+long long fair_share_time_slice(RunQueue *run_queue, const ProcessControlRecord *process_record)
+{
+    int weight = fair_share_weight(process_record);
+    long long slice = (long long)CFS_TARGET_LATENCY * weight / (run_queue->timeline_weight + weight);
+
+    return (slice < CFS_MIN_GRANULARITY) ? CFS_MIN_GRANULARITY : slice;
+}
+
+void fair_share_on_tick(RunQueue *run_queue, ProcessControlRecord *process_record, long long ticks_run)
+{
+    process_record->virtual_runtime += ticks_run * CFS_VRUNTIME_UNIT * nice_to_weight[CFS_DEFAULT_NICE_INDEX] / fair_share_weight(process_record);
+
+    long long candidate = process_record->virtual_runtime;
+    if (run_queue->timeline_head[0] && run_queue->timeline_head[0]->virtual_runtime < candidate)
+    {
+        candidate = run_queue->timeline_head[0]->virtual_runtime;
+    }
+    if (candidate > run_queue->minimum_virtual_runtime)
+    {
+        run_queue->minimum_virtual_runtime = candidate;
+    }
+}
+
+/* vruntime is only comparable within one run queue, so a stolen process is rebased onto the thief's clock. */
+void fair_share_on_migrate(RunQueue *source_queue, RunQueue *target_queue, ProcessControlRecord *process_record)
+{
+    process_record->virtual_runtime += target_queue->minimum_virtual_runtime - source_queue->minimum_virtual_runtime;
+}
+
+bool fair_share_should_preempt(RunQueue *run_queue, const ProcessControlRecord *running_process)
+{
+    return run_queue->timeline_head[0] &&
+           running_process->virtual_runtime - run_queue->timeline_head[0]->virtual_runtime > CFS_WAKEUP_GRANULARITY * CFS_VRUNTIME_UNIT;
+}
+
+const SchedulingPolicy *find_scheduling_policy(const char *policy_name)
+{
+    for (size_t policy_index = 0; policy_index < sizeof(scheduling_policies) / sizeof(scheduling_policies[0]); policy_index++)
+    {
+        if (strcasecmp(scheduling_policies[policy_index].policy_name, policy_name) == 0)
+        {
+            return &scheduling_policies[policy_index];
+        }
+    }
+    return NULL;
+}
+
+/* Processes queue on the CPU recorded in cpu_index: their initial CPU, or the one they last ran on. */
+void make_process_ready(SimulationContext *simulation, ProcessControlRecord *process_record, bool was_preempted)
+{
+    RunQueue *run_queue = &simulation->simulated_cpus[process_record->cpu_index].run_queue;
+
+    process_record->execution_state = STATE_READY;
+    process_record->ready_sequence = simulation->next_ready_sequence++;
+    run_queue->ready_count++;
+    simulation->ready_process_count++;
+
+    if (was_preempted && simulation->selected_policy->on_preempt)
+    {
+        simulation->selected_policy->on_preempt(run_queue, process_record);
+    }
+    else
+    {
+        simulation->selected_policy->on_arrive(run_queue, process_record);
+    }
+}
+
+/* An idle CPU with an empty run queue takes the next process from the busiest queue (lowest index on ties). */
+ProcessControlRecord *steal_ready_process(SimulationContext *simulation, int thief_index)
+{
+    int victim_index = -1;
+
+    for (int cpu_index = 0; cpu_index < simulation->simulated_cpu_count; cpu_index++)
+    {
+        if (simulation->simulated_cpus[cpu_index].run_queue.ready_count > 0 &&
+            (victim_index < 0 || simulation->simulated_cpus[cpu_index].run_queue.ready_count > simulation->simulated_cpus[victim_index].run_queue.ready_count))
+        {
+            victim_index = cpu_index;
+        }
+    }
+    if (victim_index < 0)
+    {
+        return NULL;
+    }
+
+    SimulatedCpu *victim = &simulation->simulated_cpus[victim_index];
+    SimulatedCpu *thief = &simulation->simulated_cpus[thief_index];
+    ProcessControlRecord *process_record = simulation->selected_policy->pick_next(&victim->run_queue);
+
+    victim->run_queue.ready_count--;
+    victim->migrations_out++;
+    thief->migrations_in++;
+    process_record->migration_count++;
+    process_record->cpu_index = thief_index;
+    if (simulation->selected_policy->on_migrate)
+    {
+        simulation->selected_policy->on_migrate(&victim->run_queue, &thief->run_queue, process_record);
+    }
+    return process_record;
+}
+
+void dispatch_next_process(SimulationContext *simulation, SchedulerEventHeap *event_heap, int cpu_index, long long current_time)
+{
+    SimulatedCpu *cpu = &simulation->simulated_cpus[cpu_index];
+    ProcessControlRecord *process_record = NULL;
+
+    if (cpu->run_queue.ready_count > 0)
+    {
+        process_record = simulation->selected_policy->pick_next(&cpu->run_queue);
+        cpu->run_queue.ready_count--;
+    }
+    else
+    {
+        process_record = steal_ready_process(simulation, cpu_index);
+    }
+
+    if (!process_record)
+    {
+        return;
+    }
+
+    simulation->ready_process_count--;
+    process_record->execution_state = STATE_RUNNING;
+    process_record->dispatched_at_tick = current_time;
+    process_record->dispatch_count++;
+    process_record->dispatch_sequence = ++simulation->next_dispatch_sequence;
+    cpu->running_process = process_record;
+    log_scheduler_event(simulation, LOG_DISPATCH, current_time, process_record, cpu_index);
+    schedule_cpu_release(simulation, event_heap, cpu_index, current_time);
+}
+
+void schedule_cpu_release(SimulationContext *simulation, SchedulerEventHeap *event_heap, int cpu_index, long long current_time)
+{
+    ProcessControlRecord *process_record = simulation->simulated_cpus[cpu_index].running_process;
+    long long ticks_until_release = LLONG_MAX;
+    int executed = process_record->executed_cpu_time;
+    int remaining = process_record->remaining_cpu_burst;
+
+    if ((process_record->io_start_tick > executed) &&
+        (process_record->io_start_tick - executed < remaining) &&
+        (process_record->io_duration_ticks > 0))
+    {
+        ticks_until_release = process_record->io_start_tick - executed;
+    }
+    else if (remaining > 0)
+    {
+        ticks_until_release = remaining;
+    }
+
+    if (simulation->selected_policy->time_slice)
+    {
+        long long slice = simulation->selected_policy->time_slice(&simulation->simulated_cpus[cpu_index].run_queue, process_record);
+        if (slice < ticks_until_release)
+        {
+            ticks_until_release = (slice > 0) ? slice : 1;
+        }
+    }
+
+    if (ticks_until_release == LLONG_MAX)
+    {
+        /* A zero burst never reaches exactly zero remaining, so only a kill can take it off the CPU. */
+        return;
+    }
+
+    SchedulerEvent release_event;
+    memset(&release_event, 0, sizeof(release_event));
+    release_event.event_tick = (long long)current_time + ticks_until_release - 1;
+    release_event.event_cpu = cpu_index;
+    release_event.event_sequence = process_record->dispatch_sequence;
+    release_event.event_process = process_record;
+    push_scheduler_event(event_heap, release_event);
+}
+
+void charge_running_process(SimulationContext *simulation, SimulatedCpu *cpu, long long end_tick)
+{
+    ProcessControlRecord *running_process = cpu->running_process;
+    int ticks_run = (int)(end_tick - running_process->dispatched_at_tick + 1);
+
+    cpu->busy_ticks += ticks_run;
+    running_process->executed_cpu_time += ticks_run;
+    running_process->remaining_cpu_burst -= ticks_run;
+    running_process->dispatched_at_tick = end_tick + 1;
+    if (simulation->selected_policy->on_tick)
+    {
+        simulation->selected_policy->on_tick(&cpu->run_queue, running_process, ticks_run);
+    }
+}
+
+void release_running_process(SimulationContext *simulation, SimulatedCpu *cpu, long long end_tick, int *terminated_counter_pointer)
+{
+    ProcessControlRecord *running_process = cpu->running_process;
+    int cpu_index = (int)(cpu - simulation->simulated_cpus);
+
+    charge_running_process(simulation, cpu, end_tick);
+    cpu->running_process = NULL;
+
+    if ((running_process->remaining_cpu_burst > 0) &&
+        (running_process->executed_cpu_time == running_process->io_start_tick) &&
+        (running_process->io_duration_ticks > 0))
+    {
+        running_process->remaining_io_ticks = running_process->io_duration_ticks;
+        running_process->execution_state = STATE_WAITING;
+        running_process->io_entered_tick = end_tick;
+        running_process->io_completion_tick = end_tick + running_process->io_duration_ticks;
+        if (simulation->selected_policy->on_block)
+        {
+            simulation->selected_policy->on_block(&cpu->run_queue, running_process);
+        }
+        push_heap_process(&simulation->waiting_heap, running_process);
+        log_scheduler_event(simulation, LOG_IO_START, end_tick + 1, running_process, cpu_index);
+    }
+    else if (running_process->remaining_cpu_burst == 0)
+    {
+        mark_process_terminated(simulation, running_process, end_tick + 1);
+        (*terminated_counter_pointer)++;
+        log_scheduler_event(simulation, LOG_FINISH, end_tick + 1, running_process, cpu_index);
+    }
+    else
+    {
+        make_process_ready(simulation, running_process, true);
+        log_scheduler_event(simulation, LOG_PREEMPT, end_tick + 1, running_process, cpu_index);
+    }
+}
+
+int complete_due_io(SimulationContext *simulation, long long current_tick)
+{
+    int completed_count = 0;
+
+    while (simulation->waiting_heap.process_count > 0 && simulation->waiting_heap.heap_processes[0]->io_completion_tick <= current_tick)
+    {
+        ProcessControlRecord *process_record = pop_heap_process(&simulation->waiting_heap);
+        process_record->remaining_io_ticks = 0;
+        make_process_ready(simulation, process_record, false);
+        log_scheduler_event(simulation, LOG_IO_END, process_record->io_completion_tick + 1, process_record, -1);
+        completed_count++;
+    }
+    return completed_count;
+}
+
+int process_events_through(SimulationContext *simulation, SchedulerEventHeap *event_heap, long long last_event_tick, int *terminated_counter_pointer)
+{
+    while (event_heap->event_count > 0 && event_heap->heap_events[0].event_tick <= last_event_tick)
+    {
+        SchedulerEvent scheduler_event = pop_scheduler_event(event_heap);
+        SimulatedCpu *cpu = &simulation->simulated_cpus[scheduler_event.event_cpu];
+
+        if ((scheduler_event.event_process == cpu->running_process) &&
+            (scheduler_event.event_sequence == scheduler_event.event_process->dispatch_sequence))
+        {
+            release_running_process(simulation, cpu, scheduler_event.event_tick, terminated_counter_pointer);
+        }
+    }
+
+    return complete_due_io(simulation, last_event_tick);
+}
+
+/* Arrivals at the end of a tick may displace a running process before the next dispatch. */
+void preempt_for_arrivals(SimulationContext *simulation, long long end_tick)
+{
+    for (int cpu_index = 0; cpu_index < simulation->simulated_cpu_count; cpu_index++)
+    {
+        SimulatedCpu *cpu = &simulation->simulated_cpus[cpu_index];
+        ProcessControlRecord *running_process = cpu->running_process;
+
+        if (!running_process)
+        {
+            continue;
+        }
+
+        charge_running_process(simulation, cpu, end_tick);
+        if (simulation->selected_policy->should_preempt(&cpu->run_queue, running_process))
+        {
+            cpu->running_process = NULL;
+            make_process_ready(simulation, running_process, true);
+            log_scheduler_event(simulation, LOG_PREEMPT, end_tick + 1, running_process, cpu_index);
+        }
+    }
+}
+
+bool any_cpu_idle(SimulationContext *simulation)
+{
+    for (int cpu_index = 0; cpu_index < simulation->simulated_cpu_count; cpu_index++)
+    {
+        if (!simulation->simulated_cpus[cpu_index].running_process)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void admit_process(SimulationContext *simulation, ProcessControlRecord *process_record)
+{
+    process_record->cpu_index = simulation->next_initial_cpu;
+    simulation->next_initial_cpu = (simulation->next_initial_cpu + 1) % simulation->simulated_cpu_count;
+    make_process_ready(simulation, process_record, false);
+}
+
+/* Until it arrives, a process waits in arrival_heap and ready_sequence holds its submission order. */
+void submit_process(SimulationContext *simulation, ProcessControlRecord *process_record)
+{
+    process_record->execution_state = STATE_NEW;
+    process_record->ready_sequence = simulation->next_ready_sequence++;
+    push_heap_process(&simulation->arrival_heap, process_record);
+}
+
+int admit_due_arrivals(SimulationContext *simulation, long long current_tick)
+{
+    int admitted_count = 0;
+
+    while (simulation->arrival_heap.process_count > 0 && simulation->arrival_heap.heap_processes[0]->arrival_tick <= current_tick)
+    {
+        admit_process(simulation, pop_heap_process(&simulation->arrival_heap));
+        admitted_count++;
+    }
+    return admitted_count;
+}
+
+void start_scheduler(SimulationContext *simulation)
+{
+    simulation->next_kill_event_index = 0;
+    simulation->current_tick = 0;
+
+    for (int cpu_index = 0; cpu_index < simulation->simulated_cpu_count; cpu_index++)
+    {
+        init_run_queue(simulation, &simulation->simulated_cpus[cpu_index].run_queue);
+    }
+    for (int registry_index = 0; registry_index < registered_process_count; registry_index++)
+    {
+        ProcessControlRecord *process_record = simulation_process_at(simulation, registry_index);
+        if (process_record->arrival_tick > 0)
+        {
+            submit_process(simulation, process_record);
+        }
+        else
+        {
+            admit_process(simulation, process_record);
+        }
+    }
+}
+
+/* Runs every tick before horizon_tick and stops on it, so events for horizon_tick itself can still be added.
+   Jumps between event times instead of stepping every tick; within a tick, arrivals, kills, dispatch (CPU 0 first),
+   CPU releases and then I/O completions run in the same order as the original per-tick loop. */
+void advance_scheduler(SimulationContext *simulation, long long horizon_tick)
+{
+    SchedulerEventHeap *event_heap = &simulation->event_heap;
+
+    while (simulation->current_tick < horizon_tick && simulation->terminated_count < total_process_count)
+    {
+        long long time_tick = simulation->current_tick;
+
+        if (admit_due_arrivals(simulation, time_tick) > 0 && time_tick > 0 && simulation->selected_policy->should_preempt)
+        {
+            preempt_for_arrivals(simulation, time_tick - 1);
+        }
+
+        apply_pending_kill_events(simulation, time_tick, &simulation->terminated_count);
+
+        for (int cpu_index = 0; cpu_index < simulation->simulated_cpu_count && simulation->ready_process_count > 0; cpu_index++)
+        {
+            if (!simulation->simulated_cpus[cpu_index].running_process)
+            {
+                dispatch_next_process(simulation, event_heap, cpu_index, time_tick);
+            }
+        }
+
+        int arrived_count = process_events_through(simulation, event_heap, time_tick, &simulation->terminated_count);
+
+        if (arrived_count > 0 && simulation->selected_policy->should_preempt)
+        {
+            preempt_for_arrivals(simulation, time_tick);
+        }
+
+        if (simulation->ready_process_count > 0 && any_cpu_idle(simulation))
+        {
+            time_tick++;
+        }
+        else if (scheduler_has_pending_events(simulation))
+        {
+            time_tick = (event_heap->event_count > 0) ? event_heap->heap_events[0].event_tick : LLONG_MAX;
+            if (simulation->waiting_heap.process_count > 0 && simulation->waiting_heap.heap_processes[0]->io_completion_tick < time_tick)
+            {
+                time_tick = simulation->waiting_heap.heap_processes[0]->io_completion_tick;
+            }
+            if (simulation->arrival_heap.process_count > 0 && simulation->arrival_heap.heap_processes[0]->arrival_tick < time_tick)
+            {
+                time_tick = simulation->arrival_heap.heap_processes[0]->arrival_tick;
+            }
+            if (simulation->next_kill_event_index < kill_event_count && kill_event_list[simulation->next_kill_event_index].kill_time < time_tick)
+            {
+                time_tick = kill_event_list[simulation->next_kill_event_index].kill_time;
+            }
+        }
+        else
+        {
+            /* Nothing left can change state: the only survivors sit behind a zero-burst process that is never killed. */
+            time_tick = horizon_tick;
+        }
+
+        simulation->current_tick = (time_tick < horizon_tick) ? time_tick : horizon_tick;
+    }
+}
+
+void execute_scheduler(SimulationContext *simulation)
+{
+    start_scheduler(simulation);
+    advance_scheduler(simulation, LLONG_MAX);
+}
+
+bool scheduler_has_pending_events(SimulationContext *simulation)
+{
+    return simulation->event_heap.event_count > 0 || simulation->waiting_heap.process_count > 0 ||
+           simulation->arrival_heap.process_count > 0 || simulation->next_kill_event_index < kill_event_count;
+}
+
+int compare_process_by_pid(const void *left_pointer, const void *right_pointer)
+{
+    ProcessControlRecord *first_process = *(ProcessControlRecord **)left_pointer;
+    ProcessControlRecord *second_process = *(ProcessControlRecord **)right_pointer;
+    return first_process->process_id - second_process->process_id;
+}
+
+void print_result_table(SimulationContext *simulation)
+{
+    ProcessControlRecord **sorted_list = (ProcessControlRecord **)malloc(registered_process_count * sizeof(ProcessControlRecord *));
+    int any_killed = 0;
+
+    if (sorted_list == NULL) {
+        printf("Memory allocation failed!!!");
+        return;
+    }
+
+    for (int registry_index = 0; registry_index < registered_process_count; registry_index++)
+    {
+        sorted_list[registry_index] = simulation_process_at(simulation, registry_index);
+        if (sorted_list[registry_index]->terminated_by_kill)
+        {
+            any_killed = 1;
+        }
+    }
+
+    qsort(sorted_list, registered_process_count, sizeof(ProcessControlRecord *), compare_process_by_pid);
+
+    if (!any_killed)
+    {
+        printf("%-6s %-20s %-6s %-6s %-12s %-8s\n",
+               "PID", "Name", "CPU", "IO", "Turnaround", "Waiting");
+
+        for (int print_index = 0; print_index < registered_process_count; print_index++)
+        {
+            ProcessControlRecord *process_record = sorted_list[print_index];
+            long long turnaround = process_record->completion_tick - process_record->arrival_tick;
+            long long waiting = turnaround - process_record->total_cpu_burst;
+            if (waiting < 0) waiting = 0;
+            printf("%-6d %-20s %-6d %-6d %-12lld %-8lld\n",
+                   process_record->process_id,
+                   process_record->process_name,
+                   process_record->total_cpu_burst,
+                   process_record->configured_io_duration,
+                   turnaround,
+                   waiting);
+        }
+    }
+    else
+    {
+        printf("%-6s %-20s %-6s %-6s %-18s %-12s %-8s\n",
+               "PID", "Name", "CPU", "IO", "Status", "Turnaround", "Waiting");
+
+        for (int print_index = 0; print_index < registered_process_count; print_index++)
+        {
+            ProcessControlRecord *process_record = sorted_list[print_index];
+
+            if (process_record->terminated_by_kill)
+            {
+                char status_text[32];
+                snprintf(status_text, sizeof(status_text), "KILLED at %lld", process_record->killed_at_tick);
+                printf("%-6d %-20s %-6d %-6d %-18s %-12s %-8s\n",
+                       process_record->process_id,
+                       process_record->process_name,
+                       process_record->total_cpu_burst,
+                       process_record->configured_io_duration,
+                       status_text,
+                       "-",
+                       "-");
+            }
+            else
+            {
+                long long turnaround = process_record->completion_tick - process_record->arrival_tick;
+                long long waiting = turnaround - process_record->total_cpu_burst;
+                if (waiting < 0) waiting = 0;
+                printf("%-6d %-20s %-6d %-6d %-18s %-12lld %-8lld\n",
+                       process_record->process_id,
+                       process_record->process_name,
+                       process_record->total_cpu_burst,
+                       process_record->configured_io_duration,
+                       "OK",
+                       turnaround,
+                       waiting);
+            }
+        }
+    }
+
+    free(sorted_list);
+
+    if (simulation->simulated_cpu_count > 1)
+    {
+        print_cpu_summary(simulation);
+    }
+}
+
+void print_cpu_summary(SimulationContext *simulation)
+{
+    long long makespan = 0;
+
+    for (int registry_index = 0; registry_index < registered_process_count; registry_index++)
+    {
+        ProcessControlRecord *process_record = simulation_process_at(simulation, registry_index);
+        if (process_record->completion_tick > makespan)
+        {
+            makespan = process_record->completion_tick;
+        }
+    }
+
+    printf("\n%-6s %-12s %-12s %-14s %-14s\n", "CPU", "Busy", "Utilization", "Migrated in", "Migrated out");
+    for (int cpu_index = 0; cpu_index < simulation->simulated_cpu_count; cpu_index++)
+    {
+        SimulatedCpu *cpu = &simulation->simulated_cpus[cpu_index];
+        char utilization_text[32];
+        snprintf(utilization_text, sizeof(utilization_text), "%.2f%%", makespan > 0 ? 100.0 * (double)cpu->busy_ticks / makespan : 0.0);
+        printf("%-6d %-12lld %-12s %-14d %-14d\n", cpu_index, cpu->busy_ticks, utilization_text, cpu->migrations_in, cpu->migrations_out);
+    }
+}
+
+void destroy_process_table()
+{
+    free(process_table);
+    process_table = NULL;
+    process_table_capacity = 0;
+    process_table_count = 0;
+}
+
+void destroy_process_records()
+{
+    for (int chunk_index = 0; chunk_index < process_pool_chunk_count; chunk_index++)
+    {
+        free(process_pool_chunks[chunk_index]);
+    }
+    free(process_pool_chunks);
+    process_pool_chunks = NULL;
+    process_pool_chunk_count = 0;
+    process_pool_chunk_capacity = 0;
+    free_process_records = NULL;
+    registered_process_count = 0;
+    total_process_count = 0;
+}
+
+void destroy_kill_events()
+{
+    free(kill_event_list);
+    kill_event_list = NULL;
+    kill_event_count = 0;
+    kill_event_capacity = 0;
+}
+
+void cleanup_all_memory()
+{
+    destroy_process_table();
+    destroy_process_records();
+    destroy_kill_events();
+    printf("Freeing up memory...Memory released!!!");
+}
+
+/* Kills outside 0..INT_MAX are dropped here; left in, the kill_time <= now cursor would fire them on the first tick. */
+void sort_kill_events()
+{
+    int kept_count = 0;
+    for (int kill_index = 0; kill_index < kill_event_count; kill_index++)
+    {
+        if (kill_event_list[kill_index].kill_time < 0 || kill_event_list[kill_index].kill_time > INT_MAX)
+        {
+            fprintf(stderr, "Ignoring KILL %d at out-of-range tick %lld.\n", kill_event_list[kill_index].kill_pid, kill_event_list[kill_index].kill_time);
+            continue;
+        }
+        kill_event_list[kept_count++] = kill_event_list[kill_index];
+    }
+    kill_event_count = kept_count;
+
+    if (kill_event_count > 0)
+    {
+        qsort(kill_event_list, kill_event_count, sizeof(KillEventRecord), compare_kill_event_by_time);
+    }
+}
+
+bool copy_process_pool(SimulationContext *simulation)
+{
+    simulation->process_chunks = (ProcessControlRecord **)calloc(process_pool_chunk_count, sizeof(ProcessControlRecord *));
+    if (simulation->process_chunks == NULL) {
+        printf("Memory allocation failed!!!");
+        return false;
+    }
+
+    for (int chunk_index = 0; chunk_index < process_pool_chunk_count; chunk_index++)
+    {
+        int chunk_records = registered_process_count - chunk_index * PROCESS_POOL_CHUNK_SIZE;
+        if (chunk_records > PROCESS_POOL_CHUNK_SIZE)
+        {
+            chunk_records = PROCESS_POOL_CHUNK_SIZE;
+        }
+        simulation->process_chunks[chunk_index] = (ProcessControlRecord *)malloc(PROCESS_POOL_CHUNK_SIZE * sizeof(ProcessControlRecord));
+        if (simulation->process_chunks[chunk_index] == NULL) {
+            printf("Memory allocation failed!!!");
+            return false;
+        }
+        simulation->owned_chunk_count++;
+        memcpy(simulation->process_chunks[chunk_index], process_pool_chunks[chunk_index], chunk_records * sizeof(ProcessControlRecord));
+    }
+    return true;
+}
+
+/* A private copy is only needed when several runs share the loaded trace. */
+SimulationContext *create_simulation_context(const SimulationSettings *run_settings, bool copy_processes)
+{
+    SimulationContext *simulation = (SimulationContext *)calloc(1, sizeof(SimulationContext));
+    if (simulation == NULL) {
+        printf("Memory allocation failed!!!");
+        return NULL;
+    }
+
+    simulation->selected_policy = run_settings->selected_policy;
+    simulation->time_quantum = run_settings->time_quantum;
+    simulation->simulated_cpu_count = run_settings->simulated_cpu_count;
+    simulation->io_duration_percent = run_settings->io_duration_percent;
+    simulation->timeline_random_state = CFS_TIMELINE_SEED;
+    simulation->timeline_links_used = TIMELINE_LINK_CHUNK_SIZE;
+    simulation->process_chunks = process_pool_chunks;
+    init_queue(&simulation->finished_queue);
+    init_process_heap(&simulation->waiting_heap, waiting_process_precedes);
+    init_process_heap(&simulation->arrival_heap, arrival_process_precedes);
+
+    if (copy_processes && !copy_process_pool(simulation))
+    {
+        destroy_simulation_context(simulation);
+        return NULL;
+    }
+
+    if (run_settings->io_duration_percent != 100)
+    {
+        for (int registry_index = 0; registry_index < registered_process_count; registry_index++)
+        {
+            scale_io_duration(simulation, simulation_process_at(simulation, registry_index));
+        }
+    }
+    return simulation;
+}
+
+void destroy_simulation_context(SimulationContext *simulation)
+{
+    close_scheduler_log(simulation);
+    destroy_process_heap(&simulation->waiting_heap);
+    destroy_process_heap(&simulation->arrival_heap);
+    free(simulation->event_heap.heap_events);
+    for (int cpu_index = 0; cpu_index < simulation->simulated_cpu_count; cpu_index++)
+    {
+        destroy_process_heap(&simulation->simulated_cpus[cpu_index].run_queue.ready_heap);
+    }
+
+    for (int chunk_index = 0; chunk_index < simulation->timeline_link_chunk_count; chunk_index++)
+    {
+        free(simulation->timeline_link_chunks[chunk_index]);
+    }
+    free(simulation->timeline_link_chunks);
+
+    if (simulation->process_chunks != process_pool_chunks)
+    {
+        for (int chunk_index = 0; chunk_index < simulation->owned_chunk_count; chunk_index++)
+        {
+            free(simulation->process_chunks[chunk_index]);
+        }
+        free(simulation->process_chunks);
+    }
+    free(simulation);
+}
+
+void scale_io_duration(SimulationContext *simulation, ProcessControlRecord *process_record)
+{
+    process_record->io_duration_ticks = (int)((long long)process_record->configured_io_duration * simulation->io_duration_percent / 100);
+}
+
+/* Prints and recycles everything that terminated since the last call; the PID may then be submitted again. */
+void drain_finished_processes(SimulationContext *simulation, OnlineRunTotals *run_totals)
+{
+    ProcessControlRecord *process_record;
+
+    while ((process_record = dequeue(&simulation->finished_queue)) != NULL)
+    {
+        if (process_record->terminated_by_kill)
+        {
+            char status_text[32];
+            snprintf(status_text, sizeof(status_text), "KILLED at %lld", process_record->killed_at_tick);
+            printf("%-6d %-20s %-6d %-6d %-8lld %-18s %-12s %-8s\n", process_record->process_id, process_record->process_name,
+                   process_record->total_cpu_burst, process_record->configured_io_duration, process_record->arrival_tick,
+                   status_text, "-", "-");
+            run_totals->killed_count++;
+        }
+        else
+        {
+            long long turnaround = process_record->completion_tick - process_record->arrival_tick;
+            long long waiting = turnaround - process_record->total_cpu_burst;
+            if (waiting < 0) waiting = 0;
+            printf("%-6d %-20s %-6d %-6d %-8lld %-18s %-12lld %-8lld\n", process_record->process_id, process_record->process_name,
+                   process_record->total_cpu_burst, process_record->configured_io_duration, process_record->arrival_tick,
+                   "OK", turnaround, waiting);
+            run_totals->completed_count++;
+            run_totals->turnaround_total += turnaround;
+        }
+        if (process_record->completion_tick > run_totals->last_completion_tick)
+        {
+            run_totals->last_completion_tick = process_record->completion_tick;
+        }
+        release_process_record(process_record);
+    }
+    fflush(stdout);
+}
+
+/* Reads a time-ordered stream of process and KILL lines, advancing the simulation to each event's tick before the
+   next line is read. Events stamped before the stream's latest tick are applied at that tick instead. */
+bool run_online_simulation(SimulationContext *simulation)
+{
+    OnlineRunTotals run_totals;
+    char *input_line = NULL;
+    size_t line_capacity = 0;
+    ssize_t line_length;
+    long long stream_tick = 0;
+
+    memset(&run_totals, 0, sizeof(run_totals));
+    start_scheduler(simulation);
+    printf("%-6s %-20s %-6s %-6s %-8s %-18s %-12s %-8s\n", "PID", "Name", "CPU", "IO", "Arrival", "Status", "Turnaround", "Waiting");
+    fflush(stdout);
+
+    while ((line_length = getline(&input_line, &line_capacity, stdin)) != -1)
+    {
+        const char *line_end = input_line + line_length;
+        TraceToken verb_token;
+        const char *cursor = next_trace_token(input_line, line_end, INT_MAX, &verb_token);
+        ProcessControlRecord *new_process = NULL;
+        long long *event_tick_pointer;
+        int event_pid;
+
+        if (verb_token.token_length == 0)
+        {
+            continue;
+        }
+
+        if (is_kill_verb(&verb_token))
+        {
+            TraceToken pid_token;
+            TraceToken time_token;
+            cursor = next_trace_token(cursor, line_end, INT_MAX, &pid_token);
+            next_trace_token(cursor, line_end, INT_MAX, &time_token);
+
+            /* Applied kills are dropped so the list only ever holds the ones still ahead of the clock. */
+            if (simulation->next_kill_event_index == kill_event_count)
+            {
+                kill_event_count = 0;
+                simulation->next_kill_event_index = 0;
+            }
+            int previous_kill_count = kill_event_count;
+            parse_kill_fields(&pid_token, &time_token);
+            if (kill_event_count == previous_kill_count)
+            {
+                continue;
+            }
+            event_tick_pointer = &kill_event_list[kill_event_count - 1].kill_time;
+            event_pid = kill_event_list[kill_event_count - 1].kill_pid;
+        }
+        else
+        {
+            new_process = parse_process_line(input_line, line_end);
+            if (new_process == NULL)
+            {
+                continue;
+            }
+            /* Growing the pool may have moved its chunk table. */
+            simulation->process_chunks = process_pool_chunks;
+            scale_io_duration(simulation, new_process);
+            event_tick_pointer = &new_process->arrival_tick;
+            event_pid = new_process->process_id;
+        }
+
+        if (*event_tick_pointer < stream_tick)
+        {
+            fprintf(stderr, "Event for PID %d at tick %lld is behind the stream; applied at tick %lld.\n", event_pid, *event_tick_pointer, stream_tick);
+            *event_tick_pointer = stream_tick;
+        }
+        stream_tick = *event_tick_pointer;
+
+        if (new_process)
+        {
+            submit_process(simulation, new_process);
+        }
+        advance_scheduler(simulation, stream_tick);
+        drain_finished_processes(simulation, &run_totals);
+    }
+    free(input_line);
+
+    advance_scheduler(simulation, LLONG_MAX);
+    drain_finished_processes(simulation, &run_totals);
+
+    printf("\nOnline run: %d processes, %d completed, %d killed, %d unfinished, last completion at tick %lld, peak %d resident processes",
+           total_process_count, run_totals.completed_count, run_totals.killed_count,
+           total_process_count - simulation->terminated_count, run_totals.last_completion_tick, registered_process_count);
+    if (run_totals.completed_count > 0)
+    {
+        printf(", average turnaround %.2f", (double)run_totals.turnaround_total / run_totals.completed_count);
+    }
+    printf("\n");
+    return true;
+}
+
+void summarize_simulation(SimulationContext *simulation, SweepRunResult *run_result)
+{
+    long long turnaround_total = 0;
+    long long waiting_total = 0;
+
+    for (int registry_index = 0; registry_index < registered_process_count; registry_index++)
+    {
+        ProcessControlRecord *process_record = simulation_process_at(simulation, registry_index);
+        if (process_record->completion_tick > run_result->makespan)
+        {
+            run_result->makespan = process_record->completion_tick;
+        }
+        if (process_record->terminated_by_kill)
+        {
+            run_result->killed_count++;
+        }
+        else if (process_record->completion_tick < 0)
+        {
+            run_result->unfinished_count++;
+        }
+        else
+        {
+            long long turnaround = process_record->completion_tick - process_record->arrival_tick;
+            long long waiting = turnaround - process_record->total_cpu_burst;
+            run_result->completed_count++;
+            turnaround_total += turnaround;
+            waiting_total += (waiting > 0) ? waiting : 0;
+        }
+    }
+
+    if (run_result->completed_count > 0)
+    {
+        run_result->average_turnaround = (double)turnaround_total / run_result->completed_count;
+        run_result->average_waiting = (double)waiting_total / run_result->completed_count;
+    }
+    for (int cpu_index = 0; cpu_index < simulation->simulated_cpu_count; cpu_index++)
+    {
+        run_result->busy_ticks += simulation->simulated_cpus[cpu_index].busy_ticks;
+    }
+}
+
+/* Workers claim run indices from a shared counter; each run owns its context, so only the counter is locked. */
+void *run_sweep_worker(void *worker_argument)
+{
+    SweepWorkQueue *work_queue = (SweepWorkQueue *)worker_argument;
+
+    while (true)
+    {
+        pthread_mutex_lock(&work_queue->queue_mutex);
+        int run_index = work_queue->next_run_index++;
+        pthread_mutex_unlock(&work_queue->queue_mutex);
+
+        if (run_index >= work_queue->run_count)
+        {
+            break;
+        }
+
+        SweepRunResult *run_result = &work_queue->run_results[run_index];
+        SimulationContext *simulation = work_queue->resume_image ?
+                                        resume_simulation_context(&run_result->run_settings, work_queue->resume_image, true) :
+                                        create_simulation_context(&run_result->run_settings, true);
+        if (simulation == NULL)
+        {
+            run_result->run_failed = true;
+            continue;
+        }
+        if (work_queue->resume_image == NULL)
+        {
+            start_scheduler(simulation);
+        }
+        advance_scheduler(simulation, LLONG_MAX);
+        summarize_simulation(simulation, run_result);
+        destroy_simulation_context(simulation);
+    }
+    return NULL;
+}
+
+bool write_sweep_csv(const SweepRunResult *run_results, int run_count)
+{
+    FILE *csv_file = fopen(sweep_csv_path, "w");
+    if (csv_file == NULL)
+    {
+        printf("Could not open '%s' for writing.\n", sweep_csv_path);
+        return false;
+    }
+
+    fprintf(csv_file, "run,policy,quantum,cpus,io_percent,processes,completed,killed,unfinished,makespan,avg_turnaround,avg_waiting,cpu_utilization\n");
+    for (int run_index = 0; run_index < run_count; run_index++)
+    {
+        const SweepRunResult *run_result = &run_results[run_index];
+        const SimulationSettings *run_settings = &run_result->run_settings;
+
+        fprintf(csv_file, "%d,%s,%d,%d,%d,", run_index, run_settings->selected_policy->policy_name, run_settings->time_quantum,
+                run_settings->simulated_cpu_count, run_settings->io_duration_percent);
+        if (run_result->run_failed)
+        {
+            fprintf(csv_file, "%d,,,,,,,\n", registered_process_count);
+            continue;
+        }
+        double capacity = (double)run_result->makespan * run_settings->simulated_cpu_count;
+        fprintf(csv_file, "%d,%d,%d,%d,%lld,%.2f,%.2f,%.2f\n", registered_process_count, run_result->completed_count,
+                run_result->killed_count, run_result->unfinished_count, run_result->makespan, run_result->average_turnaround,
+                run_result->average_waiting, capacity > 0 ? 100.0 * (double)run_result->busy_ticks / capacity : 0.0);
+    }
+
+    fclose(csv_file);
+    return true;
+}
+
+/* Runs every combination of the command-line lists, policy varying slowest and I/O percentage fastest. */
+/* With a resume_image every run branches from the same checkpoint instead of starting at tick 0. */
+bool run_parameter_sweep(const CheckpointImage *resume_image)
+{
+    int run_count = policy_axis.value_count * quantum_axis.value_count * cpu_axis.value_count * io_percent_axis.value_count;
+    SweepRunResult *run_results = (SweepRunResult *)calloc(run_count, sizeof(SweepRunResult));
+    if (run_results == NULL) {
+        printf("Memory allocation failed!!!");
+        return false;
+    }
+
+    int run_index = 0;
+    for (int policy_index = 0; policy_index < policy_axis.value_count; policy_index++)
+    {
+        for (int quantum_index = 0; quantum_index < quantum_axis.value_count; quantum_index++)
+        {
+            for (int cpu_index = 0; cpu_index < cpu_axis.value_count; cpu_index++)
+            {
+                for (int io_index = 0; io_index < io_percent_axis.value_count; io_index++)
+                {
+                    SimulationSettings *run_settings = &run_results[run_index++].run_settings;
+                    run_settings->selected_policy = &scheduling_policies[policy_axis.axis_values[policy_index]];
+                    run_settings->time_quantum = quantum_axis.axis_values[quantum_index];
+                    run_settings->simulated_cpu_count = cpu_axis.axis_values[cpu_index];
+                    run_settings->io_duration_percent = io_percent_axis.axis_values[io_index];
+                }
+            }
+        }
+    }
+
+    int thread_count = sweep_thread_count > 0 ? sweep_thread_count : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (thread_count < 1)
+    {
+        thread_count = 1;
+    }
+    if (thread_count > run_count)
+    {
+        thread_count = run_count;
+    }
+
+    SweepWorkQueue work_queue = {run_results, run_count, resume_image, 0, PTHREAD_MUTEX_INITIALIZER};
+    pthread_t *worker_threads = (pthread_t *)malloc(thread_count * sizeof(pthread_t));
+    int started_threads = 0;
+
+    /* The main thread works too, so the sweep still finishes if no extra thread can be started. */
+    while (worker_threads != NULL && started_threads < thread_count - 1 &&
+           pthread_create(&worker_threads[started_threads], NULL, run_sweep_worker, &work_queue) == 0)
+    {
+        started_threads++;
+    }
+    run_sweep_worker(&work_queue);
+    for (int thread_index = 0; thread_index < started_threads; thread_index++)
+    {
+        pthread_join(worker_threads[thread_index], NULL);
+    }
+    free(worker_threads);
+    pthread_mutex_destroy(&work_queue.queue_mutex);
+
+    bool written = write_sweep_csv(run_results, run_count);
+    if (written)
+    {
+        printf("Sweep finished: %d runs on %d threads, results written to %s\n", run_count, started_threads + 1, sweep_csv_path);
+    }
+    free(run_results);
+    return written;
+}
+
+void write_trace_event_separator(FILE *trace_file, bool *first_trace_event)
+{
+    fputs(*first_trace_event ? "\n" : ",\n", trace_file);
+    *first_trace_event = false;
+}
+
+/* Slices become B/E pairs on one thread per CPU and I/O waits become async b/e pairs keyed by PID,
+   so the converter never has to match events itself. */
+void write_trace_events(FILE *trace_file, const SchedulerLogRecord *log_record, bool cpu_named[MAX_SIMULATED_CPUS], bool *first_trace_event)
+{
+    int cpu_index = log_record->record_cpu;
+
+    if (cpu_index >= 0 && cpu_index < MAX_SIMULATED_CPUS && !cpu_named[cpu_index])
+    {
+        write_trace_event_separator(trace_file, first_trace_event);
+        fprintf(trace_file, "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":0,\"tid\":%d,\"args\":{\"name\":\"CPU %d\"}}", cpu_index, cpu_index);
+        cpu_named[cpu_index] = true;
+    }
+
+    if (log_record->record_kind == LOG_DISPATCH)
+    {
+        write_trace_event_separator(trace_file, first_trace_event);
+        fprintf(trace_file, "{\"ph\":\"B\",\"name\":\"PID %d\",\"pid\":0,\"tid\":%d,\"ts\":%d}", log_record->record_pid, cpu_index, log_record->record_tick);
+    }
+    else if (cpu_index >= 0)
+    {
+        write_trace_event_separator(trace_file, first_trace_event);
+        fprintf(trace_file, "{\"ph\":\"E\",\"pid\":0,\"tid\":%d,\"ts\":%d}", cpu_index, log_record->record_tick);
+    }
+
+    if (log_record->record_kind == LOG_IO_START || log_record->record_kind == LOG_IO_END)
+    {
+        write_trace_event_separator(trace_file, first_trace_event);
+        fprintf(trace_file, "{\"ph\":\"%s\",\"cat\":\"io\",\"name\":\"I/O\",\"id\":%d,\"pid\":1,\"tid\":0,\"ts\":%d}",
+                log_record->record_kind == LOG_IO_START ? "b" : "e", log_record->record_pid, log_record->record_tick);
+    }
+    else if (log_record->record_kind == LOG_KILL)
+    {
+        write_trace_event_separator(trace_file, first_trace_event);
+        fprintf(trace_file, "{\"ph\":\"i\",\"s\":\"g\",\"name\":\"KILL PID %d\",\"pid\":0,\"tid\":%d,\"ts\":%d}",
+                log_record->record_pid, cpu_index >= 0 ? cpu_index : 0, log_record->record_tick);
+    }
+
+    write_trace_event_separator(trace_file, first_trace_event);
+    fprintf(trace_file, "{\"ph\":\"C\",\"name\":\"ready\",\"pid\":0,\"ts\":%d,\"args\":{\"ready\":%d}}", log_record->record_tick, log_record->record_ready_depth);
+}
+
+bool convert_scheduler_log(const char *log_path, const char *csv_path, const char *trace_path)
+{
+    FILE *log_file = fopen(log_path, "rb");
+    char log_magic[SCHEDULER_LOG_MAGIC_LEN];
+
+    if (log_file == NULL)
+    {
+        printf("Could not open '%s'.\n", log_path);
+        return false;
+    }
+    if (fread(log_magic, 1, SCHEDULER_LOG_MAGIC_LEN, log_file) != SCHEDULER_LOG_MAGIC_LEN ||
+        memcmp(log_magic, SCHEDULER_LOG_MAGIC, SCHEDULER_LOG_MAGIC_LEN) != 0)
+    {
+        printf("'%s' is not a scheduler event log.\n", log_path);
+        fclose(log_file);
+        return false;
+    }
+
+    FILE *csv_file = fopen(csv_path, "w");
+    FILE *trace_file = fopen(trace_path, "w");
+    SchedulerLogRecord *log_records = (SchedulerLogRecord *)malloc(SCHEDULER_LOG_BUFFER_RECORDS * sizeof(SchedulerLogRecord));
+    if (csv_file == NULL || trace_file == NULL || log_records == NULL)
+    {
+        printf("Could not open the output files.\n");
+        if (csv_file) fclose(csv_file);
+        if (trace_file) fclose(trace_file);
+        free(log_records);
+        fclose(log_file);
+        return false;
+    }
+
+    bool cpu_named[MAX_SIMULATED_CPUS] = {false};
+    bool first_trace_event = true;
+    bool log_valid = true;
+    long long converted_records = 0;
+    size_t records_read;
+
+    fprintf(csv_file, "tick,event,pid,cpu,ready_depth\n");
+    fprintf(trace_file, "{\"traceEvents\":[");
+    write_trace_event_separator(trace_file, &first_trace_event);
+    fprintf(trace_file, "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":0,\"args\":{\"name\":\"CPUs\"}},\n");
+    fprintf(trace_file, "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":1,\"args\":{\"name\":\"I/O\"}}");
+
+    while (log_valid && (records_read = fread(log_records, sizeof(SchedulerLogRecord), SCHEDULER_LOG_BUFFER_RECORDS, log_file)) > 0)
+    {
+        for (size_t record_index = 0; record_index < records_read; record_index++)
+        {
+            const SchedulerLogRecord *log_record = &log_records[record_index];
+            if (log_record->record_kind >= LOG_KIND_COUNT)
+            {
+                printf("Corrupt record %lld in '%s'.\n", converted_records, log_path);
+                log_valid = false;
+                break;
+            }
+            fprintf(csv_file, "%d,%s,%d,%d,%d\n", log_record->record_tick, scheduler_log_kind_names[log_record->record_kind],
+                    log_record->record_pid, log_record->record_cpu, log_record->record_ready_depth);
+            write_trace_events(trace_file, log_record, cpu_named, &first_trace_event);
+            converted_records++;
+        }
+    }
+    fprintf(trace_file, "\n]}\n");
+
+    fclose(trace_file);
+    fclose(csv_file);
+    fclose(log_file);
+    free(log_records);
+    if (log_valid)
+    {
+        printf("Converted %lld events to %s and %s\n", converted_records, csv_path, trace_path);
+    }
+    return log_valid;
+}
+
+/* xorshift64*: cheap, and the same seed always yields the same trace. */
+unsigned long long next_workload_random(unsigned long long *random_state)
+{
+    *random_state ^= *random_state >> 12;
+    *random_state ^= *random_state << 25;
+    *random_state ^= *random_state >> 27;
+    return *random_state * 2685821657736338717ULL;
+}
+
+/* Uniform in (0, 1], so the inverse-CDF samplers below never take log(0). */
+double next_workload_unit(unsigned long long *random_state)
+{
+    return (double)((next_workload_random(random_state) >> 11) + 1) / 9007199254740992.0;
+}
+
+int sample_workload_ticks(unsigned long long *random_state, WorkloadDistribution distribution, int mean_ticks)
+{
+    double sampled_ticks;
+
+    switch (distribution)
+    {
+    case DISTRIBUTION_EXPONENTIAL:
+        sampled_ticks = 1.0 - mean_ticks * log(next_workload_unit(random_state));
+        break;
+    case DISTRIBUTION_PARETO:
+        sampled_ticks = (mean_ticks * (WORKLOAD_PARETO_SHAPE - 1.0) / WORKLOAD_PARETO_SHAPE) *
+                        pow(next_workload_unit(random_state), -1.0 / WORKLOAD_PARETO_SHAPE);
+        break;
+    default:
+        sampled_ticks = 1.0 + next_workload_unit(random_state) * (2 * mean_ticks - 1);
+        break;
+    }
+
+    if (sampled_ticks < 1.0)
+    {
+        return 1;
+    }
+    return (sampled_ticks > WORKLOAD_MAX_SAMPLE_TICKS) ? WORKLOAD_MAX_SAMPLE_TICKS : (int)sampled_ticks;
+}
+
+const WorkloadProfile *find_workload_profile(const char *workload_name)
+{
+    for (size_t profile_index = 0; profile_index < sizeof(workload_profiles) / sizeof(workload_profiles[0]); profile_index++)
+    {
+        if (strcmp(workload_profiles[profile_index].workload_name, workload_name) == 0)
+        {
+            return &workload_profiles[profile_index];
+        }
+    }
+    return NULL;
+}
+
+/* PIDs run 1..process_count; kills pick random PIDs, so a PID can be named twice or after it already finished. */
+void write_workload_trace(FILE *trace_file, const WorkloadProfile *profile, int process_count, unsigned long long trace_seed)
+{
+    unsigned long long random_state = trace_seed * 0x9E3779B97F4A7C15ULL + 1;
+    long long expected_makespan = (long long)process_count * profile->mean_burst;
+
+    for (int process_index = 1; process_index <= process_count; process_index++)
+    {
+        int burst_ticks = sample_workload_ticks(&random_state, profile->burst_distribution, profile->mean_burst);
+        int priority = (int)(next_workload_random(&random_state) % 40);
+
+        if (burst_ticks > 1 && (int)(next_workload_random(&random_state) % 100) < profile->io_percent)
+        {
+            int io_start = 1 + (int)(next_workload_random(&random_state) % (unsigned long long)(burst_ticks - 1));
+            int io_duration = sample_workload_ticks(&random_state, profile->io_distribution, profile->mean_io_duration);
+            fprintf(trace_file, "p%d %d %d %d %d %d", process_index, process_index, burst_ticks, io_start, io_duration, priority);
+        }
+        else
+        {
+            fprintf(trace_file, "p%d %d %d - - %d", process_index, process_index, burst_ticks, priority);
+        }
+
+        if (profile->arrival_burst_size > 0)
+        {
+            long long arrival_tick = (long long)((process_index - 1) / profile->arrival_burst_size) * profile->arrival_burst_gap;
+            fprintf(trace_file, " %lld", arrival_tick > INT_MAX ? (long long)INT_MAX : arrival_tick);
+        }
+        fprintf(trace_file, "\n");
+    }
+    fprintf(trace_file, "\n");
+
+    long long kill_count = (long long)process_count * profile->kill_percent / 100;
+    long long kill_start = expected_makespan * profile->kill_start_percent / 100;
+    long long kill_spread = expected_makespan * profile->kill_spread_percent / 100;
+
+    for (long long kill_index = 0; kill_index < kill_count; kill_index++)
+    {
+        int target_pid = 1 + (int)(next_workload_random(&random_state) % (unsigned long long)process_count);
+        long long kill_time = kill_start + (kill_spread > 0 ? (long long)(next_workload_random(&random_state) % (unsigned long long)kill_spread) : 0);
+        fprintf(trace_file, "KILL %d %lld\n", target_pid, kill_time > INT_MAX ? (long long)INT_MAX : kill_time);
+    }
+    fprintf(trace_file, "\n");
+}
+
+void reset_loaded_trace()
+{
+    destroy_process_table();
+    destroy_process_records();
+    destroy_kill_events();
+}
+
+/* Each workload goes through the same text loader and engine as a real trace, using the first value of every
+   scheduling option. Simulated ticks are the makespan; events are everything the event log would record. */
+bool run_workload_benchmark(const SimulationSettings *run_settings)
+{
+    printf("%-14s %-10s %-10s %-12s %-12s %-10s %-10s %-14s %-14s\n", "Workload", "Processes", "Kills", "Sim ticks",
+           "Events", "Load s", "Run s", "Ticks/s", "Events/s");
+
+    for (size_t profile_index = 0; profile_index < sizeof(workload_profiles) / sizeof(workload_profiles[0]); profile_index++)
+    {
+        const WorkloadProfile *profile = &workload_profiles[profile_index];
+        char *trace_buffer = NULL;
+        size_t trace_size = 0;
+        FILE *trace_file = open_memstream(&trace_buffer, &trace_size);
+        if (trace_file == NULL) {
+            printf("Memory allocation failed!!!");
+            return false;
+        }
+        write_workload_trace(trace_file, profile, benchmark_process_count, workload_seed);
+        fclose(trace_file);
+
+        struct timespec load_started;
+        struct timespec run_started;
+        struct timespec run_finished;
+
+        clock_gettime(CLOCK_MONOTONIC, &load_started);
+        parse_trace_buffer(trace_buffer, trace_size);
+        free(trace_buffer);
+        sort_kill_events();
+
+        SimulationContext *simulation = create_simulation_context(run_settings, false);
+        if (simulation == NULL)
+        {
+            reset_loaded_trace();
+            return false;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &run_started);
+        execute_scheduler(simulation);
+        clock_gettime(CLOCK_MONOTONIC, &run_finished);
+
+        SweepRunResult run_result;
+        memset(&run_result, 0, sizeof(run_result));
+        summarize_simulation(simulation, &run_result);
+
+        double load_seconds = (double)(run_started.tv_sec - load_started.tv_sec) +
+                              (double)(run_started.tv_nsec - load_started.tv_nsec) / 1e9;
+        double run_seconds = (double)(run_finished.tv_sec - run_started.tv_sec) +
+                             (double)(run_finished.tv_nsec - run_started.tv_nsec) / 1e9;
+
+        printf("%-14s %-10d %-10d %-12lld %-12lld %-10.3f %-10.3f %-14.0f %-14.0f\n", profile->workload_name, total_process_count,
+               kill_event_count, run_result.makespan, simulation->scheduler_event_count, load_seconds, run_seconds,
+               run_seconds > 0 ? run_result.makespan / run_seconds : 0.0,
+               run_seconds > 0 ? simulation->scheduler_event_count / run_seconds : 0.0);
+
+        destroy_simulation_context(simulation);
+        reset_loaded_trace();
+    }
+    return true;
+}
+
+void write_checkpoint_queue(FILE *checkpoint_file, const ProcessLinkedQueue *queue)
+{
+    int list_length = 0;
+
+    for (const ProcessControlRecord *process_record = queue->front_process; process_record; process_record = process_record->next_process)
+    {
+        list_length++;
+    }
+    fwrite(&list_length, sizeof(int), 1, checkpoint_file);
+    for (const ProcessControlRecord *process_record = queue->front_process; process_record; process_record = process_record->next_process)
+    {
+        fwrite(&process_record->registry_index, sizeof(int), 1, checkpoint_file);
+    }
+}
+
+void write_checkpoint_heap(FILE *checkpoint_file, const ProcessHeap *process_heap)
+{
+    fwrite(&process_heap->process_count, sizeof(int), 1, checkpoint_file);
+    for (int heap_index = 0; heap_index < process_heap->process_count; heap_index++)
+    {
+        fwrite(&process_heap->heap_processes[heap_index]->registry_index, sizeof(int), 1, checkpoint_file);
+    }
+}
+
+/* Only the bottom level is stored; restore derives the upper levels from each process's timeline_level. */
+void write_checkpoint_timeline(FILE *checkpoint_file, const RunQueue *run_queue)
+{
+    int list_length = 0;
+
+    for (const ProcessControlRecord *process_record = run_queue->timeline_head[0]; process_record; process_record = process_record->timeline_forward[0])
+    {
+        list_length++;
+    }
+    fwrite(&list_length, sizeof(int), 1, checkpoint_file);
+    for (const ProcessControlRecord *process_record = run_queue->timeline_head[0]; process_record; process_record = process_record->timeline_forward[0])
+    {
+        fwrite(&process_record->registry_index, sizeof(int), 1, checkpoint_file);
+    }
+}
+
+void pack_checkpoint_process(const ProcessControlRecord *process_record, CheckpointProcess *checkpoint_process)
+{
+    memset(checkpoint_process, 0, sizeof(CheckpointProcess));
+    checkpoint_process->io_completion_tick = process_record->io_completion_tick;
+    checkpoint_process->dispatch_sequence = process_record->dispatch_sequence;
+    checkpoint_process->ready_sequence = process_record->ready_sequence;
+    checkpoint_process->level_ticks_used = process_record->level_ticks_used;
+    checkpoint_process->virtual_runtime = process_record->virtual_runtime;
+    checkpoint_process->process_id = process_record->process_id;
+    checkpoint_process->total_cpu_burst = process_record->total_cpu_burst;
+    checkpoint_process->remaining_cpu_burst = process_record->remaining_cpu_burst;
+    checkpoint_process->io_start_tick = process_record->io_start_tick;
+    checkpoint_process->remaining_io_ticks = process_record->remaining_io_ticks;
+    checkpoint_process->executed_cpu_time = process_record->executed_cpu_time;
+    checkpoint_process->completion_tick = process_record->completion_tick;
+    checkpoint_process->configured_io_duration = process_record->configured_io_duration;
+    checkpoint_process->killed_at_tick = process_record->killed_at_tick;
+    checkpoint_process->dispatched_at_tick = process_record->dispatched_at_tick;
+    checkpoint_process->io_entered_tick = process_record->io_entered_tick;
+    checkpoint_process->dispatch_count = process_record->dispatch_count;
+    checkpoint_process->arrival_tick = process_record->arrival_tick;
+    checkpoint_process->scheduling_priority = process_record->scheduling_priority;
+    checkpoint_process->migration_count = process_record->migration_count;
+    checkpoint_process->cpu_index = (short)process_record->cpu_index;
+    checkpoint_process->execution_state = (unsigned char)process_record->execution_state;
+    checkpoint_process->terminated_by_kill = (unsigned char)process_record->terminated_by_kill;
+    checkpoint_process->queue_level = (unsigned char)process_record->queue_level;
+    checkpoint_process->timeline_level = (unsigned char)process_record->timeline_level;
+    checkpoint_process->name_length = (unsigned char)strlen(process_record->process_name);
+}
+
+void unpack_checkpoint_process(const CheckpointProcess *checkpoint_process, const char *process_name, ProcessControlRecord *process_record)
+{
+    memcpy(process_record->process_name, process_name, checkpoint_process->name_length);
+    process_record->process_name[checkpoint_process->name_length] = '\0';
+    process_record->process_id = checkpoint_process->process_id;
+    process_record->total_cpu_burst = checkpoint_process->total_cpu_burst;
+    process_record->remaining_cpu_burst = checkpoint_process->remaining_cpu_burst;
+    process_record->io_start_tick = checkpoint_process->io_start_tick;
+    process_record->io_duration_ticks = checkpoint_process->configured_io_duration;
+    process_record->remaining_io_ticks = checkpoint_process->remaining_io_ticks;
+    process_record->executed_cpu_time = checkpoint_process->executed_cpu_time;
+    process_record->completion_tick = checkpoint_process->completion_tick;
+    process_record->configured_io_duration = checkpoint_process->configured_io_duration;
+    process_record->terminated_by_kill = checkpoint_process->terminated_by_kill;
+    process_record->killed_at_tick = checkpoint_process->killed_at_tick;
+    process_record->dispatched_at_tick = checkpoint_process->dispatched_at_tick;
+    process_record->io_entered_tick = checkpoint_process->io_entered_tick;
+    process_record->io_completion_tick = checkpoint_process->io_completion_tick;
+    process_record->heap_index = -1;
+    process_record->dispatch_count = checkpoint_process->dispatch_count;
+    process_record->dispatch_sequence = checkpoint_process->dispatch_sequence;
+    process_record->arrival_tick = checkpoint_process->arrival_tick;
+    process_record->ready_sequence = checkpoint_process->ready_sequence;
+    process_record->scheduling_priority = checkpoint_process->scheduling_priority;
+    process_record->queue_level = checkpoint_process->queue_level;
+    process_record->level_ticks_used = checkpoint_process->level_ticks_used;
+    process_record->virtual_runtime = checkpoint_process->virtual_runtime;
+    process_record->timeline_level = checkpoint_process->timeline_level;
+    process_record->cpu_index = checkpoint_process->cpu_index;
+    process_record->migration_count = checkpoint_process->migration_count;
+    process_record->execution_state = (ProcessExecutionState)checkpoint_process->execution_state;
+    process_record->next_process = NULL;
+    process_record->previous_process = NULL;
+    process_record->owning_queue = NULL;
+    process_record->timeline_forward = NULL;
+}
+
+/* Written next to the target and renamed over it, so an interrupted save never replaces a good checkpoint. */
+bool save_checkpoint(SimulationContext *simulation, const char *checkpoint_file_path)
+{
+    size_t path_length = strlen(checkpoint_file_path);
+    char *temporary_path = (char *)malloc(path_length + 5);
+    if (temporary_path == NULL) {
+        printf("Memory allocation failed!!!");
+        return false;
+    }
+    memcpy(temporary_path, checkpoint_file_path, path_length);
+    memcpy(temporary_path + path_length, ".tmp", 5);
+
+    FILE *checkpoint_file = fopen(temporary_path, "wb");
+    if (checkpoint_file == NULL)
+    {
+        printf("Could not open '%s' for writing.\n", temporary_path);
+        free(temporary_path);
+        return false;
+    }
+
+    CheckpointHeader checkpoint_header;
+    memset(&checkpoint_header, 0, sizeof(checkpoint_header));
+    checkpoint_header.policy_index = (int)(simulation->selected_policy - scheduling_policies);
+    checkpoint_header.time_quantum = simulation->time_quantum;
+    checkpoint_header.simulated_cpu_count = simulation->simulated_cpu_count;
+    checkpoint_header.io_duration_percent = simulation->io_duration_percent;
+    checkpoint_header.registered_process_count = registered_process_count;
+    checkpoint_header.total_process_count = total_process_count;
+    checkpoint_header.kill_event_count = kill_event_count;
+    checkpoint_header.next_kill_event_index = simulation->next_kill_event_index;
+    checkpoint_header.terminated_count = simulation->terminated_count;
+    checkpoint_header.next_initial_cpu = simulation->next_initial_cpu;
+    checkpoint_header.ready_process_count = simulation->ready_process_count;
+    checkpoint_header.event_count = simulation->event_heap.event_count;
+    checkpoint_header.current_tick = simulation->current_tick;
+    checkpoint_header.next_dispatch_sequence = simulation->next_dispatch_sequence;
+    checkpoint_header.next_ready_sequence = simulation->next_ready_sequence;
+    checkpoint_header.scheduler_event_count = simulation->scheduler_event_count;
+    checkpoint_header.timeline_random_state = simulation->timeline_random_state;
+    fwrite(CHECKPOINT_MAGIC, 1, CHECKPOINT_MAGIC_LEN, checkpoint_file);
+    fwrite(&checkpoint_header, sizeof(checkpoint_header), 1, checkpoint_file);
+
+    for (int cpu_index = 0; cpu_index < simulation->simulated_cpu_count; cpu_index++)
+    {
+        SimulatedCpu *cpu = &simulation->simulated_cpus[cpu_index];
+        CheckpointCpu checkpoint_cpu;
+        memset(&checkpoint_cpu, 0, sizeof(checkpoint_cpu));
+        checkpoint_cpu.busy_ticks = cpu->busy_ticks;
+        checkpoint_cpu.timeline_weight = cpu->run_queue.timeline_weight;
+        checkpoint_cpu.minimum_virtual_runtime = cpu->run_queue.minimum_virtual_runtime;
+        checkpoint_cpu.running_index = cpu->running_process ? cpu->running_process->registry_index : -1;
+        checkpoint_cpu.ready_count = cpu->run_queue.ready_count;
+        checkpoint_cpu.migrations_in = cpu->migrations_in;
+        checkpoint_cpu.migrations_out = cpu->migrations_out;
+        fwrite(&checkpoint_cpu, sizeof(checkpoint_cpu), 1, checkpoint_file);
+    }
+
+    for (int event_index = 0; event_index < simulation->event_heap.event_count; event_index++)
+    {
+        const SchedulerEvent *scheduler_event = &simulation->event_heap.heap_events[event_index];
+        CheckpointEvent checkpoint_event;
+        memset(&checkpoint_event, 0, sizeof(checkpoint_event));
+        checkpoint_event.event_tick = scheduler_event->event_tick;
+        checkpoint_event.event_sequence = scheduler_event->event_sequence;
+        checkpoint_event.event_cpu = scheduler_event->event_cpu;
+        checkpoint_event.event_index = scheduler_event->event_process->registry_index;
+        fwrite(&checkpoint_event, sizeof(checkpoint_event), 1, checkpoint_file);
+    }
+
+    for (int registry_index = 0; registry_index < registered_process_count; registry_index++)
+    {
+        CheckpointProcess checkpoint_process;
+        pack_checkpoint_process(simulation_process_at(simulation, registry_index), &checkpoint_process);
+        fwrite(&checkpoint_process, sizeof(checkpoint_process), 1, checkpoint_file);
+    }
+
+    for (int cpu_index = 0; cpu_index < simulation->simulated_cpu_count; cpu_index++)
+    {
+        RunQueue *run_queue = &simulation->simulated_cpus[cpu_index].run_queue;
+        write_checkpoint_queue(checkpoint_file, &run_queue->fifo_queue);
+        for (int queue_level = 0; queue_level < MLFQ_LEVEL_COUNT; queue_level++)
+        {
+            write_checkpoint_queue(checkpoint_file, &run_queue->multilevel_queues[queue_level]);
+        }
+        write_checkpoint_heap(checkpoint_file, &run_queue->ready_heap);
+        write_checkpoint_timeline(checkpoint_file, run_queue);
+    }
+    write_checkpoint_heap(checkpoint_file, &simulation->waiting_heap);
+    write_checkpoint_heap(checkpoint_file, &simulation->arrival_heap);
+    write_checkpoint_queue(checkpoint_file, &simulation->finished_queue);
+
+    fwrite(kill_event_list, sizeof(KillEventRecord), kill_event_count, checkpoint_file);
+    for (int registry_index = 0; registry_index < registered_process_count; registry_index++)
+    {
+        const char *process_name = simulation_process_at(simulation, registry_index)->process_name;
+        fwrite(process_name, 1, strlen(process_name), checkpoint_file);
+    }
+
+    bool written = !ferror(checkpoint_file);
+    written = (fclose(checkpoint_file) == 0) && written;
+    if (written && rename(temporary_path, checkpoint_file_path) != 0)
+    {
+        written = false;
+    }
+    if (!written)
+    {
+        printf("Could not write the checkpoint '%s'.\n", checkpoint_file_path);
+        remove(temporary_path);
+    }
+    free(temporary_path);
+    return written;
+}
+
+/* Each list is a count followed by that many registry indices. */
+bool validate_checkpoint_lists(const int *list_cursor, const int *lists_end, int list_count, int process_count)
+{
+    for (int list_index = 0; list_index < list_count; list_index++)
+    {
+        if (list_cursor >= lists_end || *list_cursor < 0 || *list_cursor > lists_end - list_cursor - 1)
+        {
+            return false;
+        }
+        int list_length = *list_cursor++;
+        for (int entry_index = 0; entry_index < list_length; entry_index++)
+        {
+            if (list_cursor[entry_index] < 0 || list_cursor[entry_index] >= process_count)
+            {
+                return false;
+            }
+        }
+        list_cursor += list_length;
+    }
+    return list_cursor == lists_end;
+}
+
+bool validate_checkpoint_process(const CheckpointProcess *checkpoint_process, int simulated_cpu_count)
+{
+    return checkpoint_process->execution_state <= STATE_TERMINATED && checkpoint_process->cpu_index >= 0 &&
+           checkpoint_process->cpu_index < simulated_cpu_count && checkpoint_process->queue_level < MLFQ_LEVEL_COUNT &&
+           checkpoint_process->timeline_level <= CFS_TIMELINE_LEVELS && checkpoint_process->name_length < MAX_PROCESS_NAME_LEN;
+}
+
+/* Loads the PCBs, PID table and kill list of a checkpoint as the current trace; the queues are rebuilt per run. */
+CheckpointImage *load_checkpoint(const char *checkpoint_file_path)
+{
+    FILE *checkpoint_file = fopen(checkpoint_file_path, "rb");
+    if (checkpoint_file == NULL)
+    {
+        printf("Could not open '%s'.\n", checkpoint_file_path);
+        return NULL;
+    }
+
+    struct stat file_status;
+    if (fstat(fileno(checkpoint_file), &file_status) != 0)
+    {
+        printf("Could not read '%s'.\n", checkpoint_file_path);
+        fclose(checkpoint_file);
+        return NULL;
+    }
+
+    size_t image_size = (size_t)file_status.st_size;
+    CheckpointImage *checkpoint_image = (CheckpointImage *)calloc(1, sizeof(CheckpointImage));
+    char *image_buffer = (char *)malloc(image_size > 0 ? image_size : 1);
+    if (checkpoint_image == NULL || image_buffer == NULL) {
+        printf("Memory allocation failed!!!");
+        free(checkpoint_image);
+        free(image_buffer);
+        fclose(checkpoint_file);
+        return NULL;
+    }
+    checkpoint_image->image_buffer = image_buffer;
+    bool image_read = fread(image_buffer, 1, image_size, checkpoint_file) == image_size;
+    fclose(checkpoint_file);
+
+    size_t image_offset = CHECKPOINT_MAGIC_LEN + sizeof(CheckpointHeader);
+    const CheckpointHeader *checkpoint_header = (const CheckpointHeader *)(image_buffer + CHECKPOINT_MAGIC_LEN);
+    bool image_valid = image_read && image_size >= image_offset && memcmp(image_buffer, CHECKPOINT_MAGIC, CHECKPOINT_MAGIC_LEN) == 0;
+
+    image_valid = image_valid && checkpoint_header->policy_index >= 0 &&
+                  checkpoint_header->policy_index < (int)(sizeof(scheduling_policies) / sizeof(scheduling_policies[0])) &&
+                  checkpoint_header->simulated_cpu_count >= 1 && checkpoint_header->simulated_cpu_count <= MAX_SIMULATED_CPUS &&
+                  checkpoint_header->time_quantum >= 1 && checkpoint_header->io_duration_percent >= 0 &&
+                  checkpoint_header->registered_process_count >= 0 && checkpoint_header->event_count >= 0 &&
+                  checkpoint_header->total_process_count == checkpoint_header->registered_process_count &&
+                  checkpoint_header->kill_event_count >= 0 && checkpoint_header->next_kill_event_index >= 0 &&
+                  checkpoint_header->next_kill_event_index <= checkpoint_header->kill_event_count;
+
+    size_t fixed_size = image_offset + (image_valid ? (size_t)checkpoint_header->simulated_cpu_count * sizeof(CheckpointCpu) +
+                                                          (size_t)checkpoint_header->event_count * sizeof(CheckpointEvent) +
+                                                          (size_t)checkpoint_header->registered_process_count * sizeof(CheckpointProcess) : 0);
+    image_valid = image_valid && fixed_size <= image_size;
+
+    const CheckpointProcess *checkpoint_processes = NULL;
+    size_t name_bytes = 0;
+    if (image_valid)
+    {
+        checkpoint_image->checkpoint_header = checkpoint_header;
+        checkpoint_image->checkpoint_cpus = (const CheckpointCpu *)(image_buffer + image_offset);
+        image_offset += checkpoint_header->simulated_cpu_count * sizeof(CheckpointCpu);
+        checkpoint_image->checkpoint_events = (const CheckpointEvent *)(image_buffer + image_offset);
+        image_offset += checkpoint_header->event_count * sizeof(CheckpointEvent);
+        checkpoint_processes = (const CheckpointProcess *)(image_buffer + image_offset);
+        image_offset += checkpoint_header->registered_process_count * sizeof(CheckpointProcess);
+
+        for (int cpu_index = 0; cpu_index < checkpoint_header->simulated_cpu_count && image_valid; cpu_index++)
+        {
+            int running_index = checkpoint_image->checkpoint_cpus[cpu_index].running_index;
+            image_valid = running_index >= -1 && running_index < checkpoint_header->registered_process_count;
+        }
+        for (int event_index = 0; event_index < checkpoint_header->event_count && image_valid; event_index++)
+        {
+            const CheckpointEvent *checkpoint_event = &checkpoint_image->checkpoint_events[event_index];
+            image_valid = checkpoint_event->event_cpu >= 0 && checkpoint_event->event_cpu < checkpoint_header->simulated_cpu_count &&
+                          checkpoint_event->event_index >= 0 && checkpoint_event->event_index < checkpoint_header->registered_process_count;
+        }
+        for (int registry_index = 0; registry_index < checkpoint_header->registered_process_count && image_valid; registry_index++)
+        {
+            image_valid = validate_checkpoint_process(&checkpoint_processes[registry_index], checkpoint_header->simulated_cpu_count);
+            name_bytes += checkpoint_processes[registry_index].name_length;
+        }
+    }
+
+    size_t tail_size = image_valid ? (size_t)checkpoint_header->kill_event_count * sizeof(KillEventRecord) + name_bytes : 0;
+    image_valid = image_valid && image_size - image_offset >= tail_size && (image_size - image_offset - tail_size) % sizeof(int) == 0;
+    if (image_valid)
+    {
+        checkpoint_image->structure_lists = (const int *)(image_buffer + image_offset);
+        checkpoint_image->structure_lists_end = (const int *)(image_buffer + image_size - tail_size);
+        image_valid = validate_checkpoint_lists(checkpoint_image->structure_lists, checkpoint_image->structure_lists_end,
+                                                checkpoint_header->simulated_cpu_count * (MLFQ_LEVEL_COUNT + 3) + 3,
+                                                checkpoint_header->registered_process_count);
+        for (int kill_index = 0; kill_index < checkpoint_header->kill_event_count && image_valid; kill_index++)
+        {
+            KillEventRecord kill_event;
+            memcpy(&kill_event, (const char *)checkpoint_image->structure_lists_end + kill_index * sizeof(KillEventRecord), sizeof(kill_event));
+            image_valid = kill_event.kill_time >= 0 && kill_event.kill_time <= INT_MAX;
+        }
+    }
+    if (!image_valid)
+    {
+        printf("'%s' is not a valid checkpoint.\n", checkpoint_file_path);
+        destroy_checkpoint_image(checkpoint_image);
+        return NULL;
+    }
+
+    const char *process_name = image_buffer + image_size - name_bytes;
+    for (int registry_index = 0; registry_index < checkpoint_header->registered_process_count; registry_index++)
+    {
+        ProcessIndexSlot *process_slot;
+        if (!claim_process_slot(checkpoint_processes[registry_index].process_id, &process_slot) || process_slot == NULL)
+        {
+            printf("'%s' is not a valid checkpoint.\n", checkpoint_file_path);
+            destroy_checkpoint_image(checkpoint_image);
+            return NULL;
+        }
+        ProcessControlRecord *process_record = allocate_process_record();
+        if (process_record == NULL) {
+            destroy_checkpoint_image(checkpoint_image);
+            return NULL;
+        }
+        unpack_checkpoint_process(&checkpoint_processes[registry_index], process_name, process_record);
+        process_name += checkpoint_processes[registry_index].name_length;
+        process_slot->process_record = process_record;
+    }
+    total_process_count = checkpoint_header->total_process_count;
+
+    if (checkpoint_header->kill_event_count > 0)
+    {
+        kill_event_list = (KillEventRecord *)malloc(checkpoint_header->kill_event_count * sizeof(KillEventRecord));
+        if (kill_event_list == NULL) {
+            printf("Memory allocation failed!!!");
+            destroy_checkpoint_image(checkpoint_image);
+            return NULL;
+        }
+        memcpy(kill_event_list, checkpoint_image->structure_lists_end, checkpoint_header->kill_event_count * sizeof(KillEventRecord));
+        kill_event_count = kill_event_capacity = checkpoint_header->kill_event_count;
+    }
+    return checkpoint_image;
+}
+
+void destroy_checkpoint_image(CheckpointImage *checkpoint_image)
+{
+    free(checkpoint_image->image_buffer);
+    free(checkpoint_image);
+}
+
+void restore_checkpoint_queue(SimulationContext *simulation, ProcessLinkedQueue *queue, const int **list_cursor)
+{
+    int list_length = *(*list_cursor)++;
+
+    init_queue(queue);
+    for (int entry_index = 0; entry_index < list_length; entry_index++)
+    {
+        enqueue(queue, simulation_process_at(simulation, (*list_cursor)[entry_index]));
+    }
+    *list_cursor += list_length;
+}
+
+/* A saved heap array is already in heap order, so pushing it back in order places every process where it was. */
+bool restore_checkpoint_heap(SimulationContext *simulation, ProcessHeap *process_heap, const int **list_cursor)
+{
+    int list_length = *(*list_cursor)++;
+
+    for (int entry_index = 0; entry_index < list_length; entry_index++)
+    {
+        if (!push_heap_process(process_heap, simulation_process_at(simulation, (*list_cursor)[entry_index])))
+        {
+            return false;
+        }
+    }
+    *list_cursor += list_length;
+    return true;
+}
+
+void restore_checkpoint_timeline(SimulationContext *simulation, RunQueue *run_queue, const int **list_cursor)
+{
+    int list_length = *(*list_cursor)++;
+
+    for (int level = 0; level < CFS_TIMELINE_LEVELS; level++)
+    {
+        ProcessControlRecord **level_link = &run_queue->timeline_head[level];
+        for (int entry_index = 0; entry_index < list_length; entry_index++)
+        {
+            ProcessControlRecord *process_record = simulation_process_at(simulation, (*list_cursor)[entry_index]);
+            if (process_record->timeline_level > level)
+            {
+                *level_link = process_record;
+                level_link = &process_record->timeline_forward[level];
+            }
+        }
+        *level_link = NULL;
+    }
+    *list_cursor += list_length;
+}
+
+/* Relinks every structure in its saved order without calling the policy hooks, so the resumed run makes the same
+   decisions the original would have made from that tick on. */
+bool restore_checkpoint(SimulationContext *simulation, const CheckpointImage *checkpoint_image)
+{
+    const CheckpointHeader *checkpoint_header = checkpoint_image->checkpoint_header;
+    const int *list_cursor = checkpoint_image->structure_lists;
+
+    simulation->current_tick = checkpoint_header->current_tick;
+    simulation->terminated_count = checkpoint_header->terminated_count;
+    simulation->next_initial_cpu = checkpoint_header->next_initial_cpu;
+    simulation->next_dispatch_sequence = checkpoint_header->next_dispatch_sequence;
+    simulation->next_kill_event_index = checkpoint_header->next_kill_event_index;
+    simulation->ready_process_count = checkpoint_header->ready_process_count;
+    simulation->next_ready_sequence = checkpoint_header->next_ready_sequence;
+    simulation->timeline_random_state = checkpoint_header->timeline_random_state;
+    simulation->scheduler_event_count = checkpoint_header->scheduler_event_count;
+
+    for (int registry_index = 0; registry_index < registered_process_count; registry_index++)
+    {
+        ProcessControlRecord *process_record = simulation_process_at(simulation, registry_index);
+        if (process_record->timeline_level > 0)
+        {
+            process_record->timeline_forward = allocate_timeline_links(simulation, process_record->timeline_level);
+            if (process_record->timeline_forward == NULL)
+            {
+                return false;
+            }
+        }
+    }
+
+    for (int cpu_index = 0; cpu_index < simulation->simulated_cpu_count; cpu_index++)
+    {
+        const CheckpointCpu *checkpoint_cpu = &checkpoint_image->checkpoint_cpus[cpu_index];
+        SimulatedCpu *cpu = &simulation->simulated_cpus[cpu_index];
+        RunQueue *run_queue = &cpu->run_queue;
+
+        init_run_queue(simulation, run_queue);
+        cpu->running_process = (checkpoint_cpu->running_index >= 0) ? simulation_process_at(simulation, checkpoint_cpu->running_index) : NULL;
+        cpu->busy_ticks = checkpoint_cpu->busy_ticks;
+        cpu->migrations_in = checkpoint_cpu->migrations_in;
+        cpu->migrations_out = checkpoint_cpu->migrations_out;
+        run_queue->timeline_weight = checkpoint_cpu->timeline_weight;
+        run_queue->minimum_virtual_runtime = checkpoint_cpu->minimum_virtual_runtime;
+        run_queue->ready_count = checkpoint_cpu->ready_count;
+
+        restore_checkpoint_queue(simulation, &run_queue->fifo_queue, &list_cursor);
+        for (int queue_level = 0; queue_level < MLFQ_LEVEL_COUNT; queue_level++)
+        {
+            restore_checkpoint_queue(simulation, &run_queue->multilevel_queues[queue_level], &list_cursor);
+        }
+        if (!restore_checkpoint_heap(simulation, &run_queue->ready_heap, &list_cursor))
+        {
+            return false;
+        }
+        restore_checkpoint_timeline(simulation, run_queue, &list_cursor);
+    }
+    if (!restore_checkpoint_heap(simulation, &simulation->waiting_heap, &list_cursor) ||
+        !restore_checkpoint_heap(simulation, &simulation->arrival_heap, &list_cursor))
+    {
+        return false;
+    }
+    restore_checkpoint_queue(simulation, &simulation->finished_queue, &list_cursor);
+
+    for (int event_index = 0; event_index < checkpoint_header->event_count; event_index++)
+    {
+        const CheckpointEvent *checkpoint_event = &checkpoint_image->checkpoint_events[event_index];
+        SchedulerEvent scheduler_event;
+        memset(&scheduler_event, 0, sizeof(scheduler_event));
+        scheduler_event.event_tick = checkpoint_event->event_tick;
+        scheduler_event.event_cpu = checkpoint_event->event_cpu;
+        scheduler_event.event_sequence = checkpoint_event->event_sequence;
+        scheduler_event.event_process = simulation_process_at(simulation, checkpoint_event->event_index);
+        if (!push_scheduler_event(&simulation->event_heap, scheduler_event))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* The policy and CPU count come from the checkpoint; the quantum and I/O scaling apply from the next dispatch and
+   the next I/O burst on, which is what lets one checkpoint branch into several what-if continuations. */
+SimulationContext *resume_simulation_context(const SimulationSettings *run_settings, const CheckpointImage *checkpoint_image, bool copy_processes)
+{
+    SimulationContext *simulation = create_simulation_context(run_settings, copy_processes);
+
+    if (simulation && !restore_checkpoint(simulation, checkpoint_image))
+    {
+        destroy_simulation_context(simulation);
+        return NULL;
+    }
+    return simulation;
+}
+
+/* Saves at every multiple of checkpoint_interval the run reaches, until it finishes or nothing can change anymore. */
+void run_checkpointed_scheduler(SimulationContext *simulation)
+{
+    bool checkpointing = checkpoint_path != NULL;
+
+    while (checkpointing && simulation->terminated_count < total_process_count)
+    {
+        advance_scheduler(simulation, (simulation->current_tick / checkpoint_interval + 1) * checkpoint_interval);
+        if (simulation->terminated_count == total_process_count ||
+            (!(simulation->ready_process_count > 0 && any_cpu_idle(simulation)) && !scheduler_has_pending_events(simulation)))
+        {
+            break;
+        }
+        checkpointing = save_checkpoint(simulation, checkpoint_path);
+    }
+    advance_scheduler(simulation, LLONG_MAX);
+}
+
+bool resume_from_checkpoint()
+{
+    CheckpointImage *checkpoint_image = load_checkpoint(resume_path);
+    if (checkpoint_image == NULL)
+    {
+        reset_loaded_trace();
+        return false;
+    }
+
+    const CheckpointHeader *checkpoint_header = checkpoint_image->checkpoint_header;
+    if ((policy_axis.value_count > 0 && (policy_axis.value_count > 1 || policy_axis.axis_values[0] != checkpoint_header->policy_index)) ||
+        (cpu_axis.value_count > 0 && (cpu_axis.value_count > 1 || cpu_axis.axis_values[0] != checkpoint_header->simulated_cpu_count)))
+    {
+        printf("The checkpoint was taken with --policy %s --cpus %d; a resumed run can only change --quantum and --io-percent.\n",
+               scheduling_policies[checkpoint_header->policy_index].policy_name, checkpoint_header->simulated_cpu_count);
+        destroy_checkpoint_image(checkpoint_image);
+        reset_loaded_trace();
+        return false;
+    }
+    set_default_axis_value(&policy_axis, checkpoint_header->policy_index);
+    set_default_axis_value(&quantum_axis, checkpoint_header->time_quantum);
+    set_default_axis_value(&cpu_axis, checkpoint_header->simulated_cpu_count);
+    set_default_axis_value(&io_percent_axis, checkpoint_header->io_duration_percent);
+    fprintf(stderr, "Resuming at tick %lld with %d of %d processes finished\n", checkpoint_header->current_tick,
+            checkpoint_header->terminated_count, checkpoint_header->total_process_count);
+
+    bool resumed = true;
+    if (sweep_csv_path)
+    {
+        resumed = run_parameter_sweep(checkpoint_image);
+    }
+    else
+    {
+        SimulationSettings run_settings = {&scheduling_policies[policy_axis.axis_values[0]], quantum_axis.axis_values[0],
+                                           cpu_axis.axis_values[0], io_percent_axis.axis_values[0]};
+        SimulationContext *simulation = resume_simulation_context(&run_settings, checkpoint_image, false);
+        resumed = simulation != NULL;
+        if (simulation && event_log_path && !open_scheduler_log(simulation, event_log_path))
+        {
+            resumed = false;
+        }
+        if (resumed)
+        {
+            run_checkpointed_scheduler(simulation);
+            close_scheduler_log(simulation);
+            print_result_table(simulation);
+        }
+        if (simulation)
+        {
+            destroy_simulation_context(simulation);
+        }
+    }
+    destroy_checkpoint_image(checkpoint_image);
+    cleanup_all_memory();
+    return resumed;
+}
+
+/* Policy names are resolved to indices; numbers must be plain digits within [minimum_value, maximum_value]. */
+bool parse_sweep_axis(const char *axis_text, SweepAxis *axis, bool policy_names, int minimum_value, int maximum_value)
+{
+    char value_text[MAX_PROCESS_NAME_LEN];
+
+    axis->value_count = 0;
+    while (true)
+    {
+        const char *separator = strchr(axis_text, ',');
+        size_t value_length = separator ? (size_t)(separator - axis_text) : strlen(axis_text);
+
+        if (value_length >= sizeof(value_text) || axis->value_count == MAX_SWEEP_VALUES)
+        {
+            return false;
+        }
+        memcpy(value_text, axis_text, value_length);
+        value_text[value_length] = '\0';
+
+        if (policy_names)
+        {
+            const SchedulingPolicy *policy = find_scheduling_policy(value_text);
+            if (policy == NULL)
+            {
+                printf("Unknown scheduling policy '%s'.\n", value_text);
+                return false;
+            }
+            axis->axis_values[axis->value_count++] = (int)(policy - scheduling_policies);
+        }
+        else
+        {
+            if (value_length >= MAX_INT_STR_LEN || !is_valid_integer_string(value_text) ||
+                atoi(value_text) < minimum_value || atoi(value_text) > maximum_value)
+            {
+                return false;
+            }
+            axis->axis_values[axis->value_count++] = atoi(value_text);
+        }
+
+        if (separator == NULL)
+        {
+            return true;
+        }
+        axis_text = separator + 1;
+    }
+}
+
+void set_single_axis_value(SweepAxis *axis, int axis_value)
+{
+    axis->axis_values[0] = axis_value;
+    axis->value_count = 1;
+}
+
+void set_default_axis_value(SweepAxis *axis, int axis_value)
+{
+    if (axis->value_count == 0)
+    {
+        set_single_axis_value(axis, axis_value);
+    }
+}
+
+/* Scheduling options left unset take their defaults here, or the checkpoint's values when resuming. */
+bool parse_command_line(int argc, char *argv[])
+{
+    for (int argument_index = 1; argument_index < argc; argument_index++)
+    {
+        if (strcmp(argv[argument_index], "--policy") == 0 && argument_index + 1 < argc)
+        {
+            if (!parse_sweep_axis(argv[++argument_index], &policy_axis, true, 0, 0))
+            {
+                return false;
+            }
+        }
+        else if (strcmp(argv[argument_index], "--cpus") == 0 && argument_index + 1 < argc &&
+                 parse_sweep_axis(argv[argument_index + 1], &cpu_axis, false, 1, MAX_SIMULATED_CPUS))
+        {
+            argument_index++;
+        }
+        else if (strcmp(argv[argument_index], "--quantum") == 0 && argument_index + 1 < argc &&
+                 parse_sweep_axis(argv[argument_index + 1], &quantum_axis, false, 1, INT_MAX))
+        {
+            argument_index++;
+        }
+        else if (strcmp(argv[argument_index], "--io-percent") == 0 && argument_index + 1 < argc &&
+                 parse_sweep_axis(argv[argument_index + 1], &io_percent_axis, false, 0, MAX_SWEEP_IO_PERCENT))
+        {
+            argument_index++;
+        }
+        else if (strcmp(argv[argument_index], "--event-log") == 0 && argument_index + 1 < argc)
+        {
+            event_log_path = argv[++argument_index];
+        }
+        else if (strcmp(argv[argument_index], "--convert-log") == 0 && argument_index + 3 < argc)
+        {
+            convert_log_path = argv[++argument_index];
+            convert_csv_path = argv[++argument_index];
+            convert_trace_path = argv[++argument_index];
+        }
+        else if (strcmp(argv[argument_index], "--generate") == 0 && argument_index + 2 < argc)
+        {
+            generate_workload = find_workload_profile(argv[argument_index + 1]);
+            if (generate_workload == NULL)
+            {
+                printf("Unknown workload '%s'.\n", argv[argument_index + 1]);
+                return false;
+            }
+            if (!is_valid_integer_string(argv[argument_index + 2]) || strlen(argv[argument_index + 2]) >= MAX_INT_STR_LEN ||
+                atoi(argv[argument_index + 2]) < 1 || atoi(argv[argument_index + 2]) > MAX_WORKLOAD_PROCESSES)
+            {
+                printf("The process count must be between 1 and %d.\n", MAX_WORKLOAD_PROCESSES);
+                return false;
+            }
+            generate_process_count = atoi(argv[argument_index + 2]);
+            argument_index += 2;
+        }
+        else if (strcmp(argv[argument_index], "--benchmark") == 0 && argument_index + 1 < argc &&
+                 is_valid_integer_string(argv[argument_index + 1]) && strlen(argv[argument_index + 1]) < MAX_INT_STR_LEN &&
+                 atoi(argv[argument_index + 1]) >= 1 && atoi(argv[argument_index + 1]) <= MAX_WORKLOAD_PROCESSES)
+        {
+            benchmark_process_count = atoi(argv[++argument_index]);
+        }
+        else if (strcmp(argv[argument_index], "--seed") == 0 && argument_index + 1 < argc &&
+                 is_valid_integer_string(argv[argument_index + 1]) && strlen(argv[argument_index + 1]) < MAX_INT_STR_LEN)
+        {
+            workload_seed = strtoull(argv[++argument_index], NULL, 10);
+        }
+        else if (strcmp(argv[argument_index], "--online") == 0)
+        {
+            online_mode = true;
+        }
+        else if (strcmp(argv[argument_index], "--checkpoint-every") == 0 && argument_index + 2 < argc &&
+                 is_valid_integer_string(argv[argument_index + 1]) && strlen(argv[argument_index + 1]) < MAX_INT_STR_LEN &&
+                 atoi(argv[argument_index + 1]) >= 1)
+        {
+            checkpoint_interval = atoi(argv[++argument_index]);
+            checkpoint_path = argv[++argument_index];
+        }
+        else if (strcmp(argv[argument_index], "--resume") == 0 && argument_index + 1 < argc)
+        {
+            resume_path = argv[++argument_index];
+        }
+        else if (strcmp(argv[argument_index], "--sweep") == 0 && argument_index + 1 < argc)
+        {
+            sweep_csv_path = argv[++argument_index];
+        }
+        else if (strcmp(argv[argument_index], "--threads") == 0 && argument_index + 1 < argc &&
+                 is_valid_integer_string(argv[argument_index + 1]) &&
+                 atoi(argv[argument_index + 1]) > 0 && atoi(argv[argument_index + 1]) <= MAX_SWEEP_THREADS)
+        {
+            sweep_thread_count = atoi(argv[++argument_index]);
+        }
+        else
+        {
+            printf("Usage: %s [--policy fcfs|sjf|srtf|rr|priority|mlfq|cfs] [--quantum <ticks>] [--cpus <1-%d>] [--io-percent <percent>] [--event-log <file>]\n", argv[0], MAX_SIMULATED_CPUS);
+            printf("       %s --sweep <results.csv> [--threads <n>] with comma-separated lists for the scheduling options above\n", argv[0]);
+            printf("       %s --convert-log <events.log> <events.csv> <trace.json>\n", argv[0]);
+            printf("       %s --online [scheduling options] reads a time-ordered process and KILL stream until end of input\n", argv[0]);
+            printf("       %s --generate uniform|exponential|heavy-io|kill-storm|arrival-burst|mixed <processes> [--seed <n>]\n", argv[0]);
+            printf("       %s --benchmark <processes> [--seed <n>] [scheduling options]\n", argv[0]);
+            printf("       %s [scheduling options] --checkpoint-every <ticks> <checkpoint> saves the run state periodically\n", argv[0]);
+            printf("       %s --resume <checkpoint> [--quantum <ticks>] [--io-percent <percent>] [--checkpoint-every <ticks> <checkpoint>]\n", argv[0]);
+            printf("       %s --resume <checkpoint> --sweep <results.csv> [--threads <n>] branches one checkpoint into several runs\n", argv[0]);
+            printf("An optional sixth column sets the priority (0-39, lower runs first, default %d; cfs reads it as nice + 20).\n", DEFAULT_PROCESS_PRIORITY);
+            printf("An optional seventh column sets the arrival tick (default 0).\n");
+            printf("Text after the last numeric column is ignored.\n");
+            return false;
+        }
+    }
+
+    if (sweep_csv_path == NULL &&
+        (policy_axis.value_count > 1 || quantum_axis.value_count > 1 || cpu_axis.value_count > 1 || io_percent_axis.value_count > 1))
+    {
+        printf("Lists of values are only accepted together with --sweep <results.csv>.\n");
+        return false;
+    }
+
+    if (sweep_csv_path && event_log_path)
+    {
+        printf("--event-log records a single run and cannot be combined with --sweep.\n");
+        return false;
+    }
+
+    if (online_mode && (sweep_csv_path || benchmark_process_count > 0 || generate_workload))
+    {
+        printf("--online runs a single simulation and cannot be combined with --sweep, --benchmark or --generate.\n");
+        return false;
+    }
+
+    if (benchmark_process_count > 0 && (sweep_csv_path || event_log_path || generate_workload))
+    {
+        printf("--benchmark runs on its own and cannot be combined with --sweep, --event-log or --generate.\n");
+        return false;
+    }
+
+    if (checkpoint_path && (sweep_csv_path || online_mode || benchmark_process_count > 0 || generate_workload))
+    {
+        printf("--checkpoint-every saves a single run and cannot be combined with --sweep, --online, --benchmark or --generate.\n");
+        return false;
+    }
+
+    if (resume_path && (online_mode || benchmark_process_count > 0 || generate_workload))
+    {
+        printf("--resume cannot be combined with --online, --benchmark or --generate.\n");
+        return false;
+    }
+
+    if (resume_path == NULL)
+    {
+        set_default_axis_value(&policy_axis, 0);
+        set_default_axis_value(&quantum_axis, DEFAULT_TIME_QUANTUM);
+        set_default_axis_value(&cpu_axis, 1);
+        set_default_axis_value(&io_percent_axis, 100);
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    if (!parse_command_line(argc, argv))
+    {
+        return 1;
+    }
+
+    if (convert_log_path)
+    {
+        return convert_scheduler_log(convert_log_path, convert_csv_path, convert_trace_path) ? 0 : 1;
+    }
+
+    if (generate_workload)
+    {
+        write_workload_trace(stdout, generate_workload, generate_process_count, workload_seed);
+        return 0;
+    }
+
+    if (benchmark_process_count > 0)
+    {
+        SimulationSettings benchmark_settings = {&scheduling_policies[policy_axis.axis_values[0]], quantum_axis.axis_values[0],
+                                                 cpu_axis.axis_values[0], io_percent_axis.axis_values[0]};
+        return run_workload_benchmark(&benchmark_settings) ? 0 : 1;
+    }
+
+    if (resume_path)
+    {
+        return resume_from_checkpoint() ? 0 : 1;
+    }
+
+    if (online_mode)
+    {
+        SimulationSettings online_settings = {&scheduling_policies[policy_axis.axis_values[0]], quantum_axis.axis_values[0],
+                                              cpu_axis.axis_values[0], io_percent_axis.axis_values[0]};
+        SimulationContext *simulation = create_simulation_context(&online_settings, false);
+        if (simulation == NULL)
+        {
+            return 1;
+        }
+        if (event_log_path && !open_scheduler_log(simulation, event_log_path))
+        {
+            destroy_simulation_context(simulation);
+            return 1;
+        }
+        run_online_simulation(simulation);
+        destroy_simulation_context(simulation);
+        cleanup_all_memory();
+        return 0;
+    }
+
+    printf("Enter the input in the given format :\n");
+    printf("<process_name>  <process_id>  <cpu_burst_time>  <io_start_time>  <io_duration_time>\n\n");
+
+    struct timespec load_started;
+    struct timespec load_finished;
+
+    clock_gettime(CLOCK_MONOTONIC, &load_started);
+    size_t trace_bytes = load_trace_input();
+    clock_gettime(CLOCK_MONOTONIC, &load_finished);
+    report_load_throughput(trace_bytes, &load_started, &load_finished);
+
+    if (total_process_count == 0)
+    {
+        printf("No valid processes entered.\n");
+        return 0;
+    }
+
+    sort_kill_events();
+
+    if (sweep_csv_path)
+    {
+        bool sweep_written = run_parameter_sweep(NULL);
+        cleanup_all_memory();
+        return sweep_written ? 0 : 1;
+    }
+
+    SimulationSettings run_settings = {&scheduling_policies[policy_axis.axis_values[0]], quantum_axis.axis_values[0],
+                                       cpu_axis.axis_values[0], io_percent_axis.axis_values[0]};
+    SimulationContext *simulation = create_simulation_context(&run_settings, false);
+    if (simulation == NULL)
+    {
+        cleanup_all_memory();
+        return 1;
+    }
+    if (event_log_path && !open_scheduler_log(simulation, event_log_path))
+    {
+        destroy_simulation_context(simulation);
+        cleanup_all_memory();
+        return 1;
     }
 
-    execute_scheduler();
-    print_result_table();
+    start_scheduler(simulation);
+    run_checkpointed_scheduler(simulation);
+    close_scheduler_log(simulation);
+    print_result_table(simulation);
+    destroy_simulation_context(simulation);
     cleanup_all_memory();
     return 0;
 }
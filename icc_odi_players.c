@@ -2,24 +2,67 @@
 #include <string.h>
 #include <stdlib.h>
 #include <ctype.h>
+#include <time.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 #include "Players_data.h"
 
 #define MAX_NAME_LENGTH 50
-#define MAX_PLAYERS_PER_TEAM 50
+#define INITIAL_NAME_BUCKETS 64
+#define INITIAL_PLAYER_CAPACITY 64
+#define INITIAL_INDEX_LIST_CAPACITY 8
+#define CSV_FIELD_COUNT 9
+#define MAX_PARSE_THREADS 16
+#define MIN_BYTES_PER_PARSE_THREAD (1 << 20)
+#define PLAYER_CACHE_MAGIC "ICCPLYR3"
+#define PLAYER_CACHE_MAGIC_LENGTH 8
+#define PLAYER_CACHE_BYTES_PER_PLAYER (5 * sizeof(int) + 3 * sizeof(float) + sizeof(unsigned char))
 
+typedef enum
+{
+    ROLE_BATSMAN,
+    ROLE_BOWLER,
+    ROLE_ALLROUNDER,
+    ROLE_COUNT
+} PlayerRole;
+
+/* Each distinct string is stored once in one character buffer; ids are dense and never change. */
 typedef struct
 {
-    int id;
-    char fullName[MAX_NAME_LENGTH];
-    char teamName[MAX_NAME_LENGTH];
-    char roleName[MAX_NAME_LENGTH];
-    int runs;
-    float battingAvg;
-    float strikeRate;
-    int wickets;
-    float economy;
-    float performanceScore;
-} PlayerRecord;
+    char *characters;
+    size_t characterCount;
+    size_t characterCapacity;
+    size_t *nameOffsets;
+    int nameCount;
+    int nameCapacity;
+    int *nameBuckets;
+    int bucketCount;
+} NameTable;
+
+/* Players are stored column by column, so scoring and sorting only pull the fields they read through the cache. */
+typedef struct
+{
+    int *ids;
+    int *nameIds;
+    int *teamIds;
+    unsigned char *roles;
+    int *runs;
+    float *battingAvgs;
+    float *strikeRates;
+    int *wickets;
+    float *economies;
+    float *performanceScores;
+    int count;
+    int capacity;
+    NameTable names;
+    NameTable teams;
+} PlayerStore;
 
 typedef struct
 {
@@ -27,15 +70,46 @@ typedef struct
     char teamName[MAX_NAME_LENGTH];
     int totalPlayers;
     float averageBattingStrikeRate;
-    int playerIndexes[MAX_PLAYERS_PER_TEAM];
-    int batsmanIndexes[MAX_PLAYERS_PER_TEAM];
-    int bowlerIndexes[MAX_PLAYERS_PER_TEAM];
-    int allrounderIndexes[MAX_PLAYERS_PER_TEAM];
+    int *playerIndexes;
+    int *batsmanIndexes;
+    int *bowlerIndexes;
+    int *allrounderIndexes;
     int batsmanCount;
     int bowlerCount;
     int allrounderCount;
+    int playerCapacity;
+    int batsmanCapacity;
+    int bowlerCapacity;
+    int allrounderCapacity;
 } TeamRecord;
 
+/* One slice of the mapped CSV, cut at line boundaries; each parser thread fills its own store so no locking is needed. */
+typedef struct
+{
+    const char *chunkStart;
+    const char *chunkEnd;
+    PlayerStore chunkStore;
+    int skippedRows;
+    int failed;
+} CsvParseTask;
+
+/* The cache is only trusted while the CSV it was built from keeps the same size and modification time and the payload
+   still matches its checksum. */
+typedef struct
+{
+    char magic[PLAYER_CACHE_MAGIC_LENGTH];
+    long long sourceSize;
+    long long sourceModifiedSeconds;
+    long long sourceModifiedNanoseconds;
+    int playerCount;
+    int nameCount;
+    int teamCount;
+    int skippedRows;
+    long long characterCount;
+    long long teamCharacterCount;
+    unsigned int payloadChecksum;
+} PlayerCacheHeader;
+
 typedef struct
 {
     int playerIndex;
@@ -43,26 +117,58 @@ typedef struct
     int indexInRoleList;
 } TeamPlayerHeapNode;
 
-void populatePlayersFromData(PlayerRecord playerRecords[], int *loadedPlayerCount);
-void buildTeamsFromPlayers(TeamRecord teamRecords[], int *loadedTeamCount, PlayerRecord playerRecords[], int loadedPlayerCount);
+static const char *roleNames[] = {"Batsman", "Bowler", "All-rounder"};
+
+unsigned int hashName(const char *name, size_t length);
+int growNameBuckets(NameTable *nameTable);
+int internName(NameTable *nameTable, const char *name, size_t length);
+const char *nameAt(const NameTable *nameTable, int nameId);
+void freeNameTable(NameTable *nameTable);
+int growColumn(void **column, int capacity, size_t elementSize);
+int reservePlayerStore(PlayerStore *playerStore, int requiredCapacity);
+int appendPlayer(PlayerStore *playerStore, const Player *player);
+void freePlayerStore(PlayerStore *playerStore);
+PlayerRole parseRoleName(const char *roleName);
+float scorePlayer(PlayerRole role, float battingAvg, float strikeRate, int wickets, float economy);
+void computePerformanceScores(PlayerStore *playerStore, int startIndex, int endIndex);
+void populatePlayersFromData(PlayerStore *playerStore);
+int *remapNames(NameTable *destination, const NameTable *source);
+int mergePlayerStore(PlayerStore *destination, const PlayerStore *source);
+int readCsvField(const char **cursor, const char *lineEnd, char *field, size_t fieldSize);
+int parseCsvRow(PlayerStore *playerStore, const char *lineStart, const char *lineEnd);
+void *parseCsvChunk(void *taskArgument);
+int parsePlayersCsv(PlayerStore *playerStore, const char *csvText, size_t csvSize, int *skippedRows);
+char *mapFileReadOnly(const char *filePath, struct stat *fileStatus);
+unsigned int checksumBytes(unsigned int hash, const void *bytes, size_t length);
+void writeCacheBlock(FILE *cacheFile, const void *bytes, size_t length, unsigned int *checksum);
+void writeNameTable(FILE *cacheFile, const NameTable *nameTable, unsigned int *checksum);
+int readNameTable(NameTable *nameTable, const char **readPosition, int nameCount, long long characterCount);
+int loadPlayerCache(PlayerStore *playerStore, const char *cachePath, const struct stat *sourceStatus, int *skippedRows);
+int savePlayerCache(const PlayerStore *playerStore, const char *cachePath, const struct stat *sourceStatus, int skippedRows);
+int loadPlayersFromCsv(PlayerStore *playerStore, const char *csvPath);
+int appendIndexToList(int **indexList, int *listCount, int *listCapacity, int playerIndex);
+int addPlayerIndexToTeam(TeamRecord *team, const PlayerStore *playerStore, int playerIndex);
+int compareTeamsByName(const void *firstTeam, const void *secondTeam);
+void freeTeamRecords(TeamRecord teamRecords[], int loadedTeamCount);
+TeamRecord *buildTeamsFromPlayers(int *loadedTeamCount, const PlayerStore *playerStore);
 int findTeamIndexById(TeamRecord teamRecords[], int teamId, int loadedTeamCount);
-void sortRoleIndexArrayByPerformance(PlayerRecord players[], int indexArray[], int startIndex, int endIndex);
-void mergeRoleIndexSegments(PlayerRecord players[], int indexArray[], int leftStart, int leftMid, int rightEnd);
+void sortRoleIndexArrayByPerformance(const PlayerStore *playerStore, int indexArray[], int startIndex, int endIndex);
+void mergeRoleIndexSegments(const PlayerStore *playerStore, int indexArray[], int leftStart, int leftMid, int rightEnd);
 void sortTeamsByAverageStrikeRate(TeamRecord teams[], int startIndex, int endIndex);
 void mergeTeamSegmentsByAverage(TeamRecord teams[], int startIndex, int middleIndex, int endIndex);
-void showPlayersForTeamId(TeamRecord teams[], PlayerRecord players[], int teamId , int loadedTeamCount);
+void showPlayersForTeamId(TeamRecord teams[], const PlayerStore *playerStore, int teamId , int loadedTeamCount);
 void showTeamsOrderedByStrikeRate(TeamRecord teams[], int loadedTeamCount);
-void showTopKPlayersForRoleInTeam(TeamRecord teams[], PlayerRecord players[], int loadedTeamCount);
+void showTopKPlayersForRoleInTeam(TeamRecord teams[], const PlayerStore *playerStore, int loadedTeamCount);
 void swapHeapNodes(TeamPlayerHeapNode *firstNode, TeamPlayerHeapNode *secondNode);
-void heapSiftDown(TeamPlayerHeapNode heap[], int heapSize, int currentIndex, PlayerRecord players[]);
-void heapInsertNode(TeamPlayerHeapNode heap[], int *heapSize, TeamPlayerHeapNode nodeToInsert, PlayerRecord players[]);
-TeamPlayerHeapNode heapPopMaxNode(TeamPlayerHeapNode heap[], int *heapSize, PlayerRecord players[]);
-void showAllPlayersByRoleAcrossTeams(TeamRecord teams[], PlayerRecord players[], int roleChoice, int loadedTeamCount);
+void heapSiftDown(TeamPlayerHeapNode heap[], int heapSize, int currentIndex, const PlayerStore *playerStore);
+void heapInsertNode(TeamPlayerHeapNode heap[], int *heapSize, TeamPlayerHeapNode nodeToInsert, const PlayerStore *playerStore);
+TeamPlayerHeapNode heapPopMaxNode(TeamPlayerHeapNode heap[], int *heapSize, const PlayerStore *playerStore);
+void showAllPlayersByRoleAcrossTeams(TeamRecord teams[], const PlayerStore *playerStore, int roleChoice, int loadedTeamCount);
 int isValidIntegerString(char *inputString);
 int isValidFloatString(char *inputString);
 int readValidatedInteger();
 float readValidatedFloat();
-void addNewPlayerToTeam(TeamRecord teams[], PlayerRecord players[], int *loadedPlayerCount, int loadedTeamCount);
+void addNewPlayerToTeam(TeamRecord teams[], PlayerStore *playerStore, int loadedTeamCount);
 
 int isValidIntegerString(char *inputString)
 {
@@ -168,40 +274,859 @@ float readValidatedFloat()
     }
 }
 
-void populatePlayersFromData(PlayerRecord playerRecords[], int *loadedPlayerCount)
+unsigned int hashName(const char *name, size_t length)
+{
+    unsigned int hash = 2166136261u;
+    for (size_t position = 0; position < length; position++)
+    {
+        hash = (hash ^ (unsigned char)name[position]) * 16777619u;
+    }
+    return hash;
+}
+
+int growNameBuckets(NameTable *nameTable)
+{
+    int newBucketCount = nameTable->bucketCount ? nameTable->bucketCount * 2 : INITIAL_NAME_BUCKETS;
+    while (newBucketCount < (nameTable->nameCount + 1) * 2)
+    {
+        newBucketCount *= 2;
+    }
+    int *newBuckets = (int *)malloc(newBucketCount * sizeof(int));
+    if (newBuckets == NULL)
+    {
+        return 0;
+    }
+    for (int bucket = 0; bucket < newBucketCount; bucket++)
+    {
+        newBuckets[bucket] = -1;
+    }
+    for (int nameId = 0; nameId < nameTable->nameCount; nameId++)
+    {
+        const char *name = nameAt(nameTable, nameId);
+        int bucket = (int)(hashName(name, strlen(name)) & (unsigned int)(newBucketCount - 1));
+        while (newBuckets[bucket] != -1)
+        {
+            bucket = (bucket + 1) & (newBucketCount - 1);
+        }
+        newBuckets[bucket] = nameId;
+    }
+    free(nameTable->nameBuckets);
+    nameTable->nameBuckets = newBuckets;
+    nameTable->bucketCount = newBucketCount;
+    return 1;
+}
+
+/* Returns the id of the first length characters of name, adding them on first sight; -1 if memory runs out. */
+int internName(NameTable *nameTable, const char *name, size_t length)
+{
+    if ((nameTable->nameCount + 1) * 2 > nameTable->bucketCount && !growNameBuckets(nameTable))
+    {
+        return -1;
+    }
+    int bucket = (int)(hashName(name, length) & (unsigned int)(nameTable->bucketCount - 1));
+    while (nameTable->nameBuckets[bucket] != -1)
+    {
+        const char *storedName = nameAt(nameTable, nameTable->nameBuckets[bucket]);
+        if (strncmp(storedName, name, length) == 0 && storedName[length] == '\0')
+        {
+            return nameTable->nameBuckets[bucket];
+        }
+        bucket = (bucket + 1) & (nameTable->bucketCount - 1);
+    }
+
+    if (nameTable->characterCount + length + 1 > nameTable->characterCapacity)
+    {
+        size_t newCapacity = nameTable->characterCapacity ? nameTable->characterCapacity * 2 : 1024;
+        while (newCapacity < nameTable->characterCount + length + 1)
+        {
+            newCapacity *= 2;
+        }
+        char *newCharacters = (char *)realloc(nameTable->characters, newCapacity);
+        if (newCharacters == NULL)
+        {
+            return -1;
+        }
+        nameTable->characters = newCharacters;
+        nameTable->characterCapacity = newCapacity;
+    }
+    if (nameTable->nameCount == nameTable->nameCapacity)
+    {
+        int newCapacity = nameTable->nameCapacity ? nameTable->nameCapacity * 2 : INITIAL_NAME_BUCKETS;
+        size_t *newOffsets = (size_t *)realloc(nameTable->nameOffsets, newCapacity * sizeof(size_t));
+        if (newOffsets == NULL)
+        {
+            return -1;
+        }
+        nameTable->nameOffsets = newOffsets;
+        nameTable->nameCapacity = newCapacity;
+    }
+
+    int nameId = nameTable->nameCount++;
+    nameTable->nameOffsets[nameId] = nameTable->characterCount;
+    memcpy(nameTable->characters + nameTable->characterCount, name, length);
+    nameTable->characters[nameTable->characterCount + length] = '\0';
+    nameTable->characterCount += length + 1;
+    nameTable->nameBuckets[bucket] = nameId;
+    return nameId;
+}
+
+const char *nameAt(const NameTable *nameTable, int nameId)
+{
+    return nameTable->characters + nameTable->nameOffsets[nameId];
+}
+
+void freeNameTable(NameTable *nameTable)
+{
+    free(nameTable->characters);
+    free(nameTable->nameOffsets);
+    free(nameTable->nameBuckets);
+    memset(nameTable, 0, sizeof(NameTable));
+}
+
+int growColumn(void **column, int capacity, size_t elementSize)
+{
+    void *grownColumn = realloc(*column, capacity * elementSize);
+    if (grownColumn == NULL)
+    {
+        return 0;
+    }
+    *column = grownColumn;
+    return 1;
+}
+
+int reservePlayerStore(PlayerStore *playerStore, int requiredCapacity)
+{
+    if (requiredCapacity <= playerStore->capacity)
+    {
+        return 1;
+    }
+    int newCapacity = playerStore->capacity ? playerStore->capacity : INITIAL_PLAYER_CAPACITY;
+    while (newCapacity < requiredCapacity)
+    {
+        newCapacity *= 2;
+    }
+    if (!growColumn((void **)&playerStore->ids, newCapacity, sizeof(int)) ||
+        !growColumn((void **)&playerStore->nameIds, newCapacity, sizeof(int)) ||
+        !growColumn((void **)&playerStore->teamIds, newCapacity, sizeof(int)) ||
+        !growColumn((void **)&playerStore->roles, newCapacity, sizeof(unsigned char)) ||
+        !growColumn((void **)&playerStore->runs, newCapacity, sizeof(int)) ||
+        !growColumn((void **)&playerStore->battingAvgs, newCapacity, sizeof(float)) ||
+        !growColumn((void **)&playerStore->strikeRates, newCapacity, sizeof(float)) ||
+        !growColumn((void **)&playerStore->wickets, newCapacity, sizeof(int)) ||
+        !growColumn((void **)&playerStore->economies, newCapacity, sizeof(float)) ||
+        !growColumn((void **)&playerStore->performanceScores, newCapacity, sizeof(float)))
+    {
+        printf("Memory allocation failed in reservePlayerStore.\n");
+        return 0;
+    }
+    playerStore->capacity = newCapacity;
+    return 1;
+}
+
+/* Names are cut to MAX_NAME_LENGTH - 1 characters like the old fixed buffers; the score is left to computePerformanceScores. */
+int appendPlayer(PlayerStore *playerStore, const Player *player)
+{
+    if (!reservePlayerStore(playerStore, playerStore->count + 1))
+    {
+        return -1;
+    }
+    int nameId = internName(&playerStore->names, player->name, strnlen(player->name, MAX_NAME_LENGTH - 1));
+    int teamId = internName(&playerStore->teams, player->team, strnlen(player->team, MAX_NAME_LENGTH - 1));
+    if (nameId < 0 || teamId < 0)
+    {
+        printf("Memory allocation failed in appendPlayer.\n");
+        return -1;
+    }
+    int playerIndex = playerStore->count++;
+    playerStore->ids[playerIndex] = player->id;
+    playerStore->nameIds[playerIndex] = nameId;
+    playerStore->teamIds[playerIndex] = teamId;
+    playerStore->roles[playerIndex] = (unsigned char)parseRoleName(player->role);
+    playerStore->runs[playerIndex] = player->totalRuns;
+    playerStore->battingAvgs[playerIndex] = player->battingAverage;
+    playerStore->strikeRates[playerIndex] = player->strikeRate;
+    playerStore->wickets[playerIndex] = player->wickets;
+    playerStore->economies[playerIndex] = player->economyRate;
+    playerStore->performanceScores[playerIndex] = 0.0f;
+    return playerIndex;
+}
+
+void freePlayerStore(PlayerStore *playerStore)
+{
+    free(playerStore->ids);
+    free(playerStore->nameIds);
+    free(playerStore->teamIds);
+    free(playerStore->roles);
+    free(playerStore->runs);
+    free(playerStore->battingAvgs);
+    free(playerStore->strikeRates);
+    free(playerStore->wickets);
+    free(playerStore->economies);
+    free(playerStore->performanceScores);
+    freeNameTable(&playerStore->names);
+    freeNameTable(&playerStore->teams);
+    memset(playerStore, 0, sizeof(PlayerStore));
+}
+
+PlayerRole parseRoleName(const char *roleName)
+{
+    if (strcmp(roleName, "Batsman") == 0)
+    {
+        return ROLE_BATSMAN;
+    }
+    if (strcmp(roleName, "Bowler") == 0)
+    {
+        return ROLE_BOWLER;
+    }
+    return ROLE_ALLROUNDER;
+}
+
+float scorePlayer(PlayerRole role, float battingAvg, float strikeRate, int wickets, float economy)
+{
+    if (role == ROLE_BATSMAN)
+    {
+        return (battingAvg * strikeRate) / 100.0f;
+    }
+    if (role == ROLE_BOWLER)
+    {
+        return (wickets * 2) + (100 - economy);
+    }
+    return ((battingAvg * strikeRate) / 100.0f) + (wickets * 2);
+}
+
+/* Scores players [startIndex, endIndex). The SSE2 path computes all three role formulas four players at a time and
+   selects per lane; it uses the same operations in the same order as scorePlayer, so both give bit-identical floats. */
+void computePerformanceScores(PlayerStore *playerStore, int startIndex, int endIndex)
+{
+    int playerIndex = startIndex;
+#ifdef __SSE2__
+    const __m128 hundred = _mm_set1_ps(100.0f);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i batsmanRole = _mm_set1_epi32(ROLE_BATSMAN);
+    const __m128i bowlerRole = _mm_set1_epi32(ROLE_BOWLER);
+    for (; playerIndex + 4 <= endIndex; playerIndex += 4)
+    {
+        __m128 batting = _mm_div_ps(_mm_mul_ps(_mm_loadu_ps(&playerStore->battingAvgs[playerIndex]),
+                                               _mm_loadu_ps(&playerStore->strikeRates[playerIndex])), hundred);
+        __m128 wicketPoints = _mm_cvtepi32_ps(_mm_slli_epi32(_mm_loadu_si128((const __m128i *)&playerStore->wickets[playerIndex]), 1));
+        __m128 bowling = _mm_add_ps(wicketPoints, _mm_sub_ps(hundred, _mm_loadu_ps(&playerStore->economies[playerIndex])));
+        __m128 allround = _mm_add_ps(batting, wicketPoints);
+        int packedRoles;
+        memcpy(&packedRoles, &playerStore->roles[playerIndex], sizeof(packedRoles));
+        __m128i roles = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(packedRoles), zero), zero);
+        __m128 isBatsman = _mm_castsi128_ps(_mm_cmpeq_epi32(roles, batsmanRole));
+        __m128 isBowler = _mm_castsi128_ps(_mm_cmpeq_epi32(roles, bowlerRole));
+        __m128 score = _mm_or_ps(_mm_and_ps(isBowler, bowling), _mm_andnot_ps(isBowler, allround));
+        score = _mm_or_ps(_mm_and_ps(isBatsman, batting), _mm_andnot_ps(isBatsman, score));
+        _mm_storeu_ps(&playerStore->performanceScores[playerIndex], score);
+    }
+#endif
+    for (; playerIndex < endIndex; playerIndex++)
+    {
+        playerStore->performanceScores[playerIndex] = scorePlayer((PlayerRole)playerStore->roles[playerIndex], playerStore->battingAvgs[playerIndex],
+                                                                  playerStore->strikeRates[playerIndex], playerStore->wickets[playerIndex],
+                                                                  playerStore->economies[playerIndex]);
+    }
+}
+
+void populatePlayersFromData(PlayerStore *playerStore)
 {
-    *loadedPlayerCount = 0;
+    if (!reservePlayerStore(playerStore, playerCount))
+    {
+        return;
+    }
     for (int dataIndex = 0; dataIndex < playerCount; dataIndex++)
     {
-        playerRecords[dataIndex].id = players[dataIndex].id;
-        strncpy(playerRecords[dataIndex].fullName, players[dataIndex].name, MAX_NAME_LENGTH - 1);
-        playerRecords[dataIndex].fullName[MAX_NAME_LENGTH - 1] = '\0';
-        strncpy(playerRecords[dataIndex].teamName, players[dataIndex].team, MAX_NAME_LENGTH - 1);
-        playerRecords[dataIndex].teamName[MAX_NAME_LENGTH - 1] = '\0';
-        strncpy(playerRecords[dataIndex].roleName, players[dataIndex].role, MAX_NAME_LENGTH - 1);
-        playerRecords[dataIndex].roleName[MAX_NAME_LENGTH - 1] = '\0';
-        playerRecords[dataIndex].runs = players[dataIndex].totalRuns;
-        playerRecords[dataIndex].battingAvg = players[dataIndex].battingAverage;
-        playerRecords[dataIndex].strikeRate = players[dataIndex].strikeRate;
-        playerRecords[dataIndex].wickets = players[dataIndex].wickets;
-        playerRecords[dataIndex].economy = players[dataIndex].economyRate;
-        if (strcmp(players[dataIndex].role, "Batsman") == 0)
+        if (appendPlayer(playerStore, &players[dataIndex]) < 0)
+        {
+            break;
+        }
+    }
+    computePerformanceScores(playerStore, 0, playerStore->count);
+}
+
+/* Interns every name of source into destination; the returned array maps source ids to destination ids. */
+int *remapNames(NameTable *destination, const NameTable *source)
+{
+    int *nameRemap = (int *)malloc((source->nameCount > 0 ? source->nameCount : 1) * sizeof(int));
+    if (nameRemap == NULL)
+    {
+        printf("Memory allocation failed in remapNames.\n");
+        return NULL;
+    }
+    for (int nameId = 0; nameId < source->nameCount; nameId++)
+    {
+        const char *name = nameAt(source, nameId);
+        nameRemap[nameId] = internName(destination, name, strlen(name));
+        if (nameRemap[nameId] < 0)
+        {
+            printf("Memory allocation failed in remapNames.\n");
+            free(nameRemap);
+            return NULL;
+        }
+    }
+    return nameRemap;
+}
+
+/* Appends every player of source to destination, re-interning its names so the ids refer to destination's tables. */
+int mergePlayerStore(PlayerStore *destination, const PlayerStore *source)
+{
+    if (source->count == 0)
+    {
+        return 1;
+    }
+    int *nameRemap = remapNames(&destination->names, &source->names);
+    int *teamRemap = nameRemap != NULL ? remapNames(&destination->teams, &source->teams) : NULL;
+    if (teamRemap == NULL)
+    {
+        free(nameRemap);
+        return 0;
+    }
+    if (!reservePlayerStore(destination, destination->count + source->count))
+    {
+        free(nameRemap);
+        free(teamRemap);
+        return 0;
+    }
+
+    int firstIndex = destination->count;
+    memcpy(&destination->ids[firstIndex], source->ids, source->count * sizeof(int));
+    memcpy(&destination->roles[firstIndex], source->roles, source->count * sizeof(unsigned char));
+    memcpy(&destination->runs[firstIndex], source->runs, source->count * sizeof(int));
+    memcpy(&destination->battingAvgs[firstIndex], source->battingAvgs, source->count * sizeof(float));
+    memcpy(&destination->strikeRates[firstIndex], source->strikeRates, source->count * sizeof(float));
+    memcpy(&destination->wickets[firstIndex], source->wickets, source->count * sizeof(int));
+    memcpy(&destination->economies[firstIndex], source->economies, source->count * sizeof(float));
+    memcpy(&destination->performanceScores[firstIndex], source->performanceScores, source->count * sizeof(float));
+    for (int playerIndex = 0; playerIndex < source->count; playerIndex++)
+    {
+        destination->nameIds[firstIndex + playerIndex] = nameRemap[source->nameIds[playerIndex]];
+        destination->teamIds[firstIndex + playerIndex] = teamRemap[source->teamIds[playerIndex]];
+    }
+    destination->count += source->count;
+
+    free(nameRemap);
+    free(teamRemap);
+    return 1;
+}
+
+/* Copies the next field of the line into field, without surrounding blanks or quotes and cut to fieldSize - 1
+   characters, then moves *cursor past its comma. *cursor becomes NULL after the last field; returns 0 if none is left. */
+int readCsvField(const char **cursor, const char *lineEnd, char *field, size_t fieldSize)
+{
+    const char *position = *cursor;
+    if (position == NULL)
+    {
+        return 0;
+    }
+    while (position < lineEnd && (*position == ' ' || *position == '\t'))
+    {
+        position++;
+    }
+    const char *fieldStart = position;
+    const char *fieldEnd;
+    if (position < lineEnd && *position == '"')
+    {
+        fieldStart = ++position;
+        while (position < lineEnd && *position != '"')
+        {
+            position++;
+        }
+        fieldEnd = position;
+        while (position < lineEnd && *position != ',')
+        {
+            position++;
+        }
+    }
+    else
+    {
+        while (position < lineEnd && *position != ',')
+        {
+            position++;
+        }
+        fieldEnd = position;
+        while (fieldEnd > fieldStart && (fieldEnd[-1] == ' ' || fieldEnd[-1] == '\t'))
+        {
+            fieldEnd--;
+        }
+    }
+
+    size_t fieldLength = (size_t)(fieldEnd - fieldStart);
+    if (fieldLength > fieldSize - 1)
+    {
+        fieldLength = fieldSize - 1;
+    }
+    memcpy(field, fieldStart, fieldLength);
+    field[fieldLength] = '\0';
+    *cursor = position < lineEnd ? position + 1 : NULL;
+    return 1;
+}
+
+/* Row layout: id,name,team,role,runs,battingAverage,strikeRate,wickets,economyRate.
+   Returns 1 when the player was added, 0 for a malformed row and -1 when memory runs out. */
+int parseCsvRow(PlayerStore *playerStore, const char *lineStart, const char *lineEnd)
+{
+    char fields[CSV_FIELD_COUNT][MAX_NAME_LENGTH];
+    const char *cursor = lineStart;
+    for (int fieldIndex = 0; fieldIndex < CSV_FIELD_COUNT; fieldIndex++)
+    {
+        if (!readCsvField(&cursor, lineEnd, fields[fieldIndex], MAX_NAME_LENGTH))
+        {
+            return 0;
+        }
+    }
+    if (cursor != NULL || fields[1][0] == '\0' || fields[2][0] == '\0' ||
+        !isValidIntegerString(fields[0]) || !isValidIntegerString(fields[4]) || !isValidIntegerString(fields[7]) ||
+        !isValidFloatString(fields[5]) || !isValidFloatString(fields[6]) || !isValidFloatString(fields[8]))
+    {
+        return 0;
+    }
+    PlayerRole role = parseRoleName(fields[3]);
+    if (role == ROLE_ALLROUNDER && strcmp(fields[3], roleNames[ROLE_ALLROUNDER]) != 0)
+    {
+        return 0;
+    }
+
+    Player row;
+    row.id = atoi(fields[0]);
+    row.name = fields[1];
+    row.team = fields[2];
+    row.role = roleNames[role];
+    row.totalRuns = atoi(fields[4]);
+    row.battingAverage = (float)atof(fields[5]);
+    row.strikeRate = (float)atof(fields[6]);
+    row.wickets = atoi(fields[7]);
+    row.economyRate = (float)atof(fields[8]);
+    return appendPlayer(playerStore, &row) < 0 ? -1 : 1;
+}
+
+void *parseCsvChunk(void *taskArgument)
+{
+    CsvParseTask *task = (CsvParseTask *)taskArgument;
+    const char *lineStart = task->chunkStart;
+    while (lineStart < task->chunkEnd)
+    {
+        const char *lineEnd = (const char *)memchr(lineStart, '\n', (size_t)(task->chunkEnd - lineStart));
+        const char *nextLine = lineEnd != NULL ? lineEnd + 1 : task->chunkEnd;
+        if (lineEnd == NULL)
+        {
+            lineEnd = task->chunkEnd;
+        }
+        if (lineEnd > lineStart && lineEnd[-1] == '\r')
+        {
+            lineEnd--;
+        }
+        if (lineEnd > lineStart)
+        {
+            int parsed = parseCsvRow(&task->chunkStore, lineStart, lineEnd);
+            if (parsed < 0)
+            {
+                task->failed = 1;
+                break;
+            }
+            if (parsed == 0)
+            {
+                task->skippedRows++;
+            }
+        }
+        lineStart = nextLine;
+    }
+    return NULL;
+}
+
+/* Splits the text into line-aligned chunks, parses them on separate threads and appends the results in file order. */
+int parsePlayersCsv(PlayerStore *playerStore, const char *csvText, size_t csvSize, int *skippedRows)
+{
+    const char *dataStart = csvText;
+    const char *dataEnd = csvText + csvSize;
+
+    char firstField[MAX_NAME_LENGTH];
+    const char *firstLineEnd = (const char *)memchr(dataStart, '\n', csvSize);
+    const char *headerCursor = dataStart;
+    if (readCsvField(&headerCursor, firstLineEnd != NULL ? firstLineEnd : dataEnd, firstField, sizeof(firstField)) &&
+        !isValidIntegerString(firstField))
+    {
+        dataStart = firstLineEnd != NULL ? firstLineEnd + 1 : dataEnd;
+    }
+
+    long processorCount = sysconf(_SC_NPROCESSORS_ONLN);
+    int threadCount = (int)((size_t)(dataEnd - dataStart) / MIN_BYTES_PER_PARSE_THREAD) + 1;
+    if (processorCount > 0 && threadCount > processorCount)
+    {
+        threadCount = (int)processorCount;
+    }
+    if (threadCount > MAX_PARSE_THREADS)
+    {
+        threadCount = MAX_PARSE_THREADS;
+    }
+
+    CsvParseTask parseTasks[MAX_PARSE_THREADS];
+    pthread_t parseThreads[MAX_PARSE_THREADS];
+    int threadStarted[MAX_PARSE_THREADS];
+    memset(parseTasks, 0, sizeof(parseTasks));
+    const char *chunkStart = dataStart;
+    for (int taskIndex = 0; taskIndex < threadCount; taskIndex++)
+    {
+        const char *chunkEnd = dataEnd;
+        if (taskIndex < threadCount - 1)
+        {
+            chunkEnd = dataStart + (size_t)(dataEnd - dataStart) * (taskIndex + 1) / threadCount;
+            if (chunkEnd < chunkStart)
+            {
+                chunkEnd = chunkStart;
+            }
+            const char *lineBreak = (const char *)memchr(chunkEnd, '\n', (size_t)(dataEnd - chunkEnd));
+            chunkEnd = lineBreak != NULL ? lineBreak + 1 : dataEnd;
+        }
+        parseTasks[taskIndex].chunkStart = chunkStart;
+        parseTasks[taskIndex].chunkEnd = chunkEnd;
+        chunkStart = chunkEnd;
+    }
+
+    for (int taskIndex = 1; taskIndex < threadCount; taskIndex++)
+    {
+        threadStarted[taskIndex] = pthread_create(&parseThreads[taskIndex], NULL, parseCsvChunk, &parseTasks[taskIndex]) == 0;
+        if (!threadStarted[taskIndex])
+        {
+            parseCsvChunk(&parseTasks[taskIndex]);
+        }
+    }
+    parseCsvChunk(&parseTasks[0]);
+    for (int taskIndex = 1; taskIndex < threadCount; taskIndex++)
+    {
+        if (threadStarted[taskIndex])
+        {
+            pthread_join(parseThreads[taskIndex], NULL);
+        }
+    }
+
+    int totalPlayers = 0;
+    int succeeded = 1;
+    *skippedRows = 0;
+    for (int taskIndex = 0; taskIndex < threadCount; taskIndex++)
+    {
+        totalPlayers += parseTasks[taskIndex].chunkStore.count;
+        *skippedRows += parseTasks[taskIndex].skippedRows;
+        if (parseTasks[taskIndex].failed)
+        {
+            succeeded = 0;
+        }
+    }
+    if (succeeded && !reservePlayerStore(playerStore, totalPlayers))
+    {
+        succeeded = 0;
+    }
+    for (int taskIndex = 0; taskIndex < threadCount; taskIndex++)
+    {
+        if (succeeded && !mergePlayerStore(playerStore, &parseTasks[taskIndex].chunkStore))
+        {
+            succeeded = 0;
+        }
+        freePlayerStore(&parseTasks[taskIndex].chunkStore);
+    }
+    if (!succeeded)
+    {
+        return 0;
+    }
+
+    computePerformanceScores(playerStore, 0, playerStore->count);
+    return 1;
+}
+
+/* Returns a private read-only mapping of a regular, non-empty file, or NULL. The caller unmaps fileStatus->st_size bytes. */
+char *mapFileReadOnly(const char *filePath, struct stat *fileStatus)
+{
+    int fileDescriptor = open(filePath, O_RDONLY);
+    if (fileDescriptor < 0)
+    {
+        return NULL;
+    }
+    char *mappedFile = NULL;
+    if (fstat(fileDescriptor, fileStatus) == 0 && S_ISREG(fileStatus->st_mode) && fileStatus->st_size > 0)
+    {
+        mappedFile = (char *)mmap(NULL, (size_t)fileStatus->st_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+        if (mappedFile == MAP_FAILED)
+        {
+            mappedFile = NULL;
+        }
+    }
+    close(fileDescriptor);
+    return mappedFile;
+}
+
+/* FNV-1a, continued from hash so that a payload written in several blocks checksums the same as one read back whole. */
+unsigned int checksumBytes(unsigned int hash, const void *bytes, size_t length)
+{
+    const unsigned char *byteData = (const unsigned char *)bytes;
+    for (size_t position = 0; position < length; position++)
+    {
+        hash = (hash ^ byteData[position]) * 16777619u;
+    }
+    return hash;
+}
+
+void writeCacheBlock(FILE *cacheFile, const void *bytes, size_t length, unsigned int *checksum)
+{
+    if (length == 0)
+    {
+        return;
+    }
+    fwrite(bytes, 1, length, cacheFile);
+    *checksum = checksumBytes(*checksum, bytes, length);
+}
+
+void writeNameTable(FILE *cacheFile, const NameTable *nameTable, unsigned int *checksum)
+{
+    writeCacheBlock(cacheFile, nameTable->nameOffsets, (size_t)nameTable->nameCount * sizeof(size_t), checksum);
+    writeCacheBlock(cacheFile, nameTable->characters, nameTable->characterCount, checksum);
+}
+
+/* Rebuilds a table written by writeNameTable and moves *readPosition past it; returns 0 if the data is inconsistent. */
+int readNameTable(NameTable *nameTable, const char **readPosition, int nameCount, long long characterCount)
+{
+    if (nameCount == 0)
+    {
+        return characterCount == 0;
+    }
+    const char *characters = *readPosition + nameCount * sizeof(size_t);
+    if (characterCount <= 0 || characters[characterCount - 1] != '\0')
+    {
+        return 0;
+    }
+    nameTable->nameOffsets = (size_t *)malloc(nameCount * sizeof(size_t));
+    nameTable->characters = (char *)malloc((size_t)characterCount);
+    if (nameTable->nameOffsets == NULL || nameTable->characters == NULL)
+    {
+        printf("Memory allocation failed in readNameTable.\n");
+        return 0;
+    }
+    memcpy(nameTable->nameOffsets, *readPosition, nameCount * sizeof(size_t));
+    memcpy(nameTable->characters, characters, (size_t)characterCount);
+    *readPosition = characters + characterCount;
+    nameTable->nameCount = nameCount;
+    nameTable->nameCapacity = nameCount;
+    nameTable->characterCount = (size_t)characterCount;
+    nameTable->characterCapacity = (size_t)characterCount;
+    for (int nameId = 0; nameId < nameCount; nameId++)
+    {
+        if (nameTable->nameOffsets[nameId] >= (size_t)characterCount)
         {
-            playerRecords[dataIndex].performanceScore = (players[dataIndex].battingAverage * players[dataIndex].strikeRate) / 100.0f;
+            return 0;
         }
-        else if (strcmp(players[dataIndex].role, "Bowler") == 0)
+    }
+    return growNameBuckets(nameTable);
+}
+
+/* Cache layout: header, the nine player columns in PlayerStore order (scores are recomputed), the player name table,
+   the team name table. */
+int loadPlayerCache(PlayerStore *playerStore, const char *cachePath, const struct stat *sourceStatus, int *skippedRows)
+{
+    struct stat cacheStatus;
+    char *mappedCache = mapFileReadOnly(cachePath, &cacheStatus);
+    if (mappedCache == NULL)
+    {
+        return 0;
+    }
+    size_t cacheSize = (size_t)cacheStatus.st_size;
+
+    PlayerCacheHeader header;
+    int valid = cacheSize >= sizeof(header);
+    if (valid)
+    {
+        memcpy(&header, mappedCache, sizeof(header));
+        valid = memcmp(header.magic, PLAYER_CACHE_MAGIC, PLAYER_CACHE_MAGIC_LENGTH) == 0 &&
+                header.sourceSize == (long long)sourceStatus->st_size &&
+                header.sourceModifiedSeconds == (long long)sourceStatus->st_mtim.tv_sec &&
+                header.sourceModifiedNanoseconds == (long long)sourceStatus->st_mtim.tv_nsec &&
+                header.playerCount >= 0 && header.nameCount >= 0 && header.characterCount >= 0 &&
+                header.teamCount >= 0 && header.teamCharacterCount >= 0 &&
+                cacheSize == sizeof(header) + (size_t)header.playerCount * PLAYER_CACHE_BYTES_PER_PLAYER +
+                             (size_t)header.nameCount * sizeof(size_t) + (size_t)header.characterCount +
+                             (size_t)header.teamCount * sizeof(size_t) + (size_t)header.teamCharacterCount &&
+                checksumBytes(2166136261u, mappedCache + sizeof(header), cacheSize - sizeof(header)) ==
+                    header.payloadChecksum;
+    }
+    if (valid && header.playerCount > 0)
+    {
+        valid = reservePlayerStore(playerStore, header.playerCount);
+    }
+    if (!valid)
+    {
+        freePlayerStore(playerStore);
+        munmap(mappedCache, cacheSize);
+        return 0;
+    }
+
+    const char *readPosition = mappedCache + sizeof(header);
+    size_t columnLength = (size_t)header.playerCount;
+    memcpy(playerStore->ids, readPosition, columnLength * sizeof(int));
+    readPosition += columnLength * sizeof(int);
+    memcpy(playerStore->nameIds, readPosition, columnLength * sizeof(int));
+    readPosition += columnLength * sizeof(int);
+    memcpy(playerStore->teamIds, readPosition, columnLength * sizeof(int));
+    readPosition += columnLength * sizeof(int);
+    memcpy(playerStore->roles, readPosition, columnLength * sizeof(unsigned char));
+    readPosition += columnLength * sizeof(unsigned char);
+    memcpy(playerStore->runs, readPosition, columnLength * sizeof(int));
+    readPosition += columnLength * sizeof(int);
+    memcpy(playerStore->battingAvgs, readPosition, columnLength * sizeof(float));
+    readPosition += columnLength * sizeof(float);
+    memcpy(playerStore->strikeRates, readPosition, columnLength * sizeof(float));
+    readPosition += columnLength * sizeof(float);
+    memcpy(playerStore->wickets, readPosition, columnLength * sizeof(int));
+    readPosition += columnLength * sizeof(int);
+    memcpy(playerStore->economies, readPosition, columnLength * sizeof(float));
+    readPosition += columnLength * sizeof(float);
+    playerStore->count = header.playerCount;
+    valid = readNameTable(&playerStore->names, &readPosition, header.nameCount, header.characterCount) &&
+            readNameTable(&playerStore->teams, &readPosition, header.teamCount, header.teamCharacterCount);
+    munmap(mappedCache, cacheSize);
+
+    for (int playerIndex = 0; playerIndex < header.playerCount && valid; playerIndex++)
+    {
+        valid = playerStore->nameIds[playerIndex] >= 0 && playerStore->nameIds[playerIndex] < header.nameCount &&
+                playerStore->teamIds[playerIndex] >= 0 && playerStore->teamIds[playerIndex] < header.teamCount &&
+                playerStore->roles[playerIndex] < ROLE_COUNT;
+    }
+    if (!valid)
+    {
+        freePlayerStore(playerStore);
+        return 0;
+    }
+    computePerformanceScores(playerStore, 0, playerStore->count);
+    *skippedRows = header.skippedRows;
+    return 1;
+}
+
+int savePlayerCache(const PlayerStore *playerStore, const char *cachePath, const struct stat *sourceStatus, int skippedRows)
+{
+    size_t pathLength = strlen(cachePath);
+    char *temporaryPath = (char *)malloc(pathLength + 5);
+    if (temporaryPath == NULL)
+    {
+        printf("Memory allocation failed in savePlayerCache.\n");
+        return 0;
+    }
+    memcpy(temporaryPath, cachePath, pathLength);
+    memcpy(temporaryPath + pathLength, ".tmp", 5);
+
+    FILE *cacheFile = fopen(temporaryPath, "wb");
+    if (cacheFile == NULL)
+    {
+        printf("Could not open '%s' for writing.\n", temporaryPath);
+        free(temporaryPath);
+        return 0;
+    }
+
+    PlayerCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, PLAYER_CACHE_MAGIC, PLAYER_CACHE_MAGIC_LENGTH);
+    header.sourceSize = (long long)sourceStatus->st_size;
+    header.sourceModifiedSeconds = (long long)sourceStatus->st_mtim.tv_sec;
+    header.sourceModifiedNanoseconds = (long long)sourceStatus->st_mtim.tv_nsec;
+    header.playerCount = playerStore->count;
+    header.nameCount = playerStore->names.nameCount;
+    header.characterCount = (long long)playerStore->names.characterCount;
+    header.teamCount = playerStore->teams.nameCount;
+    header.skippedRows = skippedRows;
+    header.teamCharacterCount = (long long)playerStore->teams.characterCount;
+    header.payloadChecksum = 2166136261u;
+
+    /* The header is written again once the payload checksum is known. */
+    size_t columnLength = (size_t)playerStore->count;
+    fwrite(&header, sizeof(header), 1, cacheFile);
+    writeCacheBlock(cacheFile, playerStore->ids, columnLength * sizeof(int), &header.payloadChecksum);
+    writeCacheBlock(cacheFile, playerStore->nameIds, columnLength * sizeof(int), &header.payloadChecksum);
+    writeCacheBlock(cacheFile, playerStore->teamIds, columnLength * sizeof(int), &header.payloadChecksum);
+    writeCacheBlock(cacheFile, playerStore->roles, columnLength * sizeof(unsigned char), &header.payloadChecksum);
+    writeCacheBlock(cacheFile, playerStore->runs, columnLength * sizeof(int), &header.payloadChecksum);
+    writeCacheBlock(cacheFile, playerStore->battingAvgs, columnLength * sizeof(float), &header.payloadChecksum);
+    writeCacheBlock(cacheFile, playerStore->strikeRates, columnLength * sizeof(float), &header.payloadChecksum);
+    writeCacheBlock(cacheFile, playerStore->wickets, columnLength * sizeof(int), &header.payloadChecksum);
+    writeCacheBlock(cacheFile, playerStore->economies, columnLength * sizeof(float), &header.payloadChecksum);
+    writeNameTable(cacheFile, &playerStore->names, &header.payloadChecksum);
+    writeNameTable(cacheFile, &playerStore->teams, &header.payloadChecksum);
+    if (fseek(cacheFile, 0, SEEK_SET) == 0)
+    {
+        fwrite(&header, sizeof(header), 1, cacheFile);
+    }
+
+    int written = !ferror(cacheFile);
+    written = (fclose(cacheFile) == 0) && written;
+    if (written && rename(temporaryPath, cachePath) != 0)
+    {
+        written = 0;
+    }
+    if (!written)
+    {
+        printf("Could not write the player cache '%s'.\n", cachePath);
+        remove(temporaryPath);
+    }
+    free(temporaryPath);
+    return written;
+}
+
+/* Loads players from csvPath, reusing csvPath.cache when it still matches the CSV and rebuilding it otherwise. */
+int loadPlayersFromCsv(PlayerStore *playerStore, const char *csvPath)
+{
+    struct timespec loadStarted;
+    struct timespec loadFinished;
+    clock_gettime(CLOCK_MONOTONIC, &loadStarted);
+
+    struct stat sourceStatus;
+    if (stat(csvPath, &sourceStatus) != 0)
+    {
+        printf("Could not open '%s'.\n", csvPath);
+        return 0;
+    }
+    size_t pathLength = strlen(csvPath);
+    char *cachePath = (char *)malloc(pathLength + 7);
+    if (cachePath == NULL)
+    {
+        printf("Memory allocation failed in loadPlayersFromCsv.\n");
+        return 0;
+    }
+    memcpy(cachePath, csvPath, pathLength);
+    memcpy(cachePath + pathLength, ".cache", 7);
+
+    int skippedRows = 0;
+    int fromCache = loadPlayerCache(playerStore, cachePath, &sourceStatus, &skippedRows);
+    int loaded = fromCache;
+    if (!loaded)
+    {
+        char *mappedCsv = mapFileReadOnly(csvPath, &sourceStatus);
+        if (mappedCsv == NULL)
         {
-            playerRecords[dataIndex].performanceScore = (players[dataIndex].wickets * 2) + (100 - players[dataIndex].economyRate);
+            printf("Could not read players from '%s'.\n", csvPath);
         }
         else
         {
-            playerRecords[dataIndex].performanceScore = ((players[dataIndex].battingAverage * players[dataIndex].strikeRate) / 100.0f) + (players[dataIndex].wickets * 2);
+            madvise(mappedCsv, (size_t)sourceStatus.st_size, MADV_SEQUENTIAL);
+            loaded = parsePlayersCsv(playerStore, mappedCsv, (size_t)sourceStatus.st_size, &skippedRows);
+            munmap(mappedCsv, (size_t)sourceStatus.st_size);
+            if (loaded)
+            {
+                savePlayerCache(playerStore, cachePath, &sourceStatus, skippedRows);
+            }
         }
-        (*loadedPlayerCount)++;
     }
+    free(cachePath);
+
+    clock_gettime(CLOCK_MONOTONIC, &loadFinished);
+    if (loaded)
+    {
+        fprintf(stderr, "Loaded %d players from %s in %.3f s\n", playerStore->count, fromCache ? "cache" : csvPath,
+                (double)(loadFinished.tv_sec - loadStarted.tv_sec) + (double)(loadFinished.tv_nsec - loadStarted.tv_nsec) / 1e9);
+        if (skippedRows > 0)
+        {
+            fprintf(stderr, "Skipped %d malformed rows.\n", skippedRows);
+        }
+    }
+    return loaded;
 }
 
-void mergeRoleIndexSegments(PlayerRecord players[], int indexArray[], int leftStart, int leftMid, int rightEnd)
+
+void mergeRoleIndexSegments(const PlayerStore *playerStore, int indexArray[], int leftStart, int leftMid, int rightEnd)
 {
     int leftSize = leftMid - leftStart + 1;
     int rightSize = rightEnd - leftMid;
@@ -249,7 +1174,7 @@ void mergeRoleIndexSegments(PlayerRecord players[], int indexArray[], int leftSt
 
     while ((leftSegment != NULL && leftPosition < leftSize) && (rightSegment != NULL && rightPosition < rightSize))
     {
-        if (players[leftSegment[leftPosition]].performanceScore >= players[rightSegment[rightPosition]].performanceScore)
+        if (playerStore->performanceScores[leftSegment[leftPosition]] >= playerStore->performanceScores[rightSegment[rightPosition]])
         {
             indexArray[writePosition++] = leftSegment[leftPosition++];
         }
@@ -345,109 +1270,168 @@ void mergeTeamSegmentsByAverage(TeamRecord teams[], int startIndex, int middleIn
     free(rightArray);
 }
 
-void sortRoleIndexArrayByPerformance(PlayerRecord players[], int indexArray[], int startIndex, int endIndex)
+void sortRoleIndexArrayByPerformance(const PlayerStore *playerStore, int indexArray[], int startIndex, int endIndex)
 {
     if (startIndex < endIndex)
     {
         int middleIndex = startIndex + (endIndex - startIndex) / 2;
-        sortRoleIndexArrayByPerformance(players, indexArray, startIndex, middleIndex);
-        sortRoleIndexArrayByPerformance(players, indexArray, middleIndex + 1, endIndex);
-        mergeRoleIndexSegments(players, indexArray, startIndex, middleIndex, endIndex);
+        sortRoleIndexArrayByPerformance(playerStore, indexArray, startIndex, middleIndex);
+        sortRoleIndexArrayByPerformance(playerStore, indexArray, middleIndex + 1, endIndex);
+        mergeRoleIndexSegments(playerStore, indexArray, startIndex, middleIndex, endIndex);
     }
 }
 
-void buildTeamsFromPlayers(TeamRecord teamRecords[], int *loadedTeamCount, PlayerRecord playerRecords[], int loadedPlayerCount)
+int appendIndexToList(int **indexList, int *listCount, int *listCapacity, int playerIndex)
 {
-    *loadedTeamCount = 0;
-    for (int index = 0; index < teamCount; index++)
+    if (*listCount == *listCapacity)
     {
-        teamRecords[index].id = index + 1;
-        strncpy(teamRecords[index].teamName, teams[index], MAX_NAME_LENGTH - 1);
-        teamRecords[index].teamName[MAX_NAME_LENGTH - 1] = '\0';
-        teamRecords[index].totalPlayers = 0;
-        teamRecords[index].averageBattingStrikeRate = 0.0f;
-        teamRecords[index].batsmanCount = 0;
-        teamRecords[index].bowlerCount = 0;
-        teamRecords[index].allrounderCount = 0;
-        (*loadedTeamCount)++;
-    }
-    for (int count = 0; count < loadedPlayerCount; count++)
-    {
-        for (int index = 0; index < *loadedTeamCount; index++)
+        int newCapacity = *listCapacity ? *listCapacity * 2 : INITIAL_INDEX_LIST_CAPACITY;
+        int *grownList = (int *)realloc(*indexList, newCapacity * sizeof(int));
+        if (grownList == NULL)
         {
-            if (strcmp(playerRecords[count].teamName, teamRecords[index].teamName) == 0)
-            {
-                int current = teamRecords[index].totalPlayers;
-                if (current < MAX_PLAYERS_PER_TEAM)
-                {
-                    teamRecords[index].playerIndexes[current] = count;
-                    teamRecords[index].totalPlayers++;
-                }
-                if (strcmp(playerRecords[count].roleName, "Batsman") == 0)
-                {
-                    int position = teamRecords[index].batsmanCount;
-                    if (position < MAX_PLAYERS_PER_TEAM)
-                    {
-                        teamRecords[index].batsmanIndexes[position] = count;
-                        teamRecords[index].batsmanCount++;
-                    }
-                }
-                else if (strcmp(playerRecords[count].roleName, "Bowler") == 0)
-                {
-                    int position = teamRecords[index].bowlerCount;
-                    if (position < MAX_PLAYERS_PER_TEAM)
-                    {
-                        teamRecords[index].bowlerIndexes[position] = count;
-                        teamRecords[index].bowlerCount++;
-                    }
-                }
-                else
-                {
-                    int position = teamRecords[index].allrounderCount;
-                    if (position < MAX_PLAYERS_PER_TEAM)
-                    {
-                        teamRecords[index].allrounderIndexes[position] = count;
-                        teamRecords[index].allrounderCount++;
-                    }
-                }
-                break;
-            }
+            printf("Memory allocation failed in appendIndexToList.\n");
+            return 0;
         }
+        *indexList = grownList;
+        *listCapacity = newCapacity;
     }
-    for (int index = 0; index < *loadedTeamCount; index++)
+    (*indexList)[(*listCount)++] = playerIndex;
+    return 1;
+}
+
+int addPlayerIndexToTeam(TeamRecord *team, const PlayerStore *playerStore, int playerIndex)
+{
+    if (!appendIndexToList(&team->playerIndexes, &team->totalPlayers, &team->playerCapacity, playerIndex))
     {
-        float strikeSum = 0.0f;
-        int eligible = 0;
-        for (int teamIndex = 0; teamIndex < teamRecords[index].totalPlayers; teamIndex++)
-        {
-            int playerIndex = teamRecords[index].playerIndexes[teamIndex];
-            if (strcmp(playerRecords[playerIndex].roleName, "Batsman") == 0 || strcmp(playerRecords[playerIndex].roleName, "All-rounder") == 0)
-            {
-                strikeSum += playerRecords[playerIndex].strikeRate;
-                eligible++;
-            }
-        }
-        if (eligible > 0) 
+        return 0;
+    }
+    if (playerStore->roles[playerIndex] == ROLE_BATSMAN)
+    {
+        return appendIndexToList(&team->batsmanIndexes, &team->batsmanCount, &team->batsmanCapacity, playerIndex);
+    }
+    if (playerStore->roles[playerIndex] == ROLE_BOWLER)
+    {
+        return appendIndexToList(&team->bowlerIndexes, &team->bowlerCount, &team->bowlerCapacity, playerIndex);
+    }
+    return appendIndexToList(&team->allrounderIndexes, &team->allrounderCount, &team->allrounderCapacity, playerIndex);
+}
+
+int compareTeamsByName(const void *firstTeam, const void *secondTeam)
+{
+    return strcmp(((const TeamRecord *)firstTeam)->teamName, ((const TeamRecord *)secondTeam)->teamName);
+}
+
+void freeTeamRecords(TeamRecord teamRecords[], int loadedTeamCount)
+{
+    for (int index = 0; index < loadedTeamCount; index++)
+    {
+        free(teamRecords[index].playerIndexes);
+        free(teamRecords[index].batsmanIndexes);
+        free(teamRecords[index].bowlerIndexes);
+        free(teamRecords[index].allrounderIndexes);
+    }
+    free(teamRecords);
+}
+
+/* Teams are the interned team names, numbered 1..n in name order. Players are grouped with a counting sort on
+   (team id, role): one pass sizes every list, a second scatters the indexes and sums strike rates. Returns NULL if
+   memory runs out. */
+TeamRecord *buildTeamsFromPlayers(int *loadedTeamCount, const PlayerStore *playerStore)
+{
+    int teamTotal = playerStore->teams.nameCount;
+    int slotTotal = teamTotal * ROLE_COUNT;
+    TeamRecord *teamRecords = (TeamRecord *)calloc(teamTotal > 0 ? teamTotal : 1, sizeof(TeamRecord));
+    int *slotCounts = (int *)calloc(slotTotal > 0 ? slotTotal : 1, sizeof(int));
+    int **slotLists = (int **)calloc(slotTotal > 0 ? slotTotal : 1, sizeof(int *));
+    float *strikeSums = (float *)calloc(teamTotal > 0 ? teamTotal : 1, sizeof(float));
+    int *eligibleCounts = (int *)calloc(teamTotal > 0 ? teamTotal : 1, sizeof(int));
+    *loadedTeamCount = 0;
+    int succeeded = teamRecords != NULL && slotCounts != NULL && slotLists != NULL && strikeSums != NULL && eligibleCounts != NULL;
+
+    if (succeeded)
+    {
+        for (int count = 0; count < playerStore->count; count++)
         {
-            teamRecords[index].averageBattingStrikeRate = strikeSum / eligible;
+            slotCounts[playerStore->teamIds[count] * ROLE_COUNT + playerStore->roles[count]]++;
         }
-        else 
+        *loadedTeamCount = teamTotal;
+    }
+    for (int index = 0; index < *loadedTeamCount && succeeded; index++)
+    {
+        TeamRecord *team = &teamRecords[index];
+        int *teamSlotCounts = &slotCounts[index * ROLE_COUNT];
+        strncpy(team->teamName, nameAt(&playerStore->teams, index), MAX_NAME_LENGTH - 1);
+        team->playerCapacity = teamSlotCounts[ROLE_BATSMAN] + teamSlotCounts[ROLE_BOWLER] + teamSlotCounts[ROLE_ALLROUNDER];
+        team->batsmanCapacity = teamSlotCounts[ROLE_BATSMAN];
+        team->bowlerCapacity = teamSlotCounts[ROLE_BOWLER];
+        team->allrounderCapacity = teamSlotCounts[ROLE_ALLROUNDER];
+        team->playerIndexes = (int *)malloc((team->playerCapacity > 0 ? team->playerCapacity : 1) * sizeof(int));
+        team->batsmanIndexes = (int *)malloc((team->batsmanCapacity > 0 ? team->batsmanCapacity : 1) * sizeof(int));
+        team->bowlerIndexes = (int *)malloc((team->bowlerCapacity > 0 ? team->bowlerCapacity : 1) * sizeof(int));
+        team->allrounderIndexes = (int *)malloc((team->allrounderCapacity > 0 ? team->allrounderCapacity : 1) * sizeof(int));
+        succeeded = team->playerIndexes != NULL && team->batsmanIndexes != NULL && team->bowlerIndexes != NULL &&
+                    team->allrounderIndexes != NULL;
+        slotLists[index * ROLE_COUNT + ROLE_BATSMAN] = team->batsmanIndexes;
+        slotLists[index * ROLE_COUNT + ROLE_BOWLER] = team->bowlerIndexes;
+        slotLists[index * ROLE_COUNT + ROLE_ALLROUNDER] = team->allrounderIndexes;
+    }
+
+    if (succeeded)
+    {
+        memset(slotCounts, 0, (slotTotal > 0 ? slotTotal : 1) * sizeof(int));
+        for (int count = 0; count < playerStore->count; count++)
         {
-            teamRecords[index].averageBattingStrikeRate = 0.0f;
+            int teamId = playerStore->teamIds[count];
+            int slot = teamId * ROLE_COUNT + playerStore->roles[count];
+            int eligible = playerStore->roles[count] != ROLE_BOWLER;
+            TeamRecord *team = &teamRecords[teamId];
+            team->playerIndexes[team->totalPlayers++] = count;
+            slotLists[slot][slotCounts[slot]++] = count;
+            strikeSums[teamId] += eligible ? playerStore->strikeRates[count] : 0.0f;
+            eligibleCounts[teamId] += eligible;
         }
-        if (teamRecords[index].batsmanCount > 0) 
+        for (int index = 0; index < *loadedTeamCount; index++)
         {
-            sortRoleIndexArrayByPerformance(playerRecords, teamRecords[index].batsmanIndexes, 0, teamRecords[index].batsmanCount - 1);
+            TeamRecord *team = &teamRecords[index];
+            team->batsmanCount = slotCounts[index * ROLE_COUNT + ROLE_BATSMAN];
+            team->bowlerCount = slotCounts[index * ROLE_COUNT + ROLE_BOWLER];
+            team->allrounderCount = slotCounts[index * ROLE_COUNT + ROLE_ALLROUNDER];
+            team->averageBattingStrikeRate = eligibleCounts[index] > 0 ? strikeSums[index] / eligibleCounts[index] : 0.0f;
+            if (team->batsmanCount > 0)
+            {
+                sortRoleIndexArrayByPerformance(playerStore, team->batsmanIndexes, 0, team->batsmanCount - 1);
+            }
+            if (team->bowlerCount > 0)
+            {
+                sortRoleIndexArrayByPerformance(playerStore, team->bowlerIndexes, 0, team->bowlerCount - 1);
+            }
+            if (team->allrounderCount > 0)
+            {
+                sortRoleIndexArrayByPerformance(playerStore, team->allrounderIndexes, 0, team->allrounderCount - 1);
+            }
         }
-        if (teamRecords[index].bowlerCount > 0) 
+        qsort(teamRecords, *loadedTeamCount, sizeof(TeamRecord), compareTeamsByName);
+        for (int index = 0; index < *loadedTeamCount; index++)
         {
-            sortRoleIndexArrayByPerformance(playerRecords, teamRecords[index].bowlerIndexes, 0, teamRecords[index].bowlerCount - 1);
+            teamRecords[index].id = index + 1;
         }
-        if (teamRecords[index].allrounderCount > 0) 
+    }
+
+    free(slotCounts);
+    free(slotLists);
+    free(strikeSums);
+    free(eligibleCounts);
+    if (!succeeded)
+    {
+        printf("Memory allocation failed in buildTeamsFromPlayers.\n");
+        if (teamRecords != NULL)
         {
-            sortRoleIndexArrayByPerformance(playerRecords, teamRecords[index].allrounderIndexes, 0, teamRecords[index].allrounderCount - 1);
+            freeTeamRecords(teamRecords, *loadedTeamCount);
         }
+        *loadedTeamCount = 0;
+        return NULL;
     }
+    return teamRecords;
 }
 
 int findTeamIndexById(TeamRecord teamRecords[], int teamId, int loadedTeamCount)
@@ -473,7 +1457,7 @@ int findTeamIndexById(TeamRecord teamRecords[], int teamId, int loadedTeamCount)
     return -1;
 }
 
-void showPlayersForTeamId(TeamRecord teams[], PlayerRecord players[], int teamId, int loadedTeamCount)
+void showPlayersForTeamId(TeamRecord teams[], const PlayerStore *playerStore, int teamId, int loadedTeamCount)
 {
     int foundIndex = findTeamIndexById(teams, teamId, loadedTeamCount);
     if (foundIndex == -1)
@@ -489,15 +1473,15 @@ void showPlayersForTeamId(TeamRecord teams[], PlayerRecord players[], int teamId
     {
         int playerIndex = teams[foundIndex].playerIndexes[teamPlayerPos];
         printf("%-5d %-20s %-15s %-10d %-10.2f %-10.2f %-10d %-10.2f %-10.2f\n",
-               players[playerIndex].id,
-               players[playerIndex].fullName,
-               players[playerIndex].roleName,
-               players[playerIndex].runs,
-               players[playerIndex].battingAvg,
-               players[playerIndex].strikeRate,
-               players[playerIndex].wickets,
-               players[playerIndex].economy,
-               players[playerIndex].performanceScore);
+               playerStore->ids[playerIndex],
+               nameAt(&playerStore->names, playerStore->nameIds[playerIndex]),
+               roleNames[playerStore->roles[playerIndex]],
+               playerStore->runs[playerIndex],
+               playerStore->battingAvgs[playerIndex],
+               playerStore->strikeRates[playerIndex],
+               playerStore->wickets[playerIndex],
+               playerStore->economies[playerIndex],
+               playerStore->performanceScores[playerIndex]);
     }
     printf("================================================================================================================\n");
     printf("Total Players: %d\n", teams[foundIndex].totalPlayers);
@@ -550,7 +1534,7 @@ void showTeamsOrderedByStrikeRate(TeamRecord teams[], int loadedTeamCount)
     free(copyOfTeams);
 }
 
-void showTopKPlayersForRoleInTeam(TeamRecord teams[], PlayerRecord players[], int loadedTeamCount)
+void showTopKPlayersForRoleInTeam(TeamRecord teams[], const PlayerStore *playerStore, int loadedTeamCount)
 {
     printf("\nEnter Team ID: ");
     int inputTeamId = readValidatedInteger();
@@ -608,15 +1592,15 @@ void showTopKPlayersForRoleInTeam(TeamRecord teams[], PlayerRecord players[], in
     {
         int playerIndex = selectedList[resultPosition];
         printf("%-5d %-20s %-15s %-10d %-10.2f %-10.2f %-10d %-10.2f %-10.2f\n",
-               players[playerIndex].id,
-               players[playerIndex].fullName,
-               players[playerIndex].roleName,
-               players[playerIndex].runs,
-               players[playerIndex].battingAvg,
-               players[playerIndex].strikeRate,
-               players[playerIndex].wickets,
-               players[playerIndex].economy,
-               players[playerIndex].performanceScore);
+               playerStore->ids[playerIndex],
+               nameAt(&playerStore->names, playerStore->nameIds[playerIndex]),
+               roleNames[playerStore->roles[playerIndex]],
+               playerStore->runs[playerIndex],
+               playerStore->battingAvgs[playerIndex],
+               playerStore->strikeRates[playerIndex],
+               playerStore->wickets[playerIndex],
+               playerStore->economies[playerIndex],
+               playerStore->performanceScores[playerIndex]);
     }
 }
 
@@ -627,27 +1611,27 @@ void swapHeapNodes(TeamPlayerHeapNode *firstNode, TeamPlayerHeapNode *secondNode
     *secondNode = temporaryNode;
 }
 
-void heapSiftDown(TeamPlayerHeapNode heap[], int heapSize, int currentIndex, PlayerRecord players[])
+void heapSiftDown(TeamPlayerHeapNode heap[], int heapSize, int currentIndex, const PlayerStore *playerStore)
 {
     int largest = currentIndex;
     int leftChild = 2 * currentIndex + 1;
     int rightChild = 2 * currentIndex + 2;
-    if (leftChild < heapSize && players[heap[leftChild].playerIndex].performanceScore > players[heap[largest].playerIndex].performanceScore)
+    if (leftChild < heapSize && playerStore->performanceScores[heap[leftChild].playerIndex] > playerStore->performanceScores[heap[largest].playerIndex])
     {
         largest = leftChild;
     }
-    if (rightChild < heapSize && players[heap[rightChild].playerIndex].performanceScore > players[heap[largest].playerIndex].performanceScore)
+    if (rightChild < heapSize && playerStore->performanceScores[heap[rightChild].playerIndex] > playerStore->performanceScores[heap[largest].playerIndex])
     {
         largest = rightChild;
     }
     if (largest != currentIndex)
     {
         swapHeapNodes(&heap[currentIndex], &heap[largest]);
-        heapSiftDown(heap, heapSize, largest, players);
+        heapSiftDown(heap, heapSize, largest, playerStore);
     }
 }
 
-void heapInsertNode(TeamPlayerHeapNode heap[], int *heapSize, TeamPlayerHeapNode nodeToInsert, PlayerRecord players[])
+void heapInsertNode(TeamPlayerHeapNode heap[], int *heapSize, TeamPlayerHeapNode nodeToInsert, const PlayerStore *playerStore)
 {
     int insertPosition = *heapSize;
     int current = insertPosition;
@@ -656,7 +1640,7 @@ void heapInsertNode(TeamPlayerHeapNode heap[], int *heapSize, TeamPlayerHeapNode
     while (current > 0)
     {
         int parent = (current - 1) / 2;
-        if (players[heap[current].playerIndex].performanceScore > players[heap[parent].playerIndex].performanceScore)
+        if (playerStore->performanceScores[heap[current].playerIndex] > playerStore->performanceScores[heap[parent].playerIndex])
         {
             swapHeapNodes(&heap[current], &heap[parent]);
             current = parent;
@@ -668,19 +1652,19 @@ void heapInsertNode(TeamPlayerHeapNode heap[], int *heapSize, TeamPlayerHeapNode
     }
 }
 
-TeamPlayerHeapNode heapPopMaxNode(TeamPlayerHeapNode heap[], int *heapSize, PlayerRecord players[])
+TeamPlayerHeapNode heapPopMaxNode(TeamPlayerHeapNode heap[], int *heapSize, const PlayerStore *playerStore)
 {
     TeamPlayerHeapNode root = heap[0];
     heap[0] = heap[*heapSize - 1];
     (*heapSize)--;
     if (*heapSize > 0) 
     {
-        heapSiftDown(heap, *heapSize, 0, players);
+        heapSiftDown(heap, *heapSize, 0, playerStore);
     }
     return root;
 }
 
-void showAllPlayersByRoleAcrossTeams(TeamRecord teams[], PlayerRecord players[], int roleChoice, int loadedTeamCount)
+void showAllPlayersByRoleAcrossTeams(TeamRecord teams[], const PlayerStore *playerStore, int roleChoice, int loadedTeamCount)
 {
     char roleLabel[MAX_NAME_LENGTH];
     if (roleChoice == 1) 
@@ -730,7 +1714,7 @@ void showAllPlayersByRoleAcrossTeams(TeamRecord teams[], PlayerRecord players[],
             node.playerIndex = roleList[0];
             node.teamIndex = teamLoop;
             node.indexInRoleList = 0;
-            heapInsertNode(mergeHeap, &heapSize, node, players);
+            heapInsertNode(mergeHeap, &heapSize, node, playerStore);
         }
     }
     if (totalRolePlayers == 0)
@@ -745,20 +1729,20 @@ void showAllPlayersByRoleAcrossTeams(TeamRecord teams[], PlayerRecord players[],
     printf("==================================================================================================================\n");
     while (heapSize > 0)
     {
-        TeamPlayerHeapNode bestNode = heapPopMaxNode(mergeHeap, &heapSize, players);
+        TeamPlayerHeapNode bestNode = heapPopMaxNode(mergeHeap, &heapSize, playerStore);
         int playerIndex = bestNode.playerIndex;
         int teamIndex = bestNode.teamIndex;
         int nextIndex = bestNode.indexInRoleList + 1;
         printf("%-5d %-20s %-15s %-15s %-10d %-10.2f %-10.2f %-10d %-10.2f\n",
-               players[playerIndex].id,
-               players[playerIndex].fullName,
+               playerStore->ids[playerIndex],
+               nameAt(&playerStore->names, playerStore->nameIds[playerIndex]),
                teams[teamIndex].teamName,
-               players[playerIndex].roleName,
-               players[playerIndex].runs,
-               players[playerIndex].battingAvg,
-               players[playerIndex].strikeRate,
-               players[playerIndex].wickets,
-               players[playerIndex].performanceScore);
+               roleNames[playerStore->roles[playerIndex]],
+               playerStore->runs[playerIndex],
+               playerStore->battingAvgs[playerIndex],
+               playerStore->strikeRates[playerIndex],
+               playerStore->wickets[playerIndex],
+               playerStore->performanceScores[playerIndex]);
         int *roleList = NULL;
         int roleCountForThisTeam = 0;
         if (roleChoice == 1) 
@@ -782,20 +1766,15 @@ void showAllPlayersByRoleAcrossTeams(TeamRecord teams[], PlayerRecord players[],
             newNode.playerIndex = roleList[nextIndex];
             newNode.teamIndex = teamIndex;
             newNode.indexInRoleList = nextIndex;
-            heapInsertNode(mergeHeap, &heapSize, newNode, players);
+            heapInsertNode(mergeHeap, &heapSize, newNode, playerStore);
         }
     }
     printf("==================================================================================================================\n");
     free(mergeHeap);
 }
 
-void addNewPlayerToTeam(TeamRecord teams[], PlayerRecord players[], int *loadedPlayerCount, int loadedTeamCount)
+void addNewPlayerToTeam(TeamRecord teams[], PlayerStore *playerStore, int loadedTeamCount)
 {
-    if (*loadedPlayerCount >= MAX_PLAYERS_PER_TEAM * loadedTeamCount)
-    {
-        printf("Cannot add more players: maximum total capacity reached.\n");
-        return;
-    }
     printf("\nEnter Team ID to add player: ");
     int chosenTeamId = readValidatedInteger();
     int teamIndex = findTeamIndexById(teams, chosenTeamId, loadedTeamCount);
@@ -804,108 +1783,78 @@ void addNewPlayerToTeam(TeamRecord teams[], PlayerRecord players[], int *loadedP
         printf("Error: Team with ID %d not found.\n", chosenTeamId);
         return;
     }
-    if (teams[teamIndex].totalPlayers >= MAX_PLAYERS_PER_TEAM)
-    {
-        printf("Cannot add more players to team %s: team is full (max %d players).\n", teams[teamIndex].teamName, MAX_PLAYERS_PER_TEAM);
-        return;
-    }
-    PlayerRecord newRecord;
+    Player newRecord;
+    char fullName[MAX_NAME_LENGTH];
     printf("Enter Player ID: ");
     newRecord.id = readValidatedInteger();
     printf("Enter Name: ");
-    if (fgets(newRecord.fullName, sizeof(newRecord.fullName), stdin) == NULL) 
+    if (fgets(fullName, sizeof(fullName), stdin) == NULL) 
     { 
         clearerr(stdin); 
         printf("Failed to read name.\n"); 
         return; 
     }
-    int lengthName = (int)strlen(newRecord.fullName);
-    if (lengthName > 0 && newRecord.fullName[lengthName - 1] == '\n') 
+    int lengthName = (int)strlen(fullName);
+    if (lengthName > 0 && fullName[lengthName - 1] == '\n') 
     {
-        newRecord.fullName[lengthName - 1] = '\0';
+        fullName[lengthName - 1] = '\0';
     }
+    newRecord.name = fullName;
     printf("Enter Role (1-Batsman, 2-Bowler, 3-All-rounder): ");
     int roleChoice = readValidatedInteger();
     if (roleChoice == 1) 
     {
-        strncpy(newRecord.roleName, "Batsman", MAX_NAME_LENGTH);
+        newRecord.role = "Batsman";
     }
     else if (roleChoice == 2) 
     {
-        strncpy(newRecord.roleName, "Bowler", MAX_NAME_LENGTH);
+        newRecord.role = "Bowler";
     }
     else 
     {
-        strncpy(newRecord.roleName, "All-rounder", MAX_NAME_LENGTH);
+        newRecord.role = "All-rounder";
     }
     printf("Enter Total Runs (integer): ");
-    newRecord.runs = readValidatedInteger();
+    newRecord.totalRuns = readValidatedInteger();
     printf("Enter Batting Average (float): ");
-    newRecord.battingAvg = readValidatedFloat();
+    newRecord.battingAverage = readValidatedFloat();
     printf("Enter Strike Rate (float): ");
     newRecord.strikeRate = readValidatedFloat();
     printf("Enter Wickets (integer): ");
     newRecord.wickets = readValidatedInteger();
     printf("Enter Economy Rate (float): ");
-    newRecord.economy = readValidatedFloat();
-    strncpy(newRecord.teamName, teams[teamIndex].teamName, MAX_NAME_LENGTH - 1);
-    newRecord.teamName[MAX_NAME_LENGTH - 1] = '\0';
-    if (strcmp(newRecord.roleName, "Batsman") == 0)
+    newRecord.economyRate = readValidatedFloat();
+    newRecord.team = teams[teamIndex].teamName;
+    int appendIndex = appendPlayer(playerStore, &newRecord);
+    if (appendIndex < 0)
     {
-        newRecord.performanceScore = (newRecord.battingAvg * newRecord.strikeRate) / 100.0f;
+        return;
     }
-    else if (strcmp(newRecord.roleName, "Bowler") == 0)
+    computePerformanceScores(playerStore, appendIndex, appendIndex + 1);
+    if (!addPlayerIndexToTeam(&teams[teamIndex], playerStore, appendIndex))
     {
-        newRecord.performanceScore = (newRecord.wickets * 2) + (100 - newRecord.economy);
+        return;
     }
-    else
+    if (playerStore->roles[appendIndex] == ROLE_BATSMAN)
     {
-        newRecord.performanceScore = ((newRecord.battingAvg * newRecord.strikeRate) / 100.0f) + (newRecord.wickets * 2);
+        sortRoleIndexArrayByPerformance(playerStore, teams[teamIndex].batsmanIndexes, 0, teams[teamIndex].batsmanCount - 1);
     }
-    int appendIndex = *loadedPlayerCount;
-    players[appendIndex] = newRecord;
-    (*loadedPlayerCount)++;
-    int teamPlayerPosition = teams[teamIndex].totalPlayers;
-    teams[teamIndex].playerIndexes[teamPlayerPosition] = appendIndex;
-    teams[teamIndex].totalPlayers++;
-    if (strcmp(newRecord.roleName, "Batsman") == 0)
+    else if (playerStore->roles[appendIndex] == ROLE_BOWLER)
     {
-        int pos = teams[teamIndex].batsmanCount;
-        if (pos < MAX_PLAYERS_PER_TEAM) 
-        { 
-            teams[teamIndex].batsmanIndexes[pos] = appendIndex; 
-            teams[teamIndex].batsmanCount++; 
-            sortRoleIndexArrayByPerformance(players, teams[teamIndex].batsmanIndexes, 0, teams[teamIndex].batsmanCount - 1); 
-        }
-    }
-    else if (strcmp(newRecord.roleName, "Bowler") == 0)
-    {
-        int pos = teams[teamIndex].bowlerCount;
-        if (pos < MAX_PLAYERS_PER_TEAM) 
-        { 
-            teams[teamIndex].bowlerIndexes[pos] = appendIndex; 
-            teams[teamIndex].bowlerCount++; 
-            sortRoleIndexArrayByPerformance(players, teams[teamIndex].bowlerIndexes, 0, teams[teamIndex].bowlerCount - 1); 
-        }
+        sortRoleIndexArrayByPerformance(playerStore, teams[teamIndex].bowlerIndexes, 0, teams[teamIndex].bowlerCount - 1);
     }
     else
     {
-        int pos = teams[teamIndex].allrounderCount;
-        if (pos < MAX_PLAYERS_PER_TEAM) 
-        { 
-            teams[teamIndex].allrounderIndexes[pos] = appendIndex; 
-            teams[teamIndex].allrounderCount++; 
-            sortRoleIndexArrayByPerformance(players, teams[teamIndex].allrounderIndexes, 0, teams[teamIndex].allrounderCount - 1); 
-        }
+        sortRoleIndexArrayByPerformance(playerStore, teams[teamIndex].allrounderIndexes, 0, teams[teamIndex].allrounderCount - 1);
     }
     float strikeSum = 0.0f;
     int eligibleCount = 0;
     for (int pos = 0; pos < teams[teamIndex].totalPlayers; ++pos)
     {
         int pIndex = teams[teamIndex].playerIndexes[pos];
-        if (strcmp(players[pIndex].roleName, "Batsman") == 0 || strcmp(players[pIndex].roleName, "All-rounder") == 0)
+        if (playerStore->roles[pIndex] != ROLE_BOWLER)
         {
-            strikeSum += players[pIndex].strikeRate;
+            strikeSum += playerStore->strikeRates[pIndex];
             eligibleCount++;
         }
     }
@@ -920,30 +1869,38 @@ void addNewPlayerToTeam(TeamRecord teams[], PlayerRecord players[], int *loadedP
     printf("Player added successfully to Team %s!\n", teams[teamIndex].teamName);
 }
 
-int main()
+int main(int argc, char *argv[])
 {
-    int initialPlayerCapacity = playerCount + MAX_PLAYERS_PER_TEAM * teamCount;
-    PlayerRecord *playersList = (PlayerRecord *)malloc(initialPlayerCapacity * sizeof(PlayerRecord));
-    if (playersList == NULL)
+    PlayerStore playersList;
+    memset(&playersList, 0, sizeof(playersList));
+
+    if (argc > 2)
     {
-        fprintf(stderr, "Memory allocation failed for playersList\n");
+        fprintf(stderr, "Usage: %s [players.csv]\n", argv[0]);
         return 1;
     }
+    if (argc == 2)
+    {
+        if (!loadPlayersFromCsv(&playersList, argv[1]))
+        {
+            freePlayerStore(&playersList);
+            return 1;
+        }
+    }
+    else
+    {
+        populatePlayersFromData(&playersList);
+    }
 
-    TeamRecord *teamsList = (TeamRecord *)malloc(teamCount * sizeof(TeamRecord));
+    int loadedTeamCount = 0;
+    TeamRecord *teamsList = buildTeamsFromPlayers(&loadedTeamCount, &playersList);
     if (teamsList == NULL)
     {
         fprintf(stderr, "Memory allocation failed for teamsList\n");
-        free(playersList);
+        freePlayerStore(&playersList);
         return 1;
     }
 
-    int loadedPlayerCount = 0;
-    int loadedTeamCount = 0;
-
-    populatePlayersFromData(playersList, &loadedPlayerCount);
-    buildTeamsFromPlayers(teamsList, &loadedTeamCount, playersList, loadedPlayerCount);
-
     int menuChoice = 0;
 
     do
@@ -964,13 +1921,13 @@ int main()
 
         if (menuChoice == 1)
         {
-            addNewPlayerToTeam(teamsList, playersList, &loadedPlayerCount, loadedTeamCount);
+            addNewPlayerToTeam(teamsList, &playersList, loadedTeamCount);
         }
         else if (menuChoice == 2)
         {
             printf("\nEnter Team ID: ");
             int inputTeamId = readValidatedInteger();
-            showPlayersForTeamId(teamsList, playersList, inputTeamId, loadedTeamCount);
+            showPlayersForTeamId(teamsList, &playersList, inputTeamId, loadedTeamCount);
         }
         else if (menuChoice == 3)
         {
@@ -978,7 +1935,7 @@ int main()
         }
         else if (menuChoice == 4)
         {
-            showTopKPlayersForRoleInTeam(teamsList, playersList, loadedTeamCount);
+            showTopKPlayersForRoleInTeam(teamsList, &playersList, loadedTeamCount);
         }
         else if (menuChoice == 5)
         {
@@ -987,7 +1944,7 @@ int main()
             if (roleChoice < 1 || roleChoice > 3)
                 printf("Error: Invalid role choice.\n");
             else
-                showAllPlayersByRoleAcrossTeams(teamsList, playersList, roleChoice, loadedTeamCount);
+                showAllPlayersByRoleAcrossTeams(teamsList, &playersList, roleChoice, loadedTeamCount);
         }
         else if (menuChoice == 6)
         {
@@ -1000,8 +1957,8 @@ int main()
 
     } while (menuChoice != 6);
 
-    free(playersList);
-    free(teamsList);
+    freePlayerStore(&playersList);
+    freeTeamRecords(teamsList, loadedTeamCount);
 
     return 0;
 }
@@ -1,6 +1,17 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <fnmatch.h>
+#include <dirent.h>
+#include <errno.h>
+#include <limits.h>
+#include <sys/stat.h>
 
 #define MAX_BLOCKS_PER_FILE 100
 #define MAX_INPUT_LENGTH 80
@@ -8,6 +19,56 @@
 #define MAX_FILENAME_LENGTH 51
 #define TOTAL_DISK_BLOCKS 1024
 #define MAX_PATH_LENGTH 1000
+#define INITIAL_STACK_CAPACITY 64
+#define FINGERPRINT_BUCKETS 2048
+#define COMPRESSION_CHUNK_BLOCKS 8
+#define COMPRESSION_CHUNK_SIZE (COMPRESSION_CHUNK_BLOCKS * BLOCK_SIZE)
+#define MAX_CHUNKS_PER_FILE ((MAX_BLOCKS_PER_FILE + COMPRESSION_CHUNK_BLOCKS - 1) / COMPRESSION_CHUNK_BLOCKS)
+#define MAX_FILE_SIZE (MAX_BLOCKS_PER_FILE * BLOCK_SIZE)
+#define COMPRESSION_HASH_BITS 12
+#define COMPRESSION_MIN_MATCH 4
+#define COMPRESSION_MAX_OFFSET 65535
+#define JOURNAL_RECORD_MAGIC 0x4C4E524AU
+#define JOURNAL_HEADER_SIZE 21
+#define JOURNAL_GROUP_COMMIT_RECORDS 32
+#define JOURNAL_GROUP_COMMIT_SECONDS 1
+#define JOURNAL_CHECKPOINT_BYTES (4L * 1024 * 1024)
+#define IMAGE_MAGIC "VFSIMG02"
+#define LEGACY_IMAGE_MAGIC "VFSIMG01"
+#define IMAGE_MAGIC_LENGTH 8
+#define IMAGE_NODE_HEADER_SIZE 20
+#define LEGACY_IMAGE_NODE_HEADER_SIZE 12
+#define BLOCK_CACHE_BATCH 16
+#define BENCH_FILES_PER_WORKER 8
+#define BENCH_FILE_SIZE (4 * BLOCK_SIZE)
+#define STRESS_NAME_COUNT 3
+#define STRESS_MAX_DEPTH 3
+#define LOCK_MODE_NONE 0
+#define LOCK_MODE_READ 1
+#define LOCK_MODE_WRITE 2
+#define LOCK_MODE_EXCLUSIVE 3
+#define LOCK_MODE_SESSIONS 4
+#define NO_INODE 0U
+#define INODE_SEGMENT_BITS 12
+#define INODE_SEGMENT_SIZE (1U << INODE_SEGMENT_BITS)
+#define MAX_INODE_SEGMENTS (1U << (32 - INODE_SEGMENT_BITS))
+#define NAME_ARENA_CHUNK_BITS 16
+#define NAME_ARENA_CHUNK_SIZE (1U << NAME_ARENA_CHUNK_BITS)
+#define MAX_NAME_ARENA_CHUNKS (1U << (32 - NAME_ARENA_CHUNK_BITS))
+#define MAX_INTERNED_NAME_LENGTH (MAX_FILENAME_LENGTH - 1)
+#define INITIAL_NAME_BUCKETS 256
+#define INITIAL_DIRECTORY_INDEX_SLOTS 8
+#define ORDER_NONE 0
+#define ORDER_BY_SIZE 1
+#define ORDER_BY_TIME 2
+#define IMPORT_BATCH_FILES 256
+#define IMPORT_BATCH_BYTES (4 * 1024 * 1024)
+#define IMPORT_BLOCK_BATCH 256
+#define IMPORT_MAX_HASH_THREADS 8
+#define IMPORT_STREAM_BUFFER (1 << 20)
+#define TAR_BLOCK_SIZE 512
+#define TAR_NAME_LENGTH 100
+#define TAR_PREFIX_LENGTH 155
 
 typedef struct DiskBlock
 {
@@ -16,591 +77,4427 @@ typedef struct DiskBlock
     struct DiskBlock *next;
 } DiskBlock;
 
+typedef struct ChunkExtent
+{
+    int storedSize;
+    int firstBlock;
+} ChunkExtent;
+
+/* Sized for the data it maps when a file is written; empty files have none. */
+typedef struct FileBlockMap
+{
+    int chunkCount;
+    int blockCapacity;
+    int *allocatedBlocks;
+    ChunkExtent chunks[];
+} FileBlockMap;
+
+/* indexSlots is an open-addressed name index over the children; orderedChildren caches the last ls sort until the folder changes.
+   activeSessions counts the sessions whose working directory is this folder or one below it. */
+typedef struct DirectoryRecord
+{
+    pthread_rwlock_t lock;
+    uint32_t activeSessions;
+    uint32_t childCount;
+    uint32_t indexCapacity;
+    uint32_t *indexSlots;
+    pthread_mutex_t orderMutex;
+    int orderKey;
+    uint32_t *orderedChildren;
+} DirectoryRecord;
+
+/* Links are inode numbers into the segmented inode table; siblings form a circular doubly linked list. The name lives in the interned name arena. */
 typedef struct Node
 {
-    char name[MAX_FILENAME_LENGTH];
-    int isFolder;
-    struct Node *parent;
-    struct Node *nextSibling;
-    struct Node *firstChild;
-    int allocatedBlocks[MAX_BLOCKS_PER_FILE];
+    uint32_t inodeNumber;
+    uint32_t nameId;
+    uint32_t parent;
+    uint32_t nextSibling;
+    uint32_t previousSibling;
+    uint32_t firstChild;
     int dataSize;
-    int blockCount;
+    uint32_t modifiedTime;
+    uint32_t changedTime;
+    uint16_t blockCount;
+    uint8_t isFolder;
+    uint8_t compressionEnabled;
+    union
+    {
+        FileBlockMap *blockMap;
+        DirectoryRecord *directory;
+    };
 } Node;
 
+typedef struct NameEntry
+{
+    uint32_t referenceCount;
+    uint32_t nextEntry;
+    uint8_t length;
+    char text[];
+} NameEntry;
+
 char diskMemory[TOTAL_DISK_BLOCKS][BLOCK_SIZE];
 DiskBlock *freeBlockListHead = NULL;
 Node *rootDirectory = NULL;
-Node *currentDirectory = NULL;
+_Thread_local Node *currentDirectory = NULL;
+_Thread_local int sessionHasExclusiveAccess = 0;
+_Thread_local int threadBlockCache[IMPORT_BLOCK_BATCH];
+_Thread_local int threadBlockCacheLimit = BLOCK_CACHE_BATCH;
+_Thread_local int threadBlockCacheCount = 0;
+_Thread_local int threadBlockCachePosition = 0;
+pthread_rwlock_t vfsBarrierLock = PTHREAD_RWLOCK_INITIALIZER;
+pthread_mutex_t allocatorMutex = PTHREAD_MUTEX_INITIALIZER;
+pthread_mutex_t dedupMutex = PTHREAD_MUTEX_INITIALIZER;
+pthread_mutex_t journalMutex = PTHREAD_MUTEX_INITIALIZER;
+int checkpointRequested = 0;
+Node *inodeSegments[MAX_INODE_SEGMENTS];
+uint32_t nextUnusedInode = 1;
+uint32_t freeInodeHead = NO_INODE;
+uint32_t liveInodeCount = 0;
+pthread_mutex_t inodeMutex = PTHREAD_MUTEX_INITIALIZER;
+char *nameArenaChunks[MAX_NAME_ARENA_CHUNKS];
+uint32_t nameArenaChunkUsed[MAX_NAME_ARENA_CHUNKS];
+uint32_t nameArenaChunkCount = 0;
+long nameArenaBytes = 0;
+uint32_t *nameBuckets = NULL;
+uint32_t nameBucketCount = 0;
+uint32_t internedNameCount = 0;
+uint32_t freeNameByLength[MAX_INTERNED_NAME_LENGTH + 1];
+pthread_mutex_t nameMutex = PTHREAD_MUTEX_INITIALIZER;
+int freeBlockCount = 0;
+int dedupEnabled = 0;
+int blockReferenceCount[TOTAL_DISK_BLOCKS];
+uint64_t blockFingerprint[TOTAL_DISK_BLOCKS];
+char blockIndexed[TOTAL_DISK_BLOCKS];
+int fingerprintNextBlock[TOTAL_DISK_BLOCKS];
+int fingerprintBucketHead[FINGERPRINT_BUCKETS];
+long logicalBlockCount = 0;
 
-void initializeFreeBlocks()
+typedef enum JournalRecordType
 {
-    DiskBlock *prevBlock = NULL;
+    JOURNAL_MKDIR = 1,
+    JOURNAL_CREATE,
+    JOURNAL_WRITE,
+    JOURNAL_REMOVE_FILE,
+    JOURNAL_REMOVE_DIRECTORY,
+    JOURNAL_REMOVE_TREE,
+    JOURNAL_COPY,
+    JOURNAL_COMPRESS,
+    JOURNAL_DEDUP
+} JournalRecordType;
 
-    for (int index = 0; index < TOTAL_DISK_BLOCKS; index++)
+FILE *journalFile = NULL;
+char imagePath[MAX_PATH_LENGTH];
+char journalPath[MAX_PATH_LENGTH + 16];
+unsigned char *journalBuffer = NULL;
+size_t journalBufferLength = 0;
+size_t journalBufferCapacity = 0;
+size_t journalRecordStart = 0;
+int journalRecordBroken = 0;
+int journalPendingRecords = 0;
+time_t journalOldestPendingTime = 0;
+pthread_cond_t journalPendingCondition = PTHREAD_COND_INITIALIZER;
+pthread_t journalCommitter;
+int journalCommitterRunning = 0;
+long journalCommittedBytes = 0;
+uint64_t journalNextSequence = 1;
+
+void journalBeginRecord(JournalRecordType type);
+void journalAppendPath(Node *directory, const char *name);
+void journalAppendBytes(const void *bytes, uint32_t length);
+void journalAppendByte(unsigned char value);
+void journalAppendTimes(const Node *node);
+void journalEndRecord();
+
+uint32_t hashName(const char *name, size_t length)
+{
+    uint32_t hash = 2166136261U;
+    for (size_t index = 0; index < length; index++)
     {
-        DiskBlock *newBlock = (DiskBlock *)malloc(sizeof(DiskBlock));
-        if (newBlock == NULL)
+        hash = (hash ^ (unsigned char)name[index]) * 16777619U;
+    }
+    return hash;
+}
+
+NameEntry *nameEntryAt(uint32_t nameId)
+{
+    return (NameEntry *)(nameArenaChunks[nameId >> NAME_ARENA_CHUNK_BITS] + (nameId & (NAME_ARENA_CHUNK_SIZE - 1)));
+}
+
+uint32_t nameEntrySize(int length)
+{
+    return (uint32_t)((offsetof(NameEntry, text) + length + 1 + 3) & ~(size_t)3);
+}
+
+const char *nodeName(const Node *node)
+{
+    return nameEntryAt(node->nameId)->text;
+}
+
+int growNameBuckets()
+{
+    uint32_t newBucketCount = nameBucketCount ? nameBucketCount * 2 : INITIAL_NAME_BUCKETS;
+    uint32_t *newBuckets = (uint32_t *)calloc(newBucketCount, sizeof(uint32_t));
+    if (newBuckets == NULL)
+    {
+        return 0;
+    }
+    for (uint32_t chunk = 0; chunk < nameArenaChunkCount; chunk++)
+    {
+        uint32_t offset = chunk == 0 ? sizeof(uint32_t) : 0;
+        while (offset < nameArenaChunkUsed[chunk])
         {
-            printf("Memory allocation failed");
-            return;
+            uint32_t nameId = (chunk << NAME_ARENA_CHUNK_BITS) | offset;
+            NameEntry *entry = nameEntryAt(nameId);
+            if (entry->referenceCount > 0)
+            {
+                uint32_t bucket = hashName(entry->text, entry->length) & (newBucketCount - 1);
+                entry->nextEntry = newBuckets[bucket];
+                newBuckets[bucket] = nameId;
+            }
+            offset += nameEntrySize(entry->length);
         }
+    }
+    free(nameBuckets);
+    nameBuckets = newBuckets;
+    nameBucketCount = newBucketCount;
+    return 1;
+}
 
-        newBlock->blockIndex = index;
-        newBlock->next = NULL;
-        newBlock->previous = prevBlock;
+uint32_t carveNameEntry(int length)
+{
+    uint32_t entrySize = nameEntrySize(length);
+    if (nameArenaChunkCount == 0 || nameArenaChunkUsed[nameArenaChunkCount - 1] + entrySize > NAME_ARENA_CHUNK_SIZE)
+    {
+        if (nameArenaChunkCount == MAX_NAME_ARENA_CHUNKS)
+        {
+            return 0;
+        }
+        nameArenaChunks[nameArenaChunkCount] = (char *)malloc(NAME_ARENA_CHUNK_SIZE);
+        if (nameArenaChunks[nameArenaChunkCount] == NULL)
+        {
+            return 0;
+        }
+        /* Offset 0 of the first chunk is never handed out so that 0 can end hash chains and free lists. */
+        nameArenaChunkUsed[nameArenaChunkCount] = nameArenaChunkCount == 0 ? sizeof(uint32_t) : 0;
+        nameArenaChunkCount++;
+    }
+    uint32_t chunk = nameArenaChunkCount - 1;
+    uint32_t nameId = (chunk << NAME_ARENA_CHUNK_BITS) | nameArenaChunkUsed[chunk];
+    nameArenaChunkUsed[chunk] += entrySize;
+    nameArenaBytes += entrySize;
+    return nameId;
+}
 
-        if (prevBlock)
+uint32_t internName(const char *name)
+{
+    size_t length = strlen(name);
+    if (length > MAX_INTERNED_NAME_LENGTH)
+    {
+        printf("Name too long (max %d characters).\n", MAX_INTERNED_NAME_LENGTH);
+        return 0;
+    }
+    uint32_t hash = hashName(name, length);
+
+    pthread_mutex_lock(&nameMutex);
+    if (nameBucketCount == 0 && !growNameBuckets())
+    {
+        pthread_mutex_unlock(&nameMutex);
+        return 0;
+    }
+    for (uint32_t nameId = nameBuckets[hash & (nameBucketCount - 1)]; nameId != 0; nameId = nameEntryAt(nameId)->nextEntry)
+    {
+        NameEntry *entry = nameEntryAt(nameId);
+        if (entry->length == length && memcmp(entry->text, name, length) == 0)
         {
-            prevBlock->next = newBlock;
+            entry->referenceCount++;
+            pthread_mutex_unlock(&nameMutex);
+            return nameId;
         }
-        else
+    }
+
+    uint32_t nameId = freeNameByLength[length];
+    if (nameId != 0)
+    {
+        freeNameByLength[length] = nameEntryAt(nameId)->nextEntry;
+    }
+    else if ((nameId = carveNameEntry((int)length)) == 0)
+    {
+        pthread_mutex_unlock(&nameMutex);
+        return 0;
+    }
+    NameEntry *entry = nameEntryAt(nameId);
+    entry->referenceCount = 1;
+    entry->length = (uint8_t)length;
+    memcpy(entry->text, name, length + 1);
+    uint32_t bucket = hash & (nameBucketCount - 1);
+    entry->nextEntry = nameBuckets[bucket];
+    nameBuckets[bucket] = nameId;
+    if (++internedNameCount > nameBucketCount * 2)
+    {
+        growNameBuckets();
+    }
+    pthread_mutex_unlock(&nameMutex);
+    return nameId;
+}
+
+void releaseName(uint32_t nameId)
+{
+    pthread_mutex_lock(&nameMutex);
+    NameEntry *entry = nameEntryAt(nameId);
+    if (--entry->referenceCount == 0)
+    {
+        uint32_t *link = &nameBuckets[hashName(entry->text, entry->length) & (nameBucketCount - 1)];
+        while (*link != nameId)
         {
-            freeBlockListHead = newBlock;
+            link = &nameEntryAt(*link)->nextEntry;
         }
+        *link = entry->nextEntry;
+        entry->nextEntry = freeNameByLength[entry->length];
+        freeNameByLength[entry->length] = nameId;
+        internedNameCount--;
+    }
+    pthread_mutex_unlock(&nameMutex);
+}
 
-        prevBlock = newBlock;
+Node *inodeAt(uint32_t inodeNumber)
+{
+    if (inodeNumber == NO_INODE)
+    {
+        return NULL;
     }
+    return &inodeSegments[inodeNumber >> INODE_SEGMENT_BITS][inodeNumber & (INODE_SEGMENT_SIZE - 1)];
 }
 
-void initializeVFS()
+uint32_t inodeNumberOf(const Node *node)
 {
-    initializeFreeBlocks();
+    return node ? node->inodeNumber : NO_INODE;
+}
 
-    rootDirectory = (Node *)malloc(sizeof(Node));
-    if (rootDirectory == NULL)
+uint32_t claimInodeNumber()
+{
+    pthread_mutex_lock(&inodeMutex);
+    uint32_t inodeNumber = freeInodeHead;
+    if (inodeNumber != NO_INODE)
     {
-        printf("Memory allocation failed");
-        return;
+        freeInodeHead = inodeAt(inodeNumber)->nextSibling;
+    }
+    else if (nextUnusedInode != NO_INODE)
+    {
+        uint32_t segment = nextUnusedInode >> INODE_SEGMENT_BITS;
+        if (inodeSegments[segment] == NULL)
+        {
+            inodeSegments[segment] = (Node *)malloc(INODE_SEGMENT_SIZE * sizeof(Node));
+        }
+        if (inodeSegments[segment] != NULL)
+        {
+            inodeNumber = nextUnusedInode++;
+        }
+    }
+    if (inodeNumber != NO_INODE)
+    {
+        liveInodeCount++;
+    }
+    pthread_mutex_unlock(&inodeMutex);
+    return inodeNumber;
+}
+
+Node *createDetachedNode(const char *name, int isFolder)
+{
+    uint32_t nameId = internName(name);
+    if (nameId == 0)
+    {
+        return NULL;
+    }
+    DirectoryRecord *directory = NULL;
+    if (isFolder)
+    {
+        directory = (DirectoryRecord *)calloc(1, sizeof(DirectoryRecord));
+        if (directory == NULL)
+        {
+            releaseName(nameId);
+            printf("Memory allocation failed.");
+            return NULL;
+        }
+        pthread_rwlock_init(&directory->lock, NULL);
+        pthread_mutex_init(&directory->orderMutex, NULL);
+    }
+    uint32_t inodeNumber = claimInodeNumber();
+    if (inodeNumber == NO_INODE)
+    {
+        if (directory)
+        {
+            pthread_rwlock_destroy(&directory->lock);
+            pthread_mutex_destroy(&directory->orderMutex);
+            free(directory);
+        }
+        releaseName(nameId);
+        printf("Memory allocation failed.");
+        return NULL;
     }
 
-    rootDirectory->isFolder = 1;
-    rootDirectory->parent = NULL;
-    rootDirectory->firstChild = NULL;
-    strcpy(rootDirectory->name, "/");
-    rootDirectory->nextSibling = rootDirectory;
-    rootDirectory->dataSize = 0;
-    rootDirectory->blockCount = 0;
-    currentDirectory = rootDirectory;
+    Node *newNode = inodeAt(inodeNumber);
+    memset(newNode, 0, sizeof(Node));
+    newNode->inodeNumber = inodeNumber;
+    newNode->nameId = nameId;
+    newNode->isFolder = (uint8_t)(isFolder != 0);
+    newNode->nextSibling = inodeNumber;
+    newNode->previousSibling = inodeNumber;
+    newNode->modifiedTime = (uint32_t)time(NULL);
+    newNode->changedTime = newNode->modifiedTime;
+    if (isFolder)
+    {
+        newNode->directory = directory;
+    }
+    return newNode;
+}
 
-    printf("Compact VFS - ready. Type 'exit' to quit.\n");
+void releaseInode(Node *node)
+{
+    releaseName(node->nameId);
+    if (node->isFolder)
+    {
+        pthread_rwlock_destroy(&node->directory->lock);
+        pthread_mutex_destroy(&node->directory->orderMutex);
+        free(node->directory->indexSlots);
+        free(node->directory->orderedChildren);
+        free(node->directory);
+    }
+    else
+    {
+        free(node->blockMap);
+    }
+    node->directory = NULL;
+    node->blockMap = NULL;
+
+    pthread_mutex_lock(&inodeMutex);
+    node->nextSibling = freeInodeHead;
+    freeInodeHead = node->inodeNumber;
+    liveInodeCount--;
+    pthread_mutex_unlock(&inodeMutex);
 }
 
-int allocateBlock()
+void releaseInodeTable()
 {
-    if (freeBlockListHead == NULL)
+    for (uint32_t segment = 0; segment < MAX_INODE_SEGMENTS && inodeSegments[segment] != NULL; segment++)
     {
-        printf("No memory left.\n");
-        return -1;
+        free(inodeSegments[segment]);
+        inodeSegments[segment] = NULL;
     }
-    DiskBlock *blockToAllocate = freeBlockListHead;
-    int index = blockToAllocate->blockIndex;
-    freeBlockListHead = freeBlockListHead->next;
-    if (freeBlockListHead)
+    for (uint32_t chunk = 0; chunk < nameArenaChunkCount; chunk++)
     {
-        freeBlockListHead->previous = NULL;
+        free(nameArenaChunks[chunk]);
     }
-    free(blockToAllocate);
-    return index;
+    free(nameBuckets);
+    nameBuckets = NULL;
+    nameBucketCount = 0;
+    nameArenaChunkCount = 0;
+    internedNameCount = 0;
+    nameArenaBytes = 0;
+    memset(freeNameByLength, 0, sizeof(freeNameByLength));
+    nextUnusedInode = 1;
+    freeInodeHead = NO_INODE;
+    liveInodeCount = 0;
 }
 
-void releaseFileBlocks(Node *file)
+int fileChunkCount(const Node *file)
+{
+    return file->blockMap ? file->blockMap->chunkCount : 0;
+}
+
+FileBlockMap *createBlockMap(int chunkCount, int blockCapacity)
+{
+    FileBlockMap *blockMap = (FileBlockMap *)malloc(sizeof(FileBlockMap) + chunkCount * sizeof(ChunkExtent) + blockCapacity * sizeof(int));
+    if (blockMap == NULL)
+    {
+        printf("Memory allocation failed.");
+        return NULL;
+    }
+    blockMap->chunkCount = chunkCount;
+    blockMap->blockCapacity = blockCapacity;
+    blockMap->allocatedBlocks = (int *)(blockMap->chunks + chunkCount);
+    return blockMap;
+}
+
+uint32_t *findIndexSlot(DirectoryRecord *directory, const char *name)
 {
-    for (int index = 0; index < file->blockCount; index++)
+    uint32_t mask = directory->indexCapacity - 1;
+    for (uint32_t slot = hashName(name, strlen(name)) & mask;; slot = (slot + 1) & mask)
     {
-        int blockIdx = file->allocatedBlocks[index];
-        if (blockIdx >= 0)
+        uint32_t inodeNumber = directory->indexSlots[slot];
+        if (inodeNumber == NO_INODE || strcmp(nodeName(inodeAt(inodeNumber)), name) == 0)
         {
-            DiskBlock *restoredBlock = (DiskBlock *)malloc(sizeof(DiskBlock));
-            if (restoredBlock == NULL)
-            {
-                printf("Memory allocation failed");
-                return;
-            }
+            return &directory->indexSlots[slot];
+        }
+    }
+}
 
-            restoredBlock->blockIndex = blockIdx;
-            restoredBlock->next = freeBlockListHead;
-            if (freeBlockListHead)
-            {
-                freeBlockListHead->previous = restoredBlock;
-            }
-            restoredBlock->previous = NULL;
-            freeBlockListHead = restoredBlock;
-            file->allocatedBlocks[index] = -1;
+int growDirectoryIndex(DirectoryRecord *directory)
+{
+    uint32_t oldCapacity = directory->indexCapacity;
+    uint32_t *oldSlots = directory->indexSlots;
+    uint32_t newCapacity = oldCapacity ? oldCapacity * 2 : INITIAL_DIRECTORY_INDEX_SLOTS;
+    uint32_t *newSlots = (uint32_t *)calloc(newCapacity, sizeof(uint32_t));
+    if (newSlots == NULL)
+    {
+        printf("Memory allocation failed.");
+        return 0;
+    }
+    directory->indexSlots = newSlots;
+    directory->indexCapacity = newCapacity;
+    for (uint32_t slot = 0; slot < oldCapacity; slot++)
+    {
+        if (oldSlots[slot] != NO_INODE)
+        {
+            *findIndexSlot(directory, nodeName(inodeAt(oldSlots[slot]))) = oldSlots[slot];
         }
     }
-    file->dataSize = 0;
-    file->blockCount = 0;
+    free(oldSlots);
+    return 1;
 }
 
-void makeDirectory(char *folderName)
+/* Linear probing with backward-shift deletion keeps probe chains free of tombstones. */
+void unindexChildNode(DirectoryRecord *directory, Node *child)
 {
-    Node *node = currentDirectory->firstChild;
-    if (node)
+    uint32_t mask = directory->indexCapacity - 1;
+    uint32_t hole = (uint32_t)(findIndexSlot(directory, nodeName(child)) - directory->indexSlots);
+    directory->indexSlots[hole] = NO_INODE;
+    for (uint32_t slot = (hole + 1) & mask; directory->indexSlots[slot] != NO_INODE; slot = (slot + 1) & mask)
     {
-        do
+        const char *name = nodeName(inodeAt(directory->indexSlots[slot]));
+        uint32_t home = hashName(name, strlen(name)) & mask;
+        if (((slot - home) & mask) >= ((slot - hole) & mask))
         {
-            if (strcmp(node->name, folderName) == 0)
-            {
-                printf("Directory with name %s already exists.\n", folderName);
-                return;
-            }
-            node = node->nextSibling;
-        } while (node != currentDirectory->firstChild);
+            directory->indexSlots[hole] = directory->indexSlots[slot];
+            directory->indexSlots[slot] = NO_INODE;
+            hole = slot;
+        }
     }
+}
 
-    Node *newFolder = (Node *)malloc(sizeof(Node));
-    if (newFolder == NULL)
+void invalidateChildOrder(Node *directory)
+{
+    if (directory != NULL)
     {
-        printf("Memory allocation failed");
-        return;
+        directory->directory->orderKey = ORDER_NONE;
     }
+}
 
-    strcpy(newFolder->name, folderName);
-    newFolder->isFolder = 1;
-    newFolder->parent = currentDirectory;
-    newFolder->firstChild = NULL;
-    newFolder->dataSize = 0;
-    newFolder->blockCount = 0;
+void markNodeChanged(Node *node, int contentChanged)
+{
+    node->changedTime = (uint32_t)time(NULL);
+    if (contentChanged)
+    {
+        node->modifiedTime = node->changedTime;
+    }
+    invalidateChildOrder(inodeAt(node->parent));
+}
 
-    if (currentDirectory->firstChild == NULL)
+Node *findChildNode(Node *directory, const char *name)
+{
+    if (directory->directory->childCount == 0)
     {
-        currentDirectory->firstChild = newFolder;
-        newFolder->nextSibling = newFolder;
+        return NULL;
     }
-    else
+    return inodeAt(*findIndexSlot(directory->directory, name));
+}
+
+int appendChildNode(Node *directory, Node *child)
+{
+    DirectoryRecord *record = directory->directory;
+    if ((record->childCount + 1) * 2 > record->indexCapacity && !growDirectoryIndex(record))
     {
-        Node *temporaryNode = currentDirectory->firstChild;
-        while (temporaryNode->nextSibling != currentDirectory->firstChild)
-        {
-            temporaryNode = temporaryNode->nextSibling;
-        }
-        newFolder->nextSibling = temporaryNode->nextSibling;
-        temporaryNode->nextSibling = newFolder;
+        return 0;
     }
-    printf("Directory '%s' created successfully.\n", folderName);
+    *findIndexSlot(record, nodeName(child)) = child->inodeNumber;
+    record->childCount++;
+    invalidateChildOrder(directory);
+
+    child->parent = directory->inodeNumber;
+    Node *firstChild = inodeAt(directory->firstChild);
+    if (firstChild == NULL)
+    {
+        directory->firstChild = child->inodeNumber;
+        child->nextSibling = child->inodeNumber;
+        child->previousSibling = child->inodeNumber;
+        return 1;
+    }
+    Node *lastChild = inodeAt(firstChild->previousSibling);
+    child->nextSibling = firstChild->inodeNumber;
+    child->previousSibling = lastChild->inodeNumber;
+    lastChild->nextSibling = child->inodeNumber;
+    firstChild->previousSibling = child->inodeNumber;
+    return 1;
 }
 
-void listDirectory()
+void unlinkChildNode(Node *directory, Node *child)
 {
-    Node *temporaryNode = currentDirectory->firstChild;
-    if (temporaryNode == NULL)
+    unindexChildNode(directory->directory, child);
+    directory->directory->childCount--;
+    invalidateChildOrder(directory);
+
+    if (child->nextSibling == child->inodeNumber)
     {
-        printf("(empty)\n");
-        return;
+        directory->firstChild = NO_INODE;
     }
-    do
+    else
     {
-        printf("%s", temporaryNode->name);
-        if (temporaryNode->isFolder)
+        inodeAt(child->previousSibling)->nextSibling = child->nextSibling;
+        inodeAt(child->nextSibling)->previousSibling = child->previousSibling;
+        if (directory->firstChild == child->inodeNumber)
         {
-            printf("/");
+            directory->firstChild = child->nextSibling;
         }
-        printf("\n");
-        temporaryNode = temporaryNode->nextSibling;
-    } while (temporaryNode != currentDirectory->firstChild);
+    }
+    child->nextSibling = child->inodeNumber;
+    child->previousSibling = child->inodeNumber;
 }
 
-void printCurrentPath()
+typedef struct NodeStack
 {
-    Node *temporaryNode = currentDirectory;
-    char fullPath[MAX_PATH_LENGTH] = "";
-    char temporaryPath[MAX_PATH_LENGTH] = "";
-    while (temporaryNode != rootDirectory)
+    Node **items;
+    int count;
+    int capacity;
+} NodeStack;
+
+void initializeNodeStack(NodeStack *stack)
+{
+    stack->items = NULL;
+    stack->count = 0;
+    stack->capacity = 0;
+}
+
+int pushNode(NodeStack *stack, Node *node)
+{
+    if (stack->count == stack->capacity)
     {
-        snprintf(temporaryPath, sizeof(temporaryPath), "%s/%s", temporaryNode->name, fullPath);
-        strncpy(fullPath, temporaryPath, sizeof(fullPath));
-        temporaryNode = temporaryNode->parent;
+        int newCapacity = stack->capacity ? stack->capacity * 2 : INITIAL_STACK_CAPACITY;
+        Node **grownItems = (Node **)realloc(stack->items, newCapacity * sizeof(Node *));
+        if (grownItems == NULL)
+        {
+            printf("Memory allocation failed");
+            return 0;
+        }
+        stack->items = grownItems;
+        stack->capacity = newCapacity;
     }
-    if (strlen(fullPath) == 0)
+    stack->items[stack->count++] = node;
+    return 1;
+}
+
+Node *popNode(NodeStack *stack)
+{
+    if (stack->count == 0)
     {
-        printf("/\n");
-        return;
+        return NULL;
     }
-    printf("/%s\n", fullPath);
+    return stack->items[--stack->count];
 }
 
-void moveToParentDirectory()
+void destroyNodeStack(NodeStack *stack)
 {
-    if (currentDirectory == rootDirectory)
+    free(stack->items);
+    initializeNodeStack(stack);
+}
+
+/* Subtrees unlinked by rm, rmdir and delete; walks that started above them may still hold their nodes. */
+NodeStack retiredSubtrees = {NULL, 0, 0};
+pthread_mutex_t retiredMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* The session's own directory is locked by the command dispatcher, and exclusive commands run with every other session parked. */
+int walkNeedsLock(Node *directory)
+{
+    return directory != currentDirectory && !sessionHasExclusiveAccess;
+}
+
+void lockDirectoryForWalk(Node *directory, int forWriting)
+{
+    if (!walkNeedsLock(directory))
     {
-        printf("Already on root.\n");
         return;
     }
-    currentDirectory = currentDirectory->parent;
-    printf("Moved to ");
-    printCurrentPath();
+    if (forWriting)
+    {
+        pthread_rwlock_wrlock(&directory->directory->lock);
+    }
+    else
+    {
+        pthread_rwlock_rdlock(&directory->directory->lock);
+    }
 }
 
-void changeDirectory(char *targetName)
+void unlockDirectoryForWalk(Node *directory)
 {
-    if (strcmp(targetName, "..") == 0)
+    if (walkNeedsLock(directory))
     {
-        moveToParentDirectory();
-        return;
+        pthread_rwlock_unlock(&directory->directory->lock);
     }
+}
 
-    if (currentDirectory->firstChild == NULL)
+/* The new path is counted before the old one is dropped, so a folder the session stays under never reads zero. */
+void setCurrentDirectory(Node *directory)
+{
+    for (Node *folder = directory; folder != NULL; folder = inodeAt(folder->parent))
     {
-        printf("%s is empty.\n", currentDirectory->name);
-        return;
+        __atomic_add_fetch(&folder->directory->activeSessions, 1, __ATOMIC_RELAXED);
     }
-    Node *temporaryNode = currentDirectory->firstChild;
-    do
+    for (Node *folder = currentDirectory; folder != NULL; folder = inodeAt(folder->parent))
     {
-        if (strcmp(temporaryNode->name, targetName) == 0 && temporaryNode->isFolder)
-        {
-            currentDirectory = temporaryNode;
-            printf("Moved to ");
-            printCurrentPath();
-            return;
-        }
-        temporaryNode = temporaryNode->nextSibling;
-    } while (temporaryNode != currentDirectory->firstChild);
-    printf("No folder found with the name %s\n", targetName);
+        __atomic_sub_fetch(&folder->directory->activeSessions, 1, __ATOMIC_RELAXED);
+    }
+    currentDirectory = directory;
 }
 
-void createFile(char *fileName)
+int directoryInUse(Node *node)
+{
+    return node->isFolder && __atomic_load_n(&node->directory->activeSessions, __ATOMIC_RELAXED) > 0;
+}
+
+void initializeFreeBlocks()
 {
-    Node *node = currentDirectory->firstChild;
-    if (node)
+    DiskBlock *prevBlock = NULL;
+
+    for (int index = 0; index < TOTAL_DISK_BLOCKS; index++)
     {
-        do
+        DiskBlock *newBlock = (DiskBlock *)malloc(sizeof(DiskBlock));
+        if (newBlock == NULL)
         {
-            if (strcmp(node->name, fileName) == 0)
-            {
-                printf("File with name %s already exists.\n", fileName);
-                return;
-            }
-            node = node->nextSibling;
-        } while (node != currentDirectory->firstChild);
+            printf("Memory allocation failed");
+            return;
+        }
+
+        newBlock->blockIndex = index;
+        newBlock->next = NULL;
+        newBlock->previous = prevBlock;
+
+        if (prevBlock)
+        {
+            prevBlock->next = newBlock;
+        }
+        else
+        {
+            freeBlockListHead = newBlock;
+        }
+
+        prevBlock = newBlock;
+        freeBlockCount++;
+    }
+}
+
+void initializeVFS()
+{
+    initializeFreeBlocks();
+    for (int bucket = 0; bucket < FINGERPRINT_BUCKETS; bucket++)
+    {
+        fingerprintBucketHead[bucket] = -1;
+    }
+
+    rootDirectory = createDetachedNode("/", 1);
+    if (rootDirectory == NULL)
+    {
+        return;
+    }
+    setCurrentDirectory(rootDirectory);
+
+    printf("Compact VFS - ready. Type 'exit' to quit.\n");
+}
+
+int refillThreadBlockCache()
+{
+    pthread_mutex_lock(&allocatorMutex);
+    threadBlockCacheCount = 0;
+    threadBlockCachePosition = 0;
+    while (threadBlockCacheCount < threadBlockCacheLimit && freeBlockListHead != NULL)
+    {
+        DiskBlock *blockToAllocate = freeBlockListHead;
+        threadBlockCache[threadBlockCacheCount++] = blockToAllocate->blockIndex;
+        freeBlockListHead = freeBlockListHead->next;
+        if (freeBlockListHead)
+        {
+            freeBlockListHead->previous = NULL;
+        }
+        free(blockToAllocate);
+    }
+    pthread_mutex_unlock(&allocatorMutex);
+    return threadBlockCacheCount;
+}
+
+int allocateBlock()
+{
+    if (threadBlockCachePosition == threadBlockCacheCount && refillThreadBlockCache() == 0)
+    {
+        printf("No memory left.\n");
+        return -1;
+    }
+    __atomic_sub_fetch(&freeBlockCount, 1, __ATOMIC_RELAXED);
+    return threadBlockCache[threadBlockCachePosition++];
+}
+
+void releaseBlocksInBulk(int blockIndexes[], int count)
+{
+    DiskBlock *chainHead = NULL;
+    DiskBlock *chainTail = NULL;
+    int chainLength = 0;
+
+    for (int index = 0; index < count; index++)
+    {
+        if (blockIndexes[index] < 0)
+        {
+            continue;
+        }
+        DiskBlock *restoredBlock = (DiskBlock *)malloc(sizeof(DiskBlock));
+        if (restoredBlock == NULL)
+        {
+            printf("Memory allocation failed");
+            break;
+        }
+
+        restoredBlock->blockIndex = blockIndexes[index];
+        restoredBlock->previous = chainTail;
+        restoredBlock->next = NULL;
+        if (chainTail)
+        {
+            chainTail->next = restoredBlock;
+        }
+        else
+        {
+            chainHead = restoredBlock;
+        }
+        chainTail = restoredBlock;
+        chainLength++;
+    }
+
+    if (chainHead == NULL)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&allocatorMutex);
+    chainTail->next = freeBlockListHead;
+    if (freeBlockListHead)
+    {
+        freeBlockListHead->previous = chainTail;
+    }
+    freeBlockListHead = chainHead;
+    pthread_mutex_unlock(&allocatorMutex);
+    __atomic_add_fetch(&freeBlockCount, chainLength, __ATOMIC_RELAXED);
+}
+
+void releaseThreadBlockCache()
+{
+    int cachedCount = threadBlockCacheCount - threadBlockCachePosition;
+    releaseBlocksInBulk(threadBlockCache + threadBlockCachePosition, cachedCount);
+    __atomic_sub_fetch(&freeBlockCount, cachedCount, __ATOMIC_RELAXED);
+    threadBlockCacheCount = 0;
+    threadBlockCachePosition = 0;
+}
+
+uint64_t fingerprintBlock(const char *blockData)
+{
+    uint64_t hash = 0x9E3779B97F4A7C15ULL;
+    for (int offset = 0; offset < BLOCK_SIZE; offset += sizeof(uint64_t))
+    {
+        uint64_t word;
+        memcpy(&word, blockData + offset, sizeof(word));
+        hash = (hash ^ word) * 0xFF51AFD7ED558CCDULL;
+        hash ^= hash >> 32;
+    }
+    return hash;
+}
+
+void indexFingerprintedBlock(int blockIndex, uint64_t fingerprint)
+{
+    if (blockIndexed[blockIndex])
+    {
+        return;
+    }
+    int bucket = (int)(fingerprint % FINGERPRINT_BUCKETS);
+    blockFingerprint[blockIndex] = fingerprint;
+    fingerprintNextBlock[blockIndex] = fingerprintBucketHead[bucket];
+    fingerprintBucketHead[bucket] = blockIndex;
+    blockIndexed[blockIndex] = 1;
+}
+
+void indexBlockFingerprint(int blockIndex)
+{
+    if (!blockIndexed[blockIndex])
+    {
+        indexFingerprintedBlock(blockIndex, fingerprintBlock(diskMemory[blockIndex]));
+    }
+}
+
+void unindexBlockFingerprint(int blockIndex)
+{
+    if (!blockIndexed[blockIndex])
+    {
+        return;
+    }
+    int *link = &fingerprintBucketHead[blockFingerprint[blockIndex] % FINGERPRINT_BUCKETS];
+    while (*link != blockIndex)
+    {
+        link = &fingerprintNextBlock[*link];
+    }
+    *link = fingerprintNextBlock[blockIndex];
+    blockIndexed[blockIndex] = 0;
+}
+
+int findDuplicateBlock(const char *blockData, uint64_t fingerprint)
+{
+    int candidate = fingerprintBucketHead[fingerprint % FINGERPRINT_BUCKETS];
+    while (candidate != -1)
+    {
+        if (blockFingerprint[candidate] == fingerprint && memcmp(diskMemory[candidate], blockData, BLOCK_SIZE) == 0)
+        {
+            return candidate;
+        }
+        candidate = fingerprintNextBlock[candidate];
+    }
+    return -1;
+}
+
+int storeFingerprintedBlock(const char *blockData, uint64_t fingerprint)
+{
+    if (dedupEnabled)
+    {
+        pthread_mutex_lock(&dedupMutex);
+        int duplicate = findDuplicateBlock(blockData, fingerprint);
+        if (duplicate != -1)
+        {
+            blockReferenceCount[duplicate]++;
+            pthread_mutex_unlock(&dedupMutex);
+            __atomic_add_fetch(&logicalBlockCount, 1, __ATOMIC_RELAXED);
+            return duplicate;
+        }
+        pthread_mutex_unlock(&dedupMutex);
+    }
+
+    int blockIndex = allocateBlock();
+    if (blockIndex == -1)
+    {
+        return -1;
+    }
+    memcpy(diskMemory[blockIndex], blockData, BLOCK_SIZE);
+    blockReferenceCount[blockIndex] = 1;
+    __atomic_add_fetch(&logicalBlockCount, 1, __ATOMIC_RELAXED);
+    if (dedupEnabled)
+    {
+        pthread_mutex_lock(&dedupMutex);
+        indexFingerprintedBlock(blockIndex, fingerprint);
+        pthread_mutex_unlock(&dedupMutex);
+    }
+    return blockIndex;
+}
+
+int storeBlock(const char *blockData)
+{
+    return storeFingerprintedBlock(blockData, dedupEnabled ? fingerprintBlock(blockData) : 0);
+}
+
+/* Always under dedupMutex: blocks shared while dedup was on stay shared after "dedup off", and deletes in
+   different directories only hold their own directory locks. */
+int dropBlockReference(int blockIndex)
+{
+    __atomic_sub_fetch(&logicalBlockCount, 1, __ATOMIC_RELAXED);
+    pthread_mutex_lock(&dedupMutex);
+    int released = --blockReferenceCount[blockIndex] == 0;
+    if (released)
+    {
+        unindexBlockFingerprint(blockIndex);
+    }
+    pthread_mutex_unlock(&dedupMutex);
+    return released;
+}
+
+void releaseBlockMap(FileBlockMap *blockMap, int blockCount)
+{
+    int releasedBlocks[MAX_BLOCKS_PER_FILE];
+    int releasedCount = 0;
+    for (int index = 0; index < blockCount; index++)
+    {
+        int blockIdx = blockMap->allocatedBlocks[index];
+        if (dropBlockReference(blockIdx))
+        {
+            releasedBlocks[releasedCount++] = blockIdx;
+        }
+    }
+    releaseBlocksInBulk(releasedBlocks, releasedCount);
+    free(blockMap);
+}
+
+void releaseFileBlocks(Node *file)
+{
+    releaseBlockMap(file->blockMap, file->blockCount);
+    file->blockMap = NULL;
+    file->dataSize = 0;
+    file->blockCount = 0;
+}
+
+/* For a node that never made it into a directory. */
+void discardDetachedNode(Node *node)
+{
+    if (!node->isFolder)
+    {
+        releaseFileBlocks(node);
+    }
+    releaseInode(node);
+}
+
+void makeDirectory(char *folderName)
+{
+    if (findChildNode(currentDirectory, folderName) != NULL)
+    {
+        printf("Directory with name %s already exists.\n", folderName);
+        return;
+    }
+
+    Node *newFolder = createDetachedNode(folderName, 1);
+    if (newFolder == NULL)
+    {
+        return;
+    }
+    if (!appendChildNode(currentDirectory, newFolder))
+    {
+        releaseInode(newFolder);
+        return;
+    }
+    markNodeChanged(currentDirectory, 1);
+    journalBeginRecord(JOURNAL_MKDIR);
+    journalAppendPath(currentDirectory, folderName);
+    journalAppendTimes(newFolder);
+    journalAppendTimes(currentDirectory);
+    journalEndRecord();
+    printf("Directory '%s' created successfully.\n", folderName);
+}
+
+int compareChildrenByName(const void *left, const void *right)
+{
+    return strcmp(nodeName(inodeAt(*(const uint32_t *)left)), nodeName(inodeAt(*(const uint32_t *)right)));
+}
+
+int compareChildrenBySize(const void *left, const void *right)
+{
+    const Node *leftNode = inodeAt(*(const uint32_t *)left);
+    const Node *rightNode = inodeAt(*(const uint32_t *)right);
+    if (leftNode->dataSize != rightNode->dataSize)
+    {
+        return leftNode->dataSize > rightNode->dataSize ? -1 : 1;
+    }
+    return compareChildrenByName(left, right);
+}
+
+int compareChildrenByTime(const void *left, const void *right)
+{
+    const Node *leftNode = inodeAt(*(const uint32_t *)left);
+    const Node *rightNode = inodeAt(*(const uint32_t *)right);
+    if (leftNode->modifiedTime != rightNode->modifiedTime)
+    {
+        return leftNode->modifiedTime > rightNode->modifiedTime ? -1 : 1;
+    }
+    return compareChildrenByName(left, right);
+}
+
+/* Callers hold orderMutex; the cached order survives until a child is added, removed, resized or touched. */
+uint32_t *orderedChildrenOf(Node *directory, int orderKey)
+{
+    DirectoryRecord *record = directory->directory;
+    if (record->orderKey == orderKey)
+    {
+        return record->orderedChildren;
+    }
+    uint32_t *orderedChildren = (uint32_t *)realloc(record->orderedChildren, record->childCount * sizeof(uint32_t));
+    if (orderedChildren == NULL)
+    {
+        printf("Memory allocation failed.");
+        return NULL;
+    }
+    record->orderedChildren = orderedChildren;
+    uint32_t inodeNumber = directory->firstChild;
+    for (uint32_t index = 0; index < record->childCount; index++)
+    {
+        orderedChildren[index] = inodeNumber;
+        inodeNumber = inodeAt(inodeNumber)->nextSibling;
+    }
+    qsort(orderedChildren, record->childCount, sizeof(uint32_t), orderKey == ORDER_BY_SIZE ? compareChildrenBySize : compareChildrenByTime);
+    record->orderKey = orderKey;
+    return orderedChildren;
+}
+
+void formatNodeTime(uint32_t timestamp, char *buffer, size_t bufferSize)
+{
+    time_t seconds = (time_t)timestamp;
+    struct tm localTime;
+    localtime_r(&seconds, &localTime);
+    strftime(buffer, bufferSize, "%Y-%m-%d %H:%M", &localTime);
+}
+
+void printListEntry(Node *node, int longFormat)
+{
+    if (longFormat)
+    {
+        char timeText[32];
+        formatNodeTime(node->modifiedTime, timeText, sizeof(timeText));
+        printf("%c %8d %s ", node->isFolder ? 'd' : '-', node->dataSize, timeText);
+    }
+    printf("%s", nodeName(node));
+    if (node->isFolder)
+    {
+        printf("/");
+    }
+    printf("\n");
+}
+
+void listDirectory(char *options, char **tokenState)
+{
+    int longFormat = 0;
+    int orderKey = ORDER_NONE;
+    for (; options != NULL; options = strtok_r(NULL, " ", tokenState))
+    {
+        if (options[0] != '-' || options[1] == '\0' || strspn(options + 1, "lSt") != strlen(options + 1))
+        {
+            printf("Syntax: ls [-l] [-S|-t]\n");
+            return;
+        }
+        longFormat |= strchr(options, 'l') != NULL;
+        orderKey = strchr(options, 'S') ? ORDER_BY_SIZE : (strchr(options, 't') ? ORDER_BY_TIME : orderKey);
+    }
+
+    Node *temporaryNode = inodeAt(currentDirectory->firstChild);
+    if (temporaryNode == NULL)
+    {
+        printf("(empty)\n");
+        return;
+    }
+    if (orderKey != ORDER_NONE)
+    {
+        DirectoryRecord *record = currentDirectory->directory;
+        pthread_mutex_lock(&record->orderMutex);
+        uint32_t *orderedChildren = orderedChildrenOf(currentDirectory, orderKey);
+        for (uint32_t index = 0; orderedChildren != NULL && index < record->childCount; index++)
+        {
+            printListEntry(inodeAt(orderedChildren[index]), longFormat);
+        }
+        pthread_mutex_unlock(&record->orderMutex);
+        return;
+    }
+    do
+    {
+        printListEntry(temporaryNode, longFormat);
+        temporaryNode = inodeAt(temporaryNode->nextSibling);
+    } while (temporaryNode->inodeNumber != currentDirectory->firstChild);
+}
+
+void printCurrentPath()
+{
+    Node *temporaryNode = currentDirectory;
+    char fullPath[MAX_PATH_LENGTH] = "";
+    char temporaryPath[MAX_PATH_LENGTH] = "";
+    while (temporaryNode != rootDirectory)
+    {
+        snprintf(temporaryPath, sizeof(temporaryPath), "%s/%s", nodeName(temporaryNode), fullPath);
+        strncpy(fullPath, temporaryPath, sizeof(fullPath));
+        temporaryNode = inodeAt(temporaryNode->parent);
+    }
+    if (strlen(fullPath) == 0)
+    {
+        printf("/\n");
+        return;
+    }
+    printf("/%s\n", fullPath);
+}
+
+void moveToParentDirectory()
+{
+    if (currentDirectory == rootDirectory)
+    {
+        printf("Already on root.\n");
+        return;
+    }
+    setCurrentDirectory(inodeAt(currentDirectory->parent));
+    printf("Moved to ");
+    printCurrentPath();
+}
+
+void changeDirectory(char *targetName)
+{
+    if (strcmp(targetName, "..") == 0)
+    {
+        moveToParentDirectory();
+        return;
+    }
+
+    if (currentDirectory->firstChild == NO_INODE)
+    {
+        printf("%s is empty.\n", nodeName(currentDirectory));
+        return;
+    }
+    Node *temporaryNode = findChildNode(currentDirectory, targetName);
+    if (temporaryNode != NULL && temporaryNode->isFolder)
+    {
+        setCurrentDirectory(temporaryNode);
+        printf("Moved to ");
+        printCurrentPath();
+        return;
+    }
+    printf("No folder found with the name %s\n", targetName);
+}
+
+void createFile(char *fileName)
+{
+    if (findChildNode(currentDirectory, fileName) != NULL)
+    {
+        printf("File with name %s already exists.\n", fileName);
+        return;
+    }
+
+    Node *newFile = createDetachedNode(fileName, 0);
+    if (newFile == NULL)
+    {
+        return;
+    }
+    if (!appendChildNode(currentDirectory, newFile))
+    {
+        releaseInode(newFile);
+        return;
+    }
+    markNodeChanged(currentDirectory, 1);
+    journalBeginRecord(JOURNAL_CREATE);
+    journalAppendPath(currentDirectory, fileName);
+    journalAppendTimes(newFile);
+    journalAppendTimes(currentDirectory);
+    journalEndRecord();
+    printf("File '%s' created successfully.\n", fileName);
+}
+
+uint32_t readUnaligned32(const unsigned char *bytes)
+{
+    uint32_t value;
+    memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+int writeLengthExtension(unsigned char *output, int outputPosition, int outputCapacity, int remainingLength)
+{
+    while (remainingLength >= 255)
+    {
+        if (outputPosition >= outputCapacity)
+        {
+            return -1;
+        }
+        output[outputPosition++] = 255;
+        remainingLength -= 255;
+    }
+    if (outputPosition >= outputCapacity)
+    {
+        return -1;
+    }
+    output[outputPosition++] = (unsigned char)remainingLength;
+    return outputPosition;
+}
+
+int emitCompressedSequence(unsigned char *output, int outputPosition, int outputCapacity, const unsigned char *literals, int literalLength, int matchOffset, int matchLength)
+{
+    if (outputPosition >= outputCapacity)
+    {
+        return -1;
+    }
+    int tokenPosition = outputPosition++;
+    int literalNibble = literalLength < 15 ? literalLength : 15;
+    int matchNibble = 0;
+    if (matchLength > 0)
+    {
+        matchNibble = (matchLength - COMPRESSION_MIN_MATCH) < 15 ? (matchLength - COMPRESSION_MIN_MATCH) : 15;
+    }
+    output[tokenPosition] = (unsigned char)((literalNibble << 4) | matchNibble);
+
+    if (literalNibble == 15)
+    {
+        outputPosition = writeLengthExtension(output, outputPosition, outputCapacity, literalLength - 15);
+        if (outputPosition < 0)
+        {
+            return -1;
+        }
+    }
+    if (outputPosition + literalLength > outputCapacity)
+    {
+        return -1;
+    }
+    memcpy(output + outputPosition, literals, literalLength);
+    outputPosition += literalLength;
+
+    if (matchLength == 0)
+    {
+        return outputPosition;
+    }
+    if (outputPosition + 2 > outputCapacity)
+    {
+        return -1;
+    }
+    output[outputPosition++] = (unsigned char)(matchOffset & 0xFF);
+    output[outputPosition++] = (unsigned char)(matchOffset >> 8);
+    if (matchNibble == 15)
+    {
+        outputPosition = writeLengthExtension(output, outputPosition, outputCapacity, matchLength - COMPRESSION_MIN_MATCH - 15);
+    }
+    return outputPosition;
+}
+
+/* LZ4-style block format: returns the compressed length, or 0 when the output would not be smaller than the input. */
+int compressChunk(const unsigned char *input, int inputLength, unsigned char *output, int outputCapacity)
+{
+    int hashTable[1 << COMPRESSION_HASH_BITS];
+    for (int index = 0; index < (1 << COMPRESSION_HASH_BITS); index++)
+    {
+        hashTable[index] = -1;
+    }
+
+    int inputPosition = 0;
+    int anchor = 0;
+    int outputPosition = 0;
+
+    while (inputPosition + COMPRESSION_MIN_MATCH <= inputLength)
+    {
+        uint32_t sequence = readUnaligned32(input + inputPosition);
+        int hash = (int)((sequence * 2654435761U) >> (32 - COMPRESSION_HASH_BITS));
+        int candidate = hashTable[hash];
+        hashTable[hash] = inputPosition;
+
+        if (candidate < 0 || inputPosition - candidate > COMPRESSION_MAX_OFFSET || readUnaligned32(input + candidate) != sequence)
+        {
+            inputPosition++;
+            continue;
+        }
+
+        int matchLength = COMPRESSION_MIN_MATCH;
+        while (inputPosition + matchLength < inputLength && input[candidate + matchLength] == input[inputPosition + matchLength])
+        {
+            matchLength++;
+        }
+
+        outputPosition = emitCompressedSequence(output, outputPosition, outputCapacity, input + anchor, inputPosition - anchor, inputPosition - candidate, matchLength);
+        if (outputPosition < 0)
+        {
+            return 0;
+        }
+        inputPosition += matchLength;
+        anchor = inputPosition;
+    }
+
+    outputPosition = emitCompressedSequence(output, outputPosition, outputCapacity, input + anchor, inputLength - anchor, 0, 0);
+    if (outputPosition < 0 || outputPosition >= inputLength)
+    {
+        return 0;
+    }
+    return outputPosition;
+}
+
+int readLengthExtension(const unsigned char *input, int *inputPosition, int inputLength, int *length)
+{
+    unsigned char extension;
+    do
+    {
+        if (*inputPosition >= inputLength)
+        {
+            return 0;
+        }
+        extension = input[(*inputPosition)++];
+        *length += extension;
+    } while (extension == 255);
+    return 1;
+}
+
+int decompressChunk(const unsigned char *input, int inputLength, unsigned char *output, int outputCapacity)
+{
+    int inputPosition = 0;
+    int outputPosition = 0;
+
+    while (inputPosition < inputLength)
+    {
+        unsigned char token = input[inputPosition++];
+        int literalLength = token >> 4;
+        if (literalLength == 15 && !readLengthExtension(input, &inputPosition, inputLength, &literalLength))
+        {
+            return -1;
+        }
+        if (inputPosition + literalLength > inputLength || outputPosition + literalLength > outputCapacity)
+        {
+            return -1;
+        }
+        memcpy(output + outputPosition, input + inputPosition, literalLength);
+        inputPosition += literalLength;
+        outputPosition += literalLength;
+
+        if (inputPosition == inputLength)
+        {
+            break;
+        }
+        if (inputPosition + 2 > inputLength)
+        {
+            return -1;
+        }
+        int matchOffset = input[inputPosition] | (input[inputPosition + 1] << 8);
+        inputPosition += 2;
+        int matchLength = (token & 0x0F) + COMPRESSION_MIN_MATCH;
+        if ((token & 0x0F) == 15 && !readLengthExtension(input, &inputPosition, inputLength, &matchLength))
+        {
+            return -1;
+        }
+        if (matchOffset == 0 || matchOffset > outputPosition || outputPosition + matchLength > outputCapacity)
+        {
+            return -1;
+        }
+        for (int index = 0; index < matchLength; index++)
+        {
+            output[outputPosition] = output[outputPosition - matchOffset];
+            outputPosition++;
+        }
+    }
+    return outputPosition;
+}
+
+int chunkRawLength(Node *file, int chunkIndex)
+{
+    int remaining = file->dataSize - chunkIndex * COMPRESSION_CHUNK_SIZE;
+    return remaining < COMPRESSION_CHUNK_SIZE ? remaining : COMPRESSION_CHUNK_SIZE;
+}
+
+int storeBytesInBlocks(Node *file, const char *bytes, int length, const uint64_t *fingerprints)
+{
+    char blockBuffer[BLOCK_SIZE];
+    for (int offset = 0; offset < length; offset += BLOCK_SIZE)
+    {
+        if (file->blockCount >= file->blockMap->blockCapacity)
+        {
+            return 0;
+        }
+        int pieceLength = (length - offset < BLOCK_SIZE) ? length - offset : BLOCK_SIZE;
+        memset(blockBuffer, 0, BLOCK_SIZE);
+        memcpy(blockBuffer, bytes + offset, pieceLength);
+        int blockIndex = fingerprints ? storeFingerprintedBlock(blockBuffer, fingerprints[offset / BLOCK_SIZE]) : storeBlock(blockBuffer);
+        if (blockIndex == -1)
+        {
+            return 0;
+        }
+        file->blockMap->allocatedBlocks[file->blockCount++] = blockIndex;
+    }
+    return 1;
+}
+
+/* fingerprints, when given, hold the dedup fingerprint of every raw block of data. */
+int storeFileDataWithFingerprints(Node *file, const char *data, int length, const uint64_t *fingerprints)
+{
+    if (length > MAX_FILE_SIZE)
+    {
+        printf("File too large (max %d bytes).\n", MAX_FILE_SIZE);
+        return 0;
+    }
+    releaseFileBlocks(file);
+    invalidateChildOrder(inodeAt(file->parent));
+    if (length == 0)
+    {
+        return 1;
+    }
+    /* A compressed chunk is always shorter than its raw bytes, so the raw block count bounds the map. */
+    int chunkCount = (length + COMPRESSION_CHUNK_SIZE - 1) / COMPRESSION_CHUNK_SIZE;
+    file->blockMap = createBlockMap(chunkCount, (length + BLOCK_SIZE - 1) / BLOCK_SIZE);
+    if (file->blockMap == NULL)
+    {
+        return 0;
+    }
+    file->dataSize = length;
+
+    unsigned char compressedBuffer[COMPRESSION_CHUNK_SIZE];
+    for (int chunkIndex = 0; chunkIndex < chunkCount; chunkIndex++)
+    {
+        const char *chunkData = data + chunkIndex * COMPRESSION_CHUNK_SIZE;
+        int rawLength = chunkRawLength(file, chunkIndex);
+        int storedLength = 0;
+        if (file->compressionEnabled)
+        {
+            storedLength = compressChunk((const unsigned char *)chunkData, rawLength, compressedBuffer, sizeof(compressedBuffer));
+        }
+
+        file->blockMap->chunks[chunkIndex].firstBlock = file->blockCount;
+        file->blockMap->chunks[chunkIndex].storedSize = storedLength > 0 ? storedLength : rawLength;
+        int stored = storedLength > 0
+            ? storeBytesInBlocks(file, (const char *)compressedBuffer, storedLength, NULL)
+            : storeBytesInBlocks(file, chunkData, rawLength, fingerprints ? fingerprints + chunkIndex * COMPRESSION_CHUNK_BLOCKS : NULL);
+        if (!stored)
+        {
+            releaseFileBlocks(file);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int storeFileData(Node *file, const char *data, int length)
+{
+    return storeFileDataWithFingerprints(file, data, length, NULL);
+}
+
+int readFileChunk(Node *file, int chunkIndex, char *chunkBuffer)
+{
+    int rawLength = chunkRawLength(file, chunkIndex);
+    int storedLength = file->blockMap->chunks[chunkIndex].storedSize;
+    int firstBlock = file->blockMap->chunks[chunkIndex].firstBlock;
+    char storedBuffer[COMPRESSION_CHUNK_SIZE];
+    char *gatherTarget = (storedLength == rawLength) ? chunkBuffer : storedBuffer;
+
+    for (int offset = 0; offset < storedLength; offset += BLOCK_SIZE)
+    {
+        int pieceLength = (storedLength - offset < BLOCK_SIZE) ? storedLength - offset : BLOCK_SIZE;
+        memcpy(gatherTarget + offset, diskMemory[file->blockMap->allocatedBlocks[firstBlock + offset / BLOCK_SIZE]], pieceLength);
+    }
+    if (storedLength == rawLength)
+    {
+        return rawLength;
+    }
+    return decompressChunk((const unsigned char *)storedBuffer, storedLength, (unsigned char *)chunkBuffer, rawLength);
+}
+
+void writeContent(Node *file, char *data)
+{
+    if (!file || file->isFolder)
+    {
+        printf("Invalid file.\n");
+        return;
+    }
+    int length = strlen(data);
+    int stored = storeFileData(file, data, length);
+    if (stored)
+    {
+        markNodeChanged(file, 1);
+    }
+    if (stored || file->dataSize == 0)
+    {
+        journalBeginRecord(JOURNAL_WRITE);
+        journalAppendPath(inodeAt(file->parent), nodeName(file));
+        journalAppendBytes(data, stored ? length : 0);
+        journalAppendTimes(file);
+        journalEndRecord();
+    }
+    if (!stored)
+    {
+        return;
+    }
+    printf("Data written successfully(size = %d bytes)\n", file->dataSize);
+}
+
+void writeFile(char *fileName, char *data)
+{
+    if (data == NULL || strlen(data) < 2)
+    {
+        printf("Error: Missing or invalid data. Use quotes around your text.\n");
+        return;
+    }
+
+    if (data[0] != '"' || data[strlen(data) - 1] != '"')
+    {
+        printf("Error: Data must be enclosed in double quotes. Example: write file \"Hello World\"\n");
+        return;
+    }
+
+    data[strlen(data) - 1] = '\0';
+    data++;
+
+    int writeIndex = 0;
+    for (int index = 0; data[index] != '\0'; index++, writeIndex++)
+    {
+        if (data[index] == '\\' && data[index + 1] == 'n')
+        {
+            data[writeIndex] = '\n';
+            index++;
+        }
+        else
+        {
+            data[writeIndex] = data[index];
+        }
+    }
+    data[writeIndex] = '\0';
+
+    Node *temporaryNode = inodeAt(currentDirectory->firstChild);
+    if (temporaryNode == NULL)
+    {
+        printf("Error: No files exist in the current directory.\n");
+        return;
+    }
+
+    temporaryNode = findChildNode(currentDirectory, fileName);
+    if (temporaryNode != NULL)
+    {
+        writeContent(temporaryNode, data);
+        return;
+    }
+
+    printf("Error: File '%s' not found in the current directory.\n", fileName);
+}
+
+void displayFileRange(Node *file, int offset, int length)
+{
+    if (file->blockCount == 0)
+    {
+        printf("File is empty.\n");
+        return;
+    }
+    if (offset < 0 || offset >= file->dataSize)
+    {
+        printf("Offset out of range (size = %d bytes).\n", file->dataSize);
+        return;
+    }
+    if (length < 0 || offset + length > file->dataSize)
+    {
+        length = file->dataSize - offset;
+    }
+
+    char chunkBuffer[COMPRESSION_CHUNK_SIZE];
+    int endOffset = offset + length;
+    for (int chunkIndex = offset / COMPRESSION_CHUNK_SIZE; chunkIndex * COMPRESSION_CHUNK_SIZE < endOffset; chunkIndex++)
+    {
+        int chunkStart = chunkIndex * COMPRESSION_CHUNK_SIZE;
+        int rawLength = readFileChunk(file, chunkIndex, chunkBuffer);
+        if (rawLength < 0)
+        {
+            printf("\nCorrupted data in chunk %d.\n", chunkIndex);
+            return;
+        }
+        int sliceStart = offset > chunkStart ? offset - chunkStart : 0;
+        int sliceEnd = endOffset - chunkStart < rawLength ? endOffset - chunkStart : rawLength;
+        fwrite(chunkBuffer + sliceStart, 1, sliceEnd - sliceStart, stdout);
+    }
+    printf("\n");
+}
+
+void displayFileContent(Node *file)
+{
+    displayFileRange(file, 0, -1);
+}
+
+void readFile(char *fileName, int offset, int length)
+{
+    if (currentDirectory->firstChild == NO_INODE)
+    {
+        printf("No file found.\n");
+        return;
+    }
+    Node *temporaryNode = findChildNode(currentDirectory, fileName);
+    if (temporaryNode != NULL && !temporaryNode->isFolder)
+    {
+        displayFileRange(temporaryNode, offset, length);
+        return;
+    }
+    printf("No file found with name %s.\n", fileName);
+}
+
+int retireSubtree(Node *directory, Node *target, int *releasedCount);
+
+void removeFile(Node *file)
+{
+    markNodeChanged(currentDirectory, 1);
+    journalBeginRecord(JOURNAL_REMOVE_FILE);
+    journalAppendPath(currentDirectory, nodeName(file));
+    journalAppendTimes(currentDirectory);
+    journalEndRecord();
+    int releasedCount = 0;
+    retireSubtree(currentDirectory, file, &releasedCount);
+    printf("File deleted successfully.\n");
+}
+
+void deleteFileByName(char *fileName)
+{
+    if (currentDirectory->firstChild == NO_INODE)
+    {
+        printf("No file found.\n");
+        return;
+    }
+    Node *temporaryNode = findChildNode(currentDirectory, fileName);
+    if (temporaryNode != NULL && !temporaryNode->isFolder)
+    {
+        removeFile(temporaryNode);
+        return;
+    }
+    printf("No file found with name %s.\n", fileName);
+}
+
+void removeDirectory(char *dirName)
+{
+    if (currentDirectory->firstChild == NO_INODE)
+    {
+        printf("No directory found.\n");
+        return;
+    }
+    Node *temporaryNode = findChildNode(currentDirectory, dirName);
+    if (temporaryNode == NULL)
+    {
+        printf("No directory found with name %s.\n", dirName);
+        return;
+    }
+    if (!temporaryNode->isFolder)
+    {
+        printf("%s is not a directory.\n", dirName);
+        return;
+    }
+    if (temporaryNode->firstChild != NO_INODE)
+    {
+        printf("Directory not empty. Remove files first.\n");
+        return;
+    }
+    if (directoryInUse(temporaryNode))
+    {
+        printf("%s is in use by another session.\n", dirName);
+        return;
+    }
+    markNodeChanged(currentDirectory, 1);
+    journalBeginRecord(JOURNAL_REMOVE_DIRECTORY);
+    journalAppendPath(currentDirectory, nodeName(temporaryNode));
+    journalAppendTimes(currentDirectory);
+    journalEndRecord();
+    int releasedCount = 0;
+    retireSubtree(currentDirectory, temporaryNode, &releasedCount);
+    printf("Directory removed successfully.\n");
+}
+
+int pushChildrenInOrder(NodeStack *stack, Node *directory)
+{
+    Node *child = inodeAt(directory->firstChild);
+    if (child == NULL)
+    {
+        return 1;
+    }
+    int segmentStart = stack->count;
+    do
+    {
+        if (!pushNode(stack, child))
+        {
+            return 0;
+        }
+        child = inodeAt(child->nextSibling);
+    } while (child->inodeNumber != directory->firstChild);
+
+    for (int low = segmentStart, high = stack->count - 1; low < high; low++, high--)
+    {
+        Node *swapNode = stack->items[low];
+        stack->items[low] = stack->items[high];
+        stack->items[high] = swapNode;
+    }
+    return 1;
+}
+
+void buildNodePath(Node *node, char *path, int pathSize)
+{
+    char temporaryPath[MAX_PATH_LENGTH] = "";
+    path[0] = '\0';
+    while (node != rootDirectory)
+    {
+        snprintf(temporaryPath, sizeof(temporaryPath), "/%s%s", nodeName(node), path);
+        strncpy(path, temporaryPath, pathSize - 1);
+        path[pathSize - 1] = '\0';
+        node = inodeAt(node->parent);
+    }
+    if (path[0] == '\0')
+    {
+        strncpy(path, "/", pathSize);
+    }
+}
+
+/* Drops the block references of every file in an unlinked subtree and returns how many nodes it holds. Waiting for each
+   folder's write lock lets a command that is working inside it finish first. */
+int dropSubtreeBlocks(Node *subtreeRoot, int releasedBlocks[], int *releasedCount)
+{
+    NodeStack pendingNodes;
+    initializeNodeStack(&pendingNodes);
+    int removedNodes = 0;
+    Node *node = subtreeRoot;
+
+    while (node)
+    {
+        if (node->isFolder)
+        {
+            lockDirectoryForWalk(node, 1);
+            int pushed = pushChildrenInOrder(&pendingNodes, node);
+            unlockDirectoryForWalk(node);
+            if (!pushed)
+            {
+                break;
+            }
+        }
+        for (int index = 0; index < node->blockCount; index++)
+        {
+            if (dropBlockReference(node->blockMap->allocatedBlocks[index]))
+            {
+                releasedBlocks[(*releasedCount)++] = node->blockMap->allocatedBlocks[index];
+            }
+        }
+        removedNodes++;
+        node = popNode(&pendingNodes);
+    }
+
+    destroyNodeStack(&pendingNodes);
+    return removedNodes;
+}
+
+void releaseSubtreeInodes(Node *subtreeRoot)
+{
+    NodeStack pendingNodes;
+    initializeNodeStack(&pendingNodes);
+    Node *node = subtreeRoot;
+
+    while (node)
+    {
+        int pushed = !node->isFolder || pushChildrenInOrder(&pendingNodes, node);
+        releaseInode(node);
+        if (!pushed)
+        {
+            break;
+        }
+        node = popNode(&pendingNodes);
+    }
+
+    destroyNodeStack(&pendingNodes);
+}
+
+int releaseSubtree(Node *subtreeRoot, int releasedBlocks[], int *releasedCount)
+{
+    int removedNodes = dropSubtreeBlocks(subtreeRoot, releasedBlocks, releasedCount);
+    releaseSubtreeInodes(subtreeRoot);
+    return removedNodes;
+}
+
+/* Frees the subtree at once; only for callers that know no other command is running. */
+int removeSubtree(Node *directory, Node *target, int *releasedCount)
+{
+    unlinkChildNode(directory, target);
+
+    int releasedBlocks[TOTAL_DISK_BLOCKS];
+    *releasedCount = 0;
+    int removedNodes = releaseSubtree(target, releasedBlocks, releasedCount);
+    releaseBlocksInBulk(releasedBlocks, *releasedCount);
+    return removedNodes;
+}
+
+/* Releases the blocks now but keeps the inodes until reclaimRetiredSubtrees runs with no command in flight, because a
+   du, find or cp that started above the directory may still have them on its stack. */
+int retireSubtree(Node *directory, Node *target, int *releasedCount)
+{
+    unlinkChildNode(directory, target);
+
+    int releasedBlocks[TOTAL_DISK_BLOCKS];
+    *releasedCount = 0;
+    int removedNodes = dropSubtreeBlocks(target, releasedBlocks, releasedCount);
+    releaseBlocksInBulk(releasedBlocks, *releasedCount);
+    pthread_mutex_lock(&retiredMutex);
+    if (!pushNode(&retiredSubtrees, target))
+    {
+        releaseSubtreeInodes(target);
+    }
+    pthread_mutex_unlock(&retiredMutex);
+    return removedNodes;
+}
+
+int hasRetiredSubtrees()
+{
+    return __atomic_load_n(&retiredSubtrees.count, __ATOMIC_RELAXED) > 0;
+}
+
+/* Callers hold vfsBarrierLock exclusively. */
+void reclaimRetiredSubtrees()
+{
+    pthread_mutex_lock(&retiredMutex);
+    Node *subtreeRoot;
+    while ((subtreeRoot = popNode(&retiredSubtrees)) != NULL)
+    {
+        releaseSubtreeInodes(subtreeRoot);
+    }
+    pthread_mutex_unlock(&retiredMutex);
+}
+
+void removeTreeRecursive(char *targetName)
+{
+    Node *target = findChildNode(currentDirectory, targetName);
+    if (target == NULL)
+    {
+        printf("No file or directory found with name %s.\n", targetName);
+        return;
+    }
+    /* Entering the tree means passing through this directory, which the dispatcher holds for writing. */
+    if (directoryInUse(target))
+    {
+        printf("%s is in use by another session.\n", targetName);
+        return;
+    }
+
+    markNodeChanged(currentDirectory, 1);
+    journalBeginRecord(JOURNAL_REMOVE_TREE);
+    journalAppendPath(currentDirectory, nodeName(target));
+    journalAppendTimes(currentDirectory);
+    journalEndRecord();
+
+    int releasedCount = 0;
+    int removedNodes = retireSubtree(currentDirectory, target, &releasedCount);
+    printf("Removed %d entries, released %d blocks.\n", removedNodes, releasedCount);
+}
+
+typedef struct SubtreeUsage
+{
+    long totalBytes;
+    int totalBlocks;
+    int fileCount;
+    int folderCount;
+} SubtreeUsage;
+
+void summarizeSubtree(Node *subtreeRoot, SubtreeUsage *usage)
+{
+    NodeStack pendingNodes;
+    initializeNodeStack(&pendingNodes);
+    memset(usage, 0, sizeof(*usage));
+    Node *node = subtreeRoot;
+
+    while (node)
+    {
+        if (node->isFolder)
+        {
+            usage->folderCount++;
+            lockDirectoryForWalk(node, 0);
+            int pushed = pushChildrenInOrder(&pendingNodes, node);
+            unlockDirectoryForWalk(node);
+            if (!pushed)
+            {
+                break;
+            }
+        }
+        else
+        {
+            usage->fileCount++;
+            usage->totalBytes += node->dataSize;
+            usage->totalBlocks += node->blockCount;
+        }
+        node = popNode(&pendingNodes);
+    }
+
+    destroyNodeStack(&pendingNodes);
+}
+
+void showSubtreeUsage(char *targetName)
+{
+    Node *target = currentDirectory;
+    if (targetName != NULL)
+    {
+        target = findChildNode(currentDirectory, targetName);
+        if (target == NULL)
+        {
+            printf("No file or directory found with name %s.\n", targetName);
+            return;
+        }
+    }
+
+    SubtreeUsage usage;
+    summarizeSubtree(target, &usage);
+    printf("%ld bytes in %d blocks (%d files, %d directories)\n", usage.totalBytes, usage.totalBlocks, usage.fileCount, usage.folderCount);
+}
+
+void findNodes(char *pattern)
+{
+    NodeStack pendingNodes;
+    initializeNodeStack(&pendingNodes);
+    char path[MAX_PATH_LENGTH];
+    int matchCount = 0;
+
+    if (!pushChildrenInOrder(&pendingNodes, currentDirectory))
+    {
+        destroyNodeStack(&pendingNodes);
+        return;
+    }
+
+    Node *node;
+    while ((node = popNode(&pendingNodes)) != NULL)
+    {
+        if (fnmatch(pattern, nodeName(node), 0) == 0)
+        {
+            buildNodePath(node, path, sizeof(path));
+            printf("%s%s\n", path, node->isFolder ? "/" : "");
+            matchCount++;
+        }
+        if (node->isFolder)
+        {
+            lockDirectoryForWalk(node, 0);
+            int pushed = pushChildrenInOrder(&pendingNodes, node);
+            unlockDirectoryForWalk(node);
+            if (!pushed)
+            {
+                break;
+            }
+        }
+    }
+
+    if (matchCount == 0)
+    {
+        printf("No matches for %s.\n", pattern);
+    }
+    destroyNodeStack(&pendingNodes);
+}
+
+int copyFileContent(Node *source, Node *destination)
+{
+    if (source->isFolder || source->blockMap == NULL)
+    {
+        return 1;
+    }
+    destination->blockMap = createBlockMap(source->blockMap->chunkCount, source->blockCount);
+    if (destination->blockMap == NULL)
+    {
+        return 0;
+    }
+    memcpy(destination->blockMap->chunks, source->blockMap->chunks, source->blockMap->chunkCount * sizeof(ChunkExtent));
+    for (int index = 0; index < source->blockCount; index++)
+    {
+        int blockIndex = storeBlock(diskMemory[source->blockMap->allocatedBlocks[index]]);
+        if (blockIndex == -1)
+        {
+            return 0;
+        }
+        destination->blockMap->allocatedBlocks[destination->blockCount++] = blockIndex;
+    }
+    destination->dataSize = source->dataSize;
+    destination->compressionEnabled = source->compressionEnabled;
+    return 1;
+}
+
+/* Every copy is stamped with copyTime so that journal replay can reproduce the timestamps. */
+int copySubtree(Node *source, Node *destinationDirectory, const char *destinationName, uint32_t copyTime)
+{
+    Node *copyRoot = createDetachedNode(destinationName, source->isFolder);
+    if (copyRoot == NULL)
+    {
+        return 0;
+    }
+    if (!copyFileContent(source, copyRoot) || !appendChildNode(destinationDirectory, copyRoot))
+    {
+        discardDetachedNode(copyRoot);
+        return 0;
+    }
+    copyRoot->modifiedTime = copyTime;
+    copyRoot->changedTime = copyTime;
+
+    /* Pairs are pushed as (source, copy) and popped as (copy, source). */
+    NodeStack pendingPairs;
+    initializeNodeStack(&pendingPairs);
+    if (source->isFolder)
+    {
+        pushNode(&pendingPairs, source);
+        pushNode(&pendingPairs, copyRoot);
+    }
+
+    int copiedNodes = 1;
+    while (pendingPairs.count >= 2)
+    {
+        Node *destinationFolder = popNode(&pendingPairs);
+        Node *sourceFolder = popNode(&pendingPairs);
+        lockDirectoryForWalk(sourceFolder, 0);
+        Node *child = inodeAt(sourceFolder->firstChild);
+        if (child == NULL)
+        {
+            unlockDirectoryForWalk(sourceFolder);
+            continue;
+        }
+        do
+        {
+            Node *childCopy = createDetachedNode(nodeName(child), child->isFolder);
+            if (childCopy == NULL)
+            {
+                break;
+            }
+            if (!copyFileContent(child, childCopy) || !appendChildNode(destinationFolder, childCopy))
+            {
+                discardDetachedNode(childCopy);
+                break;
+            }
+            childCopy->modifiedTime = copyTime;
+            childCopy->changedTime = copyTime;
+            copiedNodes++;
+            if (child->isFolder && (!pushNode(&pendingPairs, child) || !pushNode(&pendingPairs, childCopy)))
+            {
+                break;
+            }
+            child = inodeAt(child->nextSibling);
+        } while (child->inodeNumber != sourceFolder->firstChild);
+        unlockDirectoryForWalk(sourceFolder);
+    }
+
+    destroyNodeStack(&pendingPairs);
+    return copiedNodes;
+}
+
+void copyTreeRecursive(char *sourceName, char *destinationName, int recursive)
+{
+    Node *source = findChildNode(currentDirectory, sourceName);
+    if (source == NULL)
+    {
+        printf("No file or directory found with name %s.\n", sourceName);
+        return;
+    }
+    if (source->isFolder && !recursive)
+    {
+        printf("%s is a directory. Use cp -r to copy it.\n", sourceName);
+        return;
+    }
+    if (strlen(destinationName) >= MAX_FILENAME_LENGTH)
+    {
+        printf("Name %s is too long.\n", destinationName);
+        return;
+    }
+    if (findChildNode(currentDirectory, destinationName) != NULL)
+    {
+        printf("%s already exists.\n", destinationName);
+        return;
+    }
+
+    SubtreeUsage usage;
+    summarizeSubtree(source, &usage);
+    if (!dedupEnabled && usage.totalBlocks > freeBlockCount)
+    {
+        printf("Not enough free blocks: need %d, have %d.\n", usage.totalBlocks, freeBlockCount);
+        return;
+    }
+
+    int copiedNodes = copySubtree(source, currentDirectory, destinationName, (uint32_t)time(NULL));
+    if (copiedNodes == 0)
+    {
+        printf("Could not copy %s.\n", sourceName);
+        return;
+    }
+    markNodeChanged(currentDirectory, 1);
+    journalBeginRecord(JOURNAL_COPY);
+    journalAppendPath(currentDirectory, sourceName);
+    journalAppendPath(currentDirectory, destinationName);
+    journalAppendTimes(findChildNode(currentDirectory, destinationName));
+    journalAppendTimes(currentDirectory);
+    journalEndRecord();
+    printf("Copied %d entries (%d blocks).\n", copiedNodes, usage.totalBlocks);
+}
+
+int reencodeFile(Node *file, int enable)
+{
+    if (file->compressionEnabled == enable || file->dataSize == 0)
+    {
+        file->compressionEnabled = enable;
+        return 1;
+    }
+
+    char *content = (char *)malloc(file->dataSize);
+    if (content == NULL)
+    {
+        printf("Memory allocation failed.");
+        return 0;
+    }
+    int offset = 0;
+    for (int chunkIndex = 0; chunkIndex < fileChunkCount(file); chunkIndex++)
+    {
+        int rawLength = readFileChunk(file, chunkIndex, content + offset);
+        if (rawLength < 0)
+        {
+            printf("Corrupted data in chunk %d.\n", chunkIndex);
+            free(content);
+            return 0;
+        }
+        offset += rawLength;
+    }
+    /* The old blocks stay allocated until the new encoding is fully stored, so a full disk leaves the file as it was. */
+    FileBlockMap *oldBlockMap = file->blockMap;
+    int oldBlockCount = file->blockCount;
+    int oldDataSize = file->dataSize;
+    file->blockMap = NULL;
+    file->blockCount = 0;
+    file->dataSize = 0;
+    file->compressionEnabled = enable;
+    int rewritten = storeFileData(file, content, offset);
+    if (rewritten)
+    {
+        releaseBlockMap(oldBlockMap, oldBlockCount);
+    }
+    else
+    {
+        file->blockMap = oldBlockMap;
+        file->blockCount = oldBlockCount;
+        file->dataSize = oldDataSize;
+        file->compressionEnabled = !enable;
+    }
+    free(content);
+    return rewritten;
+}
+
+void setFileCompression(char *fileName, char *mode)
+{
+    Node *file = findChildNode(currentDirectory, fileName);
+    if (file == NULL || file->isFolder)
+    {
+        printf("No file found with name %s.\n", fileName);
+        return;
+    }
+    int enable;
+    if (mode == NULL || strcmp(mode, "on") == 0)
+    {
+        enable = 1;
+    }
+    else if (strcmp(mode, "off") == 0)
+    {
+        enable = 0;
+    }
+    else
+    {
+        printf("Syntax: compress filename [on|off]\n");
+        return;
+    }
+
+    if (!reencodeFile(file, enable))
+    {
+        printf("Not enough space to re-encode %s.\n", fileName);
+        return;
+    }
+    markNodeChanged(file, 0);
+    journalBeginRecord(JOURNAL_COMPRESS);
+    journalAppendPath(currentDirectory, fileName);
+    journalAppendByte((unsigned char)enable);
+    journalAppendTimes(file);
+    journalEndRecord();
+    printf("Compression %s for %s (%d bytes in %d blocks).\n", enable ? "on" : "off", fileName, file->dataSize, file->blockCount);
+}
+
+typedef struct FragmentationReport
+{
+    int fileCount;
+    int fileExtents;
+    int fragmentedFiles;
+    int freeExtents;
+} FragmentationReport;
+
+int countFileExtents(Node *file)
+{
+    int extents = file->blockCount > 0;
+    for (int index = 1; index < file->blockCount; index++)
+    {
+        if (file->blockMap->allocatedBlocks[index] != file->blockMap->allocatedBlocks[index - 1] + 1)
+        {
+            extents++;
+        }
+    }
+    return extents;
+}
+
+/* Callers hold allocatorMutex; slots of blocks that are not on the free list are left NULL. */
+void mapFreeBlocks(DiskBlock *freeBlockSlots[])
+{
+    memset(freeBlockSlots, 0, TOTAL_DISK_BLOCKS * sizeof(DiskBlock *));
+    for (DiskBlock *block = freeBlockListHead; block != NULL; block = block->next)
+    {
+        freeBlockSlots[block->blockIndex] = block;
+    }
+}
+
+int countFreeExtents()
+{
+    DiskBlock *freeBlockSlots[TOTAL_DISK_BLOCKS];
+    pthread_mutex_lock(&allocatorMutex);
+    mapFreeBlocks(freeBlockSlots);
+    pthread_mutex_unlock(&allocatorMutex);
+    int extents = 0;
+    for (int index = 0; index < TOTAL_DISK_BLOCKS; index++)
+    {
+        if (freeBlockSlots[index] != NULL && (index == 0 || freeBlockSlots[index - 1] == NULL))
+        {
+            extents++;
+        }
+    }
+    return extents;
+}
+
+void measureFragmentation(FragmentationReport *report)
+{
+    NodeStack pendingNodes;
+    initializeNodeStack(&pendingNodes);
+    memset(report, 0, sizeof(*report));
+    Node *node = rootDirectory;
+
+    while (node)
+    {
+        if (node->isFolder)
+        {
+            lockDirectoryForWalk(node, 0);
+            int pushed = pushChildrenInOrder(&pendingNodes, node);
+            unlockDirectoryForWalk(node);
+            if (!pushed)
+            {
+                break;
+            }
+        }
+        else if (node->blockCount > 0)
+        {
+            int extents = countFileExtents(node);
+            report->fileCount++;
+            report->fileExtents += extents;
+            report->fragmentedFiles += extents > 1;
+        }
+        node = popNode(&pendingNodes);
+    }
+
+    destroyNodeStack(&pendingNodes);
+    report->freeExtents = countFreeExtents();
+}
+
+int findLowestFreeRun(DiskBlock *freeBlockSlots[], int length, int limit)
+{
+    int runLength = 0;
+    for (int index = 0; index < limit; index++)
+    {
+        runLength = freeBlockSlots[index] != NULL ? runLength + 1 : 0;
+        if (runLength == length)
+        {
+            return index - length + 1;
+        }
+    }
+    return -1;
+}
+
+void unlinkFreeBlock(DiskBlock *block)
+{
+    if (block->previous)
+    {
+        block->previous->next = block->next;
+    }
+    else
+    {
+        freeBlockListHead = block->next;
+    }
+    if (block->next)
+    {
+        block->next->previous = block->previous;
+    }
+    free(block);
+}
+
+/* Moves a file into the lowest free run that fits, when that makes it contiguous or moves it toward the start of the disk.
+   Blocks shared through dedup are pinned, which pins the whole file. Returns the number of blocks moved or -1 if pinned. */
+int relocateFile(Node *file)
+{
+    int length = file->blockCount;
+    int *allocatedBlocks = file->blockMap->allocatedBlocks;
+    if (dedupEnabled)
+    {
+        pthread_mutex_lock(&dedupMutex);
+    }
+    for (int index = 0; index < length; index++)
+    {
+        if (blockReferenceCount[allocatedBlocks[index]] > 1)
+        {
+            if (dedupEnabled)
+            {
+                pthread_mutex_unlock(&dedupMutex);
+            }
+            return -1;
+        }
+    }
+
+    DiskBlock *freeBlockSlots[TOTAL_DISK_BLOCKS];
+    pthread_mutex_lock(&allocatorMutex);
+    mapFreeBlocks(freeBlockSlots);
+    int contiguous = countFileExtents(file) == 1;
+    int target = findLowestFreeRun(freeBlockSlots, length, contiguous ? allocatedBlocks[0] : TOTAL_DISK_BLOCKS);
+    if (target == -1)
+    {
+        pthread_mutex_unlock(&allocatorMutex);
+        if (dedupEnabled)
+        {
+            pthread_mutex_unlock(&dedupMutex);
+        }
+        return 0;
+    }
+    for (int index = 0; index < length; index++)
+    {
+        unlinkFreeBlock(freeBlockSlots[target + index]);
+    }
+    pthread_mutex_unlock(&allocatorMutex);
+    __atomic_sub_fetch(&freeBlockCount, length, __ATOMIC_RELAXED);
+
+    int releasedBlocks[MAX_BLOCKS_PER_FILE];
+    for (int index = 0; index < length; index++)
+    {
+        int source = allocatedBlocks[index];
+        memcpy(diskMemory[target + index], diskMemory[source], BLOCK_SIZE);
+        blockReferenceCount[target + index] = 1;
+        blockReferenceCount[source] = 0;
+        if (blockIndexed[source])
+        {
+            unindexBlockFingerprint(source);
+            indexBlockFingerprint(target + index);
+        }
+        allocatedBlocks[index] = target + index;
+        releasedBlocks[index] = source;
+    }
+    if (dedupEnabled)
+    {
+        pthread_mutex_unlock(&dedupMutex);
+    }
+    releaseBlocksInBulk(releasedBlocks, length);
+    return length;
+}
+
+void defragmentDisk()
+{
+    /* Blocks parked in this thread's allocation cache are off the free list, so hand them back before mapping free space. */
+    releaseThreadBlockCache();
+
+    FragmentationReport before;
+    measureFragmentation(&before);
+    printf("Before: %d files in %d extents (%d fragmented), %d free extents\n", before.fileCount, before.fileExtents, before.fragmentedFiles, before.freeExtents);
+
+    NodeStack pendingNodes;
+    initializeNodeStack(&pendingNodes);
+    int visitedFiles = 0;
+    int movedFiles = 0;
+    int movedBlocks = 0;
+    int pinnedFiles = 0;
+    int reportedPercent = -1;
+    Node *folder = rootDirectory;
+
+    /* defrag is an exclusive command: walking from the root while the dispatcher held a subdirectory would lock child
+       before parent, so the walk locks nothing and other sessions wait until it is done. */
+    while (folder)
+    {
+        lockDirectoryForWalk(folder, 1);
+        Node *child = inodeAt(folder->firstChild);
+        int pushed = pushChildrenInOrder(&pendingNodes, folder);
+        if (child != NULL)
+        {
+            do
+            {
+                if (!child->isFolder && child->blockCount > 0)
+                {
+                    int moved = relocateFile(child);
+                    visitedFiles++;
+                    pinnedFiles += moved < 0;
+                    movedFiles += moved > 0;
+                    movedBlocks += moved > 0 ? moved : 0;
+                }
+                child = inodeAt(child->nextSibling);
+            } while (child->inodeNumber != folder->firstChild);
+        }
+        unlockDirectoryForWalk(folder);
+        if (!pushed)
+        {
+            break;
+        }
+
+        int percent = before.fileCount > 0 ? visitedFiles * 100 / before.fileCount : 100;
+        if (percent > 100)
+        {
+            percent = 100;
+        }
+        if (percent / 10 != reportedPercent / 10)
+        {
+            printf("Defragmenting... %d%% (%d/%d files)\n", percent, visitedFiles, before.fileCount);
+            reportedPercent = percent;
+        }
+
+        do
+        {
+            folder = popNode(&pendingNodes);
+        } while (folder != NULL && !folder->isFolder);
+    }
+    destroyNodeStack(&pendingNodes);
+
+    FragmentationReport after;
+    measureFragmentation(&after);
+    printf("Moved %d blocks in %d files (%d files pinned by shared blocks).\n", movedBlocks, movedFiles, pinnedFiles);
+    printf("After: %d files in %d extents (%d fragmented), %d free extents\n", after.fileCount, after.fileExtents, after.fragmentedFiles, after.freeExtents);
+}
+
+void showNodeStatus(char *name)
+{
+    Node *node = findChildNode(currentDirectory, name);
+    if (node == NULL)
+    {
+        printf("No file or directory found with name %s.\n", name);
+        return;
+    }
+    char modifiedText[32];
+    char changedText[32];
+    formatNodeTime(node->modifiedTime, modifiedText, sizeof(modifiedText));
+    formatNodeTime(node->changedTime, changedText, sizeof(changedText));
+    printf("%-8s %s\n", "Name:", nodeName(node));
+    printf("%-8s %s\n", "Type:", node->isFolder ? "directory" : "file");
+    printf("%-8s %u\n", "Inode:", node->inodeNumber);
+    if (node->isFolder)
+    {
+        printf("%-8s %u\n", "Entries:", node->directory->childCount);
+    }
+    else
+    {
+        printf("%-8s %d bytes\n", "Size:", node->dataSize);
+        printf("%-8s %d in %d extents (compression %s)\n", "Blocks:", node->blockCount, countFileExtents(node), node->compressionEnabled ? "on" : "off");
+    }
+    printf("%-8s %s\n", "Modify:", modifiedText);
+    printf("%-8s %s\n", "Change:", changedText);
+}
+
+void showDiskUsage()
+{
+    int availableBlocks = __atomic_load_n(&freeBlockCount, __ATOMIC_RELAXED);
+    printf("Total blocks: %d\n", TOTAL_DISK_BLOCKS);
+    printf("Used blocks: %d\n", TOTAL_DISK_BLOCKS - availableBlocks);
+    printf("Free blocks: %d\n", availableBlocks);
+    printf("Disk usage: %.2f%%\n", (float)((TOTAL_DISK_BLOCKS - availableBlocks) * 100.0) / TOTAL_DISK_BLOCKS);
+    long logicalBytes = __atomic_load_n(&logicalBlockCount, __ATOMIC_RELAXED) * BLOCK_SIZE;
+    long physicalBytes = (long)(TOTAL_DISK_BLOCKS - availableBlocks) * BLOCK_SIZE;
+    printf("Logical bytes: %ld\n", logicalBytes);
+    printf("Physical bytes: %ld\n", physicalBytes);
+    printf("Saved by dedup: %ld bytes (dedup %s)\n", logicalBytes - physicalBytes, dedupEnabled ? "on" : "off");
+    pthread_mutex_lock(&inodeMutex);
+    uint32_t inodesInUse = liveInodeCount;
+    pthread_mutex_unlock(&inodeMutex);
+    pthread_mutex_lock(&nameMutex);
+    printf("Inodes: %u in use (%zu bytes each), %u distinct names in %ld arena bytes\n", inodesInUse, sizeof(Node), internedNameCount, nameArenaBytes);
+    pthread_mutex_unlock(&nameMutex);
+}
+
+void indexExistingBlocks()
+{
+    NodeStack pendingNodes;
+    initializeNodeStack(&pendingNodes);
+    Node *node = rootDirectory;
+
+    while (node)
+    {
+        for (int index = 0; index < node->blockCount; index++)
+        {
+            indexBlockFingerprint(node->blockMap->allocatedBlocks[index]);
+        }
+        if (!pushChildrenInOrder(&pendingNodes, node))
+        {
+            break;
+        }
+        node = popNode(&pendingNodes);
+    }
+
+    destroyNodeStack(&pendingNodes);
+}
+
+void clearFingerprintIndex()
+{
+    for (int bucket = 0; bucket < FINGERPRINT_BUCKETS; bucket++)
+    {
+        fingerprintBucketHead[bucket] = -1;
+    }
+    memset(blockIndexed, 0, sizeof(blockIndexed));
+}
+
+void applyDedupMode(int enable)
+{
+    if (enable && !dedupEnabled)
+    {
+        dedupEnabled = 1;
+        indexExistingBlocks();
+    }
+    else if (!enable && dedupEnabled)
+    {
+        dedupEnabled = 0;
+        clearFingerprintIndex();
+    }
+}
+
+void setDedupMode(char *mode)
+{
+    if (mode == NULL)
+    {
+        printf("Dedup is %s.\n", dedupEnabled ? "on" : "off");
+        return;
+    }
+    if (strcmp(mode, "on") != 0 && strcmp(mode, "off") != 0)
+    {
+        printf("Syntax: dedup [on|off]\n");
+        return;
+    }
+    int enable = strcmp(mode, "on") == 0;
+    applyDedupMode(enable);
+    journalBeginRecord(JOURNAL_DEDUP);
+    journalAppendByte((unsigned char)enable);
+    journalEndRecord();
+    printf("Dedup %s.\n", enable ? "enabled" : "disabled");
+}
+
+uint32_t checksumBytes(uint32_t hash, const unsigned char *bytes, size_t length)
+{
+    for (size_t index = 0; index < length; index++)
+    {
+        hash = (hash ^ bytes[index]) * 16777619U;
+    }
+    return hash;
+}
+
+void encodeUint32(unsigned char *target, uint32_t value)
+{
+    for (int index = 0; index < 4; index++)
+    {
+        target[index] = (unsigned char)(value >> (8 * index));
+    }
+}
+
+void encodeUint64(unsigned char *target, uint64_t value)
+{
+    for (int index = 0; index < 8; index++)
+    {
+        target[index] = (unsigned char)(value >> (8 * index));
+    }
+}
+
+uint32_t decodeUint32(const unsigned char *source)
+{
+    uint32_t value = 0;
+    for (int index = 3; index >= 0; index--)
+    {
+        value = (value << 8) | source[index];
+    }
+    return value;
+}
+
+uint64_t decodeUint64(const unsigned char *source)
+{
+    uint64_t value = 0;
+    for (int index = 7; index >= 0; index--)
+    {
+        value = (value << 8) | source[index];
+    }
+    return value;
+}
+
+int reserveJournalBuffer(size_t extraBytes)
+{
+    if (journalBufferLength + extraBytes <= journalBufferCapacity)
+    {
+        return 1;
+    }
+    size_t newCapacity = journalBufferCapacity ? journalBufferCapacity : 4096;
+    while (newCapacity < journalBufferLength + extraBytes)
+    {
+        newCapacity *= 2;
+    }
+    unsigned char *grownBuffer = (unsigned char *)realloc(journalBuffer, newCapacity);
+    if (grownBuffer == NULL)
+    {
+        printf("Memory allocation failed");
+        return 0;
+    }
+    journalBuffer = grownBuffer;
+    journalBufferCapacity = newCapacity;
+    return 1;
+}
+
+void journalAppendRaw(const void *bytes, size_t length)
+{
+    if (journalFile == NULL || journalRecordBroken)
+    {
+        return;
+    }
+    if (!reserveJournalBuffer(length))
+    {
+        journalRecordBroken = 1;
+        return;
+    }
+    memcpy(journalBuffer + journalBufferLength, bytes, length);
+    journalBufferLength += length;
+}
+
+void journalBeginRecord(JournalRecordType type)
+{
+    if (journalFile == NULL)
+    {
+        return;
+    }
+    pthread_mutex_lock(&journalMutex);
+    journalRecordStart = journalBufferLength;
+    journalRecordBroken = !reserveJournalBuffer(JOURNAL_HEADER_SIZE);
+    if (journalRecordBroken)
+    {
+        return;
+    }
+    memset(journalBuffer + journalRecordStart, 0, JOURNAL_HEADER_SIZE);
+    journalBuffer[journalRecordStart + 12] = (unsigned char)type;
+    journalBufferLength += JOURNAL_HEADER_SIZE;
+}
+
+void journalAppendBytes(const void *bytes, uint32_t length)
+{
+    unsigned char encodedLength[4];
+    encodeUint32(encodedLength, length);
+    journalAppendRaw(encodedLength, sizeof(encodedLength));
+    journalAppendRaw(bytes, length);
+}
+
+void journalAppendPath(Node *directory, const char *name)
+{
+    char path[MAX_PATH_LENGTH];
+    char fullPath[MAX_PATH_LENGTH + MAX_FILENAME_LENGTH + 1];
+    if (journalFile == NULL)
+    {
+        return;
+    }
+    buildNodePath(directory, path, sizeof(path));
+    snprintf(fullPath, sizeof(fullPath), "%s%s%s", path, strcmp(path, "/") == 0 ? "" : "/", name);
+    journalAppendBytes(fullPath, strlen(fullPath));
+}
+
+void journalAppendByte(unsigned char value)
+{
+    journalAppendRaw(&value, 1);
+}
+
+/* Appended after a record's own fields for every node the operation stamped, so replay restores mtime and ctime. */
+void journalAppendTimes(const Node *node)
+{
+    unsigned char encodedTimes[8];
+    if (journalFile == NULL)
+    {
+        return;
+    }
+    encodeUint32(encodedTimes, node->modifiedTime);
+    encodeUint32(encodedTimes + 4, node->changedTime);
+    journalAppendRaw(encodedTimes, sizeof(encodedTimes));
+}
+
+int commitJournalLocked()
+{
+    if (journalFile == NULL || journalBufferLength == 0)
+    {
+        return 1;
+    }
+    if (fwrite(journalBuffer, 1, journalBufferLength, journalFile) != journalBufferLength || fflush(journalFile) != 0 || fsync(fileno(journalFile)) != 0)
+    {
+        printf("Journal write failed.\n");
+        return 0;
+    }
+    journalCommittedBytes += journalBufferLength;
+    journalBufferLength = 0;
+    journalPendingRecords = 0;
+    return 1;
+}
+
+int commitJournal()
+{
+    pthread_mutex_lock(&journalMutex);
+    int committed = commitJournalLocked();
+    pthread_mutex_unlock(&journalMutex);
+    return committed;
+}
+
+void commitJournalGroupLocked()
+{
+    if (!commitJournalLocked())
+    {
+        /* Retry on the next window instead of spinning on a failing disk. */
+        journalOldestPendingTime = time(NULL);
+        return;
+    }
+    if (journalCommittedBytes >= JOURNAL_CHECKPOINT_BYTES)
+    {
+        checkpointRequested = 1;
+    }
+}
+
+void journalEndRecord()
+{
+    if (journalFile == NULL)
+    {
+        return;
+    }
+    if (journalRecordBroken)
+    {
+        journalBufferLength = journalRecordStart;
+        journalRecordBroken = 0;
+        pthread_mutex_unlock(&journalMutex);
+        return;
+    }
+    unsigned char *header = journalBuffer + journalRecordStart;
+    uint32_t payloadLength = (uint32_t)(journalBufferLength - journalRecordStart - JOURNAL_HEADER_SIZE);
+    encodeUint32(header, JOURNAL_RECORD_MAGIC);
+    encodeUint64(header + 4, journalNextSequence++);
+    encodeUint32(header + 13, payloadLength);
+    uint32_t checksum = checksumBytes(2166136261U, header + 4, 13);
+    encodeUint32(header + 17, checksumBytes(checksum, header + JOURNAL_HEADER_SIZE, payloadLength));
+
+    if (journalPendingRecords++ == 0)
+    {
+        journalOldestPendingTime = time(NULL);
+        pthread_cond_signal(&journalPendingCondition);
+    }
+    /* Group commit: one fsync covers every record buffered since the last one. */
+    if (journalPendingRecords >= JOURNAL_GROUP_COMMIT_RECORDS || time(NULL) - journalOldestPendingTime >= JOURNAL_GROUP_COMMIT_SECONDS)
+    {
+        commitJournalGroupLocked();
+    }
+    pthread_mutex_unlock(&journalMutex);
+}
+
+/* Commits records that no later record arrived to flush, so none waits longer than the group commit window. */
+void *runJournalCommitter(void *argument)
+{
+    (void)argument;
+    pthread_mutex_lock(&journalMutex);
+    while (journalCommitterRunning)
+    {
+        if (journalPendingRecords == 0)
+        {
+            pthread_cond_wait(&journalPendingCondition, &journalMutex);
+            continue;
+        }
+        struct timespec deadline = {journalOldestPendingTime + JOURNAL_GROUP_COMMIT_SECONDS, 0};
+        if (time(NULL) >= deadline.tv_sec)
+        {
+            commitJournalGroupLocked();
+        }
+        else
+        {
+            pthread_cond_timedwait(&journalPendingCondition, &journalMutex, &deadline);
+        }
+    }
+    pthread_mutex_unlock(&journalMutex);
+    return NULL;
+}
+
+void startJournalCommitter()
+{
+    journalCommitterRunning = 1;
+    if (pthread_create(&journalCommitter, NULL, runJournalCommitter, NULL) != 0)
+    {
+        journalCommitterRunning = 0;
+        printf("Cannot start journal committer; records are synced only by the next commit.\n");
+    }
+}
+
+void stopJournalCommitter()
+{
+    if (!journalCommitterRunning)
+    {
+        return;
+    }
+    pthread_mutex_lock(&journalMutex);
+    journalCommitterRunning = 0;
+    pthread_cond_signal(&journalPendingCondition);
+    pthread_mutex_unlock(&journalMutex);
+    pthread_join(journalCommitter, NULL);
+}
+
+int nodeDepth(Node *node)
+{
+    int depth = 0;
+    while (node != rootDirectory)
+    {
+        depth++;
+        node = inodeAt(node->parent);
+    }
+    return depth;
+}
+
+int writeImageNode(FILE *image, Node *node, char *contentBuffer)
+{
+    unsigned char header[IMAGE_NODE_HEADER_SIZE];
+    uint16_t nameLength = (uint16_t)strlen(nodeName(node));
+    encodeUint32(header, (uint32_t)nodeDepth(node));
+    header[4] = (unsigned char)node->isFolder;
+    header[5] = (unsigned char)node->compressionEnabled;
+    header[6] = (unsigned char)(nameLength & 0xFF);
+    header[7] = (unsigned char)(nameLength >> 8);
+    encodeUint32(header + 8, node->isFolder ? 0 : (uint32_t)node->dataSize);
+    encodeUint32(header + 12, node->modifiedTime);
+    encodeUint32(header + 16, node->changedTime);
+    if (fwrite(header, 1, sizeof(header), image) != sizeof(header) || fwrite(nodeName(node), 1, nameLength, image) != nameLength)
+    {
+        return 0;
+    }
+    if (node->isFolder)
+    {
+        return 1;
+    }
+    for (int chunkIndex = 0; chunkIndex < fileChunkCount(node); chunkIndex++)
+    {
+        int rawLength = readFileChunk(node, chunkIndex, contentBuffer);
+        if (rawLength < 0 || fwrite(contentBuffer, 1, rawLength, image) != (size_t)rawLength)
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* Callers must hold vfsBarrierLock exclusively so the image matches the journal sequence number exactly. */
+int writeCheckpoint()
+{
+    if (journalFile == NULL || !commitJournal())
+    {
+        return 0;
+    }
+
+    char temporaryPath[MAX_PATH_LENGTH + 16];
+    snprintf(temporaryPath, sizeof(temporaryPath), "%s.tmp", imagePath);
+    FILE *image = fopen(temporaryPath, "wb");
+    if (image == NULL)
+    {
+        printf("Cannot write checkpoint %s.\n", temporaryPath);
+        return 0;
+    }
+
+    unsigned char header[IMAGE_MAGIC_LENGTH + 12];
+    memcpy(header, IMAGE_MAGIC, IMAGE_MAGIC_LENGTH);
+    encodeUint64(header + IMAGE_MAGIC_LENGTH, journalNextSequence - 1);
+    encodeUint32(header + IMAGE_MAGIC_LENGTH + 8, (uint32_t)dedupEnabled);
+    int written = fwrite(header, 1, sizeof(header), image) == sizeof(header);
+
+    char contentBuffer[COMPRESSION_CHUNK_SIZE];
+    NodeStack pendingNodes;
+    initializeNodeStack(&pendingNodes);
+    written = written && pushChildrenInOrder(&pendingNodes, rootDirectory);
+    Node *node;
+    while (written && (node = popNode(&pendingNodes)) != NULL)
+    {
+        written = writeImageNode(image, node, contentBuffer) && pushChildrenInOrder(&pendingNodes, node);
+    }
+    destroyNodeStack(&pendingNodes);
+
+    written = written && fflush(image) == 0 && fsync(fileno(image)) == 0;
+    if (fclose(image) != 0 || !written || rename(temporaryPath, imagePath) != 0)
+    {
+        printf("Checkpoint failed; journal kept.\n");
+        remove(temporaryPath);
+        return 0;
+    }
+
+    if (ftruncate(fileno(journalFile), 0) != 0)
+    {
+        printf("Journal truncate failed.\n");
+        return 0;
+    }
+    journalCommittedBytes = 0;
+    return 1;
+}
+
+uint64_t loadCheckpointImage(const char *path)
+{
+    FILE *image = fopen(path, "rb");
+    if (image == NULL)
+    {
+        return 0;
+    }
+
+    unsigned char header[IMAGE_MAGIC_LENGTH + 12];
+    int legacyImage = 0;
+    if (fread(header, 1, sizeof(header), image) != sizeof(header)
+        || (memcmp(header, IMAGE_MAGIC, IMAGE_MAGIC_LENGTH) != 0 && !(legacyImage = memcmp(header, LEGACY_IMAGE_MAGIC, IMAGE_MAGIC_LENGTH) == 0)))
+    {
+        printf("%s is not a VFS image.\n", path);
+        fclose(image);
+        return 0;
+    }
+    uint64_t checkpointSequence = decodeUint64(header + IMAGE_MAGIC_LENGTH);
+    applyDedupMode((int)decodeUint32(header + IMAGE_MAGIC_LENGTH + 8));
+
+    /* items[depth] is the folder that receives nodes at depth + 1. Legacy images carry no timestamps. */
+    NodeStack folderAtDepth;
+    initializeNodeStack(&folderAtDepth);
+    pushNode(&folderAtDepth, rootDirectory);
+
+    char *content = (char *)malloc(MAX_FILE_SIZE);
+    unsigned char nodeHeader[IMAGE_NODE_HEADER_SIZE];
+    size_t nodeHeaderSize = legacyImage ? LEGACY_IMAGE_NODE_HEADER_SIZE : IMAGE_NODE_HEADER_SIZE;
+    while (content != NULL && fread(nodeHeader, 1, nodeHeaderSize, image) == nodeHeaderSize)
+    {
+        int depth = (int)decodeUint32(nodeHeader);
+        int nameLength = nodeHeader[6] | (nodeHeader[7] << 8);
+        uint32_t dataSize = decodeUint32(nodeHeader + 8);
+        char name[MAX_FILENAME_LENGTH];
+        if (depth < 1 || depth > folderAtDepth.count || nameLength >= MAX_FILENAME_LENGTH || dataSize > MAX_FILE_SIZE
+            || fread(name, 1, nameLength, image) != (size_t)nameLength || fread(content, 1, dataSize, image) != dataSize)
+        {
+            printf("Checkpoint %s is truncated.\n", path);
+            break;
+        }
+        name[nameLength] = '\0';
+
+        Node *node = createDetachedNode(name, nodeHeader[4]);
+        if (node == NULL)
+        {
+            break;
+        }
+        if (!appendChildNode(folderAtDepth.items[depth - 1], node))
+        {
+            releaseInode(node);
+            break;
+        }
+        folderAtDepth.count = depth;
+        if (node->isFolder)
+        {
+            pushNode(&folderAtDepth, node);
+        }
+        else
+        {
+            node->compressionEnabled = nodeHeader[5];
+            storeFileData(node, content, (int)dataSize);
+        }
+        if (!legacyImage)
+        {
+            node->modifiedTime = decodeUint32(nodeHeader + 12);
+            node->changedTime = decodeUint32(nodeHeader + 16);
+        }
+    }
+
+    free(content);
+    destroyNodeStack(&folderAtDepth);
+    fclose(image);
+    return checkpointSequence;
+}
+
+Node *resolveJournalPath(const char *path, int wantParent, const char **leafName)
+{
+    Node *node = rootDirectory;
+    const char *cursor = path;
+    while (*cursor == '/')
+    {
+        cursor++;
+    }
+    while (*cursor != '\0')
+    {
+        const char *separator = strchr(cursor, '/');
+        int componentLength = separator ? (int)(separator - cursor) : (int)strlen(cursor);
+        if (separator == NULL && wantParent)
+        {
+            *leafName = cursor;
+            return node;
+        }
+        char component[MAX_FILENAME_LENGTH];
+        if (componentLength >= MAX_FILENAME_LENGTH)
+        {
+            return NULL;
+        }
+        memcpy(component, cursor, componentLength);
+        component[componentLength] = '\0';
+        node = findChildNode(node, component);
+        if (node == NULL)
+        {
+            return NULL;
+        }
+        cursor += componentLength;
+        while (*cursor == '/')
+        {
+            cursor++;
+        }
+    }
+    return wantParent ? NULL : node;
+}
+
+int readJournalField(const unsigned char *payload, uint32_t payloadLength, uint32_t *cursor, const unsigned char **field, uint32_t *fieldLength)
+{
+    if (*cursor + 4 > payloadLength)
+    {
+        return 0;
+    }
+    *fieldLength = decodeUint32(payload + *cursor);
+    *cursor += 4;
+    if (*fieldLength > payloadLength - *cursor)
+    {
+        return 0;
+    }
+    *field = payload + *cursor;
+    *cursor += *fieldLength;
+    return 1;
+}
+
+int readJournalPath(const unsigned char *payload, uint32_t payloadLength, uint32_t *cursor, char *path)
+{
+    const unsigned char *field;
+    uint32_t fieldLength;
+    if (!readJournalField(payload, payloadLength, cursor, &field, &fieldLength) || fieldLength >= MAX_PATH_LENGTH)
+    {
+        return 0;
+    }
+    memcpy(path, field, fieldLength);
+    path[fieldLength] = '\0';
+    return 1;
+}
+
+/* Records written before timestamps were journaled end early; their nodes keep the time of the replay. */
+int readJournalTimes(const unsigned char *payload, uint32_t payloadLength, uint32_t *cursor, uint32_t times[2])
+{
+    if (*cursor + 8 > payloadLength)
+    {
+        return 0;
+    }
+    times[0] = decodeUint32(payload + *cursor);
+    times[1] = decodeUint32(payload + *cursor + 4);
+    *cursor += 8;
+    return 1;
+}
+
+void restoreJournalTimes(const unsigned char *payload, uint32_t payloadLength, uint32_t *cursor, Node *node)
+{
+    uint32_t times[2];
+    if (readJournalTimes(payload, payloadLength, cursor, times))
+    {
+        node->modifiedTime = times[0];
+        node->changedTime = times[1];
+        invalidateChildOrder(inodeAt(node->parent));
+    }
+}
+
+int applyJournalRecord(JournalRecordType type, const unsigned char *payload, uint32_t payloadLength)
+{
+    char path[MAX_PATH_LENGTH];
+    char secondPath[MAX_PATH_LENGTH];
+    uint32_t cursor = 0;
+    const char *leafName = NULL;
+
+    if (type == JOURNAL_DEDUP)
+    {
+        if (payloadLength < 1)
+        {
+            return 0;
+        }
+        applyDedupMode(payload[0]);
+        return 1;
+    }
+    if (!readJournalPath(payload, payloadLength, &cursor, path))
+    {
+        return 0;
+    }
+
+    if (type == JOURNAL_MKDIR || type == JOURNAL_CREATE)
+    {
+        Node *directory = resolveJournalPath(path, 1, &leafName);
+        if (directory == NULL || strlen(leafName) >= MAX_FILENAME_LENGTH || findChildNode(directory, leafName) != NULL)
+        {
+            return 0;
+        }
+        Node *node = createDetachedNode(leafName, type == JOURNAL_MKDIR);
+        if (node == NULL)
+        {
+            return 0;
+        }
+        if (!appendChildNode(directory, node))
+        {
+            releaseInode(node);
+            return 0;
+        }
+        restoreJournalTimes(payload, payloadLength, &cursor, node);
+        restoreJournalTimes(payload, payloadLength, &cursor, directory);
+        return 1;
+    }
+
+    Node *target = resolveJournalPath(path, 0, NULL);
+    if (target == NULL || target == rootDirectory)
+    {
+        return 0;
+    }
+    if (type == JOURNAL_WRITE)
+    {
+        const unsigned char *data;
+        uint32_t dataLength;
+        if (!readJournalField(payload, payloadLength, &cursor, &data, &dataLength))
+        {
+            return 0;
+        }
+        storeFileData(target, (const char *)data, (int)dataLength);
+        restoreJournalTimes(payload, payloadLength, &cursor, target);
+        return 1;
+    }
+    if (type == JOURNAL_REMOVE_FILE || type == JOURNAL_REMOVE_DIRECTORY || type == JOURNAL_REMOVE_TREE)
+    {
+        Node *directory = inodeAt(target->parent);
+        int releasedCount = 0;
+        removeSubtree(directory, target, &releasedCount);
+        restoreJournalTimes(payload, payloadLength, &cursor, directory);
+        return 1;
+    }
+    if (type == JOURNAL_COPY)
+    {
+        if (!readJournalPath(payload, payloadLength, &cursor, secondPath))
+        {
+            return 0;
+        }
+        Node *directory = resolveJournalPath(secondPath, 1, &leafName);
+        if (directory == NULL || findChildNode(directory, leafName) != NULL)
+        {
+            return 0;
+        }
+        uint32_t copyTimes[2];
+        if (!readJournalTimes(payload, payloadLength, &cursor, copyTimes))
+        {
+            copyTimes[0] = (uint32_t)time(NULL);
+        }
+        if (copySubtree(target, directory, leafName, copyTimes[0]) == 0)
+        {
+            return 0;
+        }
+        restoreJournalTimes(payload, payloadLength, &cursor, directory);
+        return 1;
+    }
+    if (type == JOURNAL_COMPRESS)
+    {
+        if (cursor >= payloadLength)
+        {
+            return 0;
+        }
+        reencodeFile(target, payload[cursor++]);
+        restoreJournalTimes(payload, payloadLength, &cursor, target);
+        return 1;
+    }
+    return 0;
+}
+
+long replayJournal(uint64_t checkpointSequence, int *replayedRecords)
+{
+    FILE *journal = fopen(journalPath, "rb");
+    long validLength = 0;
+    *replayedRecords = 0;
+    if (journal == NULL)
+    {
+        return 0;
+    }
+
+    unsigned char header[JOURNAL_HEADER_SIZE];
+    unsigned char *payload = NULL;
+    while (fread(header, 1, JOURNAL_HEADER_SIZE, journal) == JOURNAL_HEADER_SIZE)
+    {
+        uint32_t payloadLength = decodeUint32(header + 13);
+        if (decodeUint32(header) != JOURNAL_RECORD_MAGIC)
+        {
+            break;
+        }
+        unsigned char *grownPayload = (unsigned char *)realloc(payload, payloadLength + 1);
+        if (grownPayload == NULL)
+        {
+            break;
+        }
+        payload = grownPayload;
+        if (fread(payload, 1, payloadLength, journal) != payloadLength)
+        {
+            break;
+        }
+        uint32_t checksum = checksumBytes(checksumBytes(2166136261U, header + 4, 13), payload, payloadLength);
+        if (checksum != decodeUint32(header + 17))
+        {
+            break;
+        }
+
+        uint64_t sequence = decodeUint64(header + 4);
+        if (sequence > checkpointSequence)
+        {
+            if (!applyJournalRecord((JournalRecordType)header[12], payload, payloadLength))
+            {
+                printf("Journal record %llu could not be applied; skipped.\n", (unsigned long long)sequence);
+            }
+            (*replayedRecords)++;
+        }
+        if (sequence >= journalNextSequence)
+        {
+            journalNextSequence = sequence + 1;
+        }
+        validLength += JOURNAL_HEADER_SIZE + payloadLength;
+    }
+
+    free(payload);
+    fclose(journal);
+    return validLength;
+}
+
+int mountImage(const char *path)
+{
+    if (strlen(path) >= sizeof(imagePath))
+    {
+        printf("Image path too long.\n");
+        return 0;
+    }
+    strcpy(imagePath, path);
+    snprintf(journalPath, sizeof(journalPath), "%s.journal", imagePath);
+
+    uint64_t checkpointSequence = loadCheckpointImage(imagePath);
+    journalNextSequence = checkpointSequence + 1;
+    int replayedRecords = 0;
+    long validLength = replayJournal(checkpointSequence, &replayedRecords);
+
+    journalFile = fopen(journalPath, "ab");
+    if (journalFile == NULL)
+    {
+        printf("Cannot open journal %s.\n", journalPath);
+        return 0;
+    }
+    if (ftruncate(fileno(journalFile), validLength) != 0)
+    {
+        printf("Cannot trim torn journal tail.\n");
+    }
+    journalCommittedBytes = validLength;
+    startJournalCommitter();
+    printf("Mounted %s (replayed %d journal records).\n", imagePath, replayedRecords);
+    return 1;
+}
+
+void unmountImage()
+{
+    if (journalFile == NULL)
+    {
+        return;
+    }
+    stopJournalCommitter();
+    writeCheckpoint();
+    commitJournal();
+    fclose(journalFile);
+    journalFile = NULL;
+    free(journalBuffer);
+    journalBuffer = NULL;
+    journalBufferLength = 0;
+    journalBufferCapacity = 0;
+}
+
+typedef struct ImportEntry
+{
+    Node *file;
+    size_t dataOffset;
+    int length;
+    int firstFingerprint;
+} ImportEntry;
+
+typedef struct ImportBatch
+{
+    ImportEntry entries[IMPORT_BATCH_FILES];
+    int entryCount;
+    char *data;
+    size_t dataLength;
+    uint64_t *fingerprints;
+    int fingerprintCount;
+    int fileCount;
+    int folderCount;
+    int skippedCount;
+    long byteCount;
+    int failed;
+} ImportBatch;
+
+typedef struct FingerprintWorker
+{
+    pthread_t thread;
+    ImportBatch *batch;
+    int firstEntry;
+    int entryStride;
+} FingerprintWorker;
+
+void *fingerprintImportEntries(void *argument)
+{
+    FingerprintWorker *worker = (FingerprintWorker *)argument;
+    ImportBatch *batch = worker->batch;
+    char blockBuffer[BLOCK_SIZE];
+    for (int entryIndex = worker->firstEntry; entryIndex < batch->entryCount; entryIndex += worker->entryStride)
+    {
+        ImportEntry *entry = &batch->entries[entryIndex];
+        const char *data = batch->data + entry->dataOffset;
+        for (int offset = 0, block = 0; offset < entry->length; offset += BLOCK_SIZE, block++)
+        {
+            int pieceLength = (entry->length - offset < BLOCK_SIZE) ? entry->length - offset : BLOCK_SIZE;
+            memset(blockBuffer, 0, BLOCK_SIZE);
+            memcpy(blockBuffer, data + offset, pieceLength);
+            batch->fingerprints[entry->firstFingerprint + block] = fingerprintBlock(blockBuffer);
+        }
+    }
+    return NULL;
+}
+
+void flushImportBatch(ImportBatch *batch)
+{
+    if (batch->entryCount == 0)
+    {
+        return;
+    }
+    if (dedupEnabled)
+    {
+        long processorCount = sysconf(_SC_NPROCESSORS_ONLN);
+        int workerCount = processorCount < 1 ? 1 : (processorCount > IMPORT_MAX_HASH_THREADS ? IMPORT_MAX_HASH_THREADS : (int)processorCount);
+        FingerprintWorker workers[IMPORT_MAX_HASH_THREADS];
+        for (int index = 0; index < workerCount; index++)
+        {
+            workers[index].batch = batch;
+            workers[index].firstEntry = index;
+            workers[index].entryStride = workerCount;
+            if (index > 0)
+            {
+                pthread_create(&workers[index].thread, NULL, fingerprintImportEntries, &workers[index]);
+            }
+        }
+        fingerprintImportEntries(&workers[0]);
+        for (int index = 1; index < workerCount; index++)
+        {
+            pthread_join(workers[index].thread, NULL);
+        }
+    }
+
+    for (int entryIndex = 0; entryIndex < batch->entryCount && !batch->failed; entryIndex++)
+    {
+        ImportEntry *entry = &batch->entries[entryIndex];
+        const uint64_t *fingerprints = dedupEnabled ? batch->fingerprints + entry->firstFingerprint : NULL;
+        if (!storeFileDataWithFingerprints(entry->file, batch->data + entry->dataOffset, entry->length, fingerprints))
+        {
+            printf("Import stopped: out of space at %s.\n", nodeName(entry->file));
+            batch->failed = 1;
+        }
+    }
+    batch->entryCount = 0;
+    batch->dataLength = 0;
+    batch->fingerprintCount = 0;
+}
+
+/* Returns the slot for the file's bytes, flushing the batch first when it cannot take them. */
+char *reserveImportData(ImportBatch *batch, Node *file, int length)
+{
+    int blockCount = (length + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    if (batch->entryCount == IMPORT_BATCH_FILES || batch->dataLength + length > IMPORT_BATCH_BYTES)
+    {
+        flushImportBatch(batch);
+    }
+    ImportEntry *entry = &batch->entries[batch->entryCount++];
+    entry->file = file;
+    entry->dataOffset = batch->dataLength;
+    entry->length = length;
+    entry->firstFingerprint = batch->fingerprintCount;
+    batch->dataLength += length;
+    batch->fingerprintCount += blockCount;
+    batch->fileCount++;
+    batch->byteCount += length;
+    return batch->data + entry->dataOffset;
+}
+
+void abandonImportEntry(ImportBatch *batch)
+{
+    ImportEntry *entry = &batch->entries[--batch->entryCount];
+    batch->dataLength -= entry->length;
+    batch->fingerprintCount -= (entry->length + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    batch->byteCount -= entry->length;
+    batch->fileCount--;
+    batch->skippedCount++;
+}
+
+int initializeImportBatch(ImportBatch *batch)
+{
+    memset(batch, 0, sizeof(*batch));
+    batch->data = (char *)malloc(IMPORT_BATCH_BYTES);
+    batch->fingerprints = (uint64_t *)malloc((IMPORT_BATCH_BYTES / BLOCK_SIZE + IMPORT_BATCH_FILES) * sizeof(uint64_t));
+    if (batch->data == NULL || batch->fingerprints == NULL)
+    {
+        printf("Memory allocation failed.");
+        free(batch->data);
+        free(batch->fingerprints);
+        return 0;
+    }
+    threadBlockCacheLimit = IMPORT_BLOCK_BATCH;
+    return 1;
+}
+
+void finishImportBatch(ImportBatch *batch, struct timespec *startTime)
+{
+    flushImportBatch(batch);
+    releaseThreadBlockCache();
+    threadBlockCacheLimit = BLOCK_CACHE_BATCH;
+    free(batch->data);
+    free(batch->fingerprints);
+
+    struct timespec endTime;
+    clock_gettime(CLOCK_MONOTONIC, &endTime);
+    double seconds = (endTime.tv_sec - startTime->tv_sec) + (endTime.tv_nsec - startTime->tv_nsec) / 1e9;
+    printf("Imported %d files and %d directories (%ld bytes) in %.2f s, skipped %d.\n", batch->fileCount, batch->folderCount, batch->byteCount, seconds, batch->skippedCount);
+    if (journalFile != NULL && !writeCheckpoint())
+    {
+        printf("Warning: imported data is not yet durable.\n");
+    }
+}
+
+typedef struct HostImportFrame
+{
+    char *hostPath;
+    Node *folder;
+} HostImportFrame;
+
+int readHostFile(const char *hostPath, char *buffer, int length)
+{
+    int descriptor = open(hostPath, O_RDONLY);
+    if (descriptor < 0)
+    {
+        return 0;
+    }
+    int total = 0;
+    while (total < length)
+    {
+        ssize_t readCount = read(descriptor, buffer + total, length - total);
+        if (readCount <= 0)
+        {
+            break;
+        }
+        total += (int)readCount;
+    }
+    close(descriptor);
+    return total == length;
+}
+
+void importHostDirectory(const char *hostRoot, ImportBatch *batch)
+{
+    HostImportFrame *frames = NULL;
+    int frameCount = 0;
+    int frameCapacity = 0;
+    char childPath[PATH_MAX];
+
+    frames = (HostImportFrame *)malloc(INITIAL_STACK_CAPACITY * sizeof(HostImportFrame));
+    if (frames == NULL)
+    {
+        printf("Memory allocation failed.");
+        return;
+    }
+    frameCapacity = INITIAL_STACK_CAPACITY;
+    frames[frameCount++] = (HostImportFrame){strdup(hostRoot), currentDirectory};
+
+    while (frameCount > 0 && !batch->failed)
+    {
+        HostImportFrame frame = frames[--frameCount];
+        DIR *directory = opendir(frame.hostPath);
+        if (directory == NULL)
+        {
+            printf("Cannot open %s.\n", frame.hostPath);
+            free(frame.hostPath);
+            continue;
+        }
+        struct dirent *hostEntry;
+        while ((hostEntry = readdir(directory)) != NULL && !batch->failed)
+        {
+            const char *name = hostEntry->d_name;
+            struct stat status;
+            if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0)
+            {
+                continue;
+            }
+            snprintf(childPath, sizeof(childPath), "%s/%s", frame.hostPath, name);
+            if (lstat(childPath, &status) != 0 || strlen(name) > MAX_INTERNED_NAME_LENGTH
+                || !(S_ISDIR(status.st_mode) || S_ISREG(status.st_mode)) || (S_ISREG(status.st_mode) && status.st_size > MAX_FILE_SIZE))
+            {
+                batch->skippedCount++;
+                continue;
+            }
+
+            Node *existing = findChildNode(frame.folder, name);
+            if (existing != NULL && !(existing->isFolder && S_ISDIR(status.st_mode)))
+            {
+                batch->skippedCount++;
+                continue;
+            }
+            Node *node = existing;
+            if (node == NULL)
+            {
+                node = createDetachedNode(name, S_ISDIR(status.st_mode));
+                if (node == NULL)
+                {
+                    batch->failed = 1;
+                    break;
+                }
+                if (!appendChildNode(frame.folder, node))
+                {
+                    releaseInode(node);
+                    batch->failed = 1;
+                    break;
+                }
+            }
+
+            if (node->isFolder)
+            {
+                batch->folderCount += existing == NULL;
+                if (frameCount == frameCapacity)
+                {
+                    HostImportFrame *grownFrames = (HostImportFrame *)realloc(frames, frameCapacity * 2 * sizeof(HostImportFrame));
+                    if (grownFrames == NULL)
+                    {
+                        printf("Memory allocation failed.");
+                        batch->failed = 1;
+                        break;
+                    }
+                    frames = grownFrames;
+                    frameCapacity *= 2;
+                }
+                frames[frameCount++] = (HostImportFrame){strdup(childPath), node};
+            }
+            else if (!readHostFile(childPath, reserveImportData(batch, node, (int)status.st_size), (int)status.st_size))
+            {
+                printf("Cannot read %s.\n", childPath);
+                abandonImportEntry(batch);
+            }
+        }
+        closedir(directory);
+        free(frame.hostPath);
+    }
+
+    while (frameCount > 0)
+    {
+        free(frames[--frameCount].hostPath);
+    }
+    free(frames);
+}
+
+long parseTarOctal(const char *field, int length)
+{
+    long value = 0;
+    for (int index = 0; index < length && field[index] != '\0' && field[index] != ' '; index++)
+    {
+        if (field[index] < '0' || field[index] > '7')
+        {
+            return -1;
+        }
+        value = value * 8 + (field[index] - '0');
+    }
+    return value;
+}
+
+uint32_t tarHeaderChecksum(const unsigned char *header)
+{
+    uint32_t checksum = 0;
+    for (int index = 0; index < TAR_BLOCK_SIZE; index++)
+    {
+        checksum += (index >= 148 && index < 156) ? ' ' : header[index];
+    }
+    return checksum;
+}
+
+/* Walks path components under the current directory, creating folders on the way; returns the folder holding the leaf. */
+Node *resolveArchivePath(char *path, char **leafName, ImportBatch *batch)
+{
+    Node *folder = currentDirectory;
+    char *component = path;
+    while (*component == '/' || (component[0] == '.' && component[1] == '/'))
+    {
+        component += (*component == '/') ? 1 : 2;
+    }
+    char *slash;
+    while ((slash = strchr(component, '/')) != NULL)
+    {
+        *slash = '\0';
+        if (*component != '\0' && strcmp(component, ".") != 0)
+        {
+            Node *child = findChildNode(folder, component);
+            if (child == NULL)
+            {
+                if (strlen(component) > MAX_INTERNED_NAME_LENGTH || (child = createDetachedNode(component, 1)) == NULL)
+                {
+                    return NULL;
+                }
+                if (!appendChildNode(folder, child))
+                {
+                    releaseInode(child);
+                    return NULL;
+                }
+                batch->folderCount++;
+            }
+            else if (!child->isFolder)
+            {
+                return NULL;
+            }
+            folder = child;
+        }
+        component = slash + 1;
+    }
+    *leafName = component;
+    return folder;
+}
+
+void importTarArchive(const char *archivePath, ImportBatch *batch)
+{
+    FILE *archive = fopen(archivePath, "rb");
+    if (archive == NULL)
+    {
+        printf("Cannot open %s.\n", archivePath);
+        return;
+    }
+    setvbuf(archive, NULL, _IOFBF, IMPORT_STREAM_BUFFER);
+
+    unsigned char header[TAR_BLOCK_SIZE];
+    char path[MAX_PATH_LENGTH];
+    char longName[MAX_PATH_LENGTH + TAR_BLOCK_SIZE] = "";
+    char padding[TAR_BLOCK_SIZE];
+    while (!batch->failed && fread(header, 1, TAR_BLOCK_SIZE, archive) == TAR_BLOCK_SIZE)
+    {
+        if (header[0] == '\0')
+        {
+            break;
+        }
+        long size = parseTarOctal((const char *)header + 124, 12);
+        if (size < 0 || parseTarOctal((const char *)header + 148, 8) != (long)tarHeaderChecksum(header))
+        {
+            printf("%s is not a valid tar archive.\n", archivePath);
+            break;
+        }
+        long paddedSize = (size + TAR_BLOCK_SIZE - 1) / TAR_BLOCK_SIZE * TAR_BLOCK_SIZE;
+        char type = (char)header[156];
+
+        if (type == 'L' && paddedSize <= (long)sizeof(longName) - TAR_BLOCK_SIZE)
+        {
+            if (fread(longName, 1, paddedSize, archive) != (size_t)paddedSize)
+            {
+                break;
+            }
+            longName[size] = '\0';
+            continue;
+        }
+        if (longName[0] != '\0')
+        {
+            snprintf(path, sizeof(path), "%s", longName);
+            longName[0] = '\0';
+        }
+        else if (memcmp(header + 257, "ustar", 6) == 0 && header[345] != '\0')
+        {
+            snprintf(path, sizeof(path), "%.*s/%.*s", TAR_PREFIX_LENGTH, (const char *)header + 345, TAR_NAME_LENGTH, (const char *)header);
+        }
+        else
+        {
+            snprintf(path, sizeof(path), "%.*s", TAR_NAME_LENGTH, (const char *)header);
+        }
+        size_t pathLength = strlen(path);
+        if (type == '5' && pathLength > 0 && path[pathLength - 1] != '/')
+        {
+            strcat(path, "/");
+        }
+
+        char *leafName = NULL;
+        Node *folder = (type == '0' || type == '\0' || type == '5') ? resolveArchivePath(path, &leafName, batch) : NULL;
+        int consumed = 0;
+        if (folder != NULL && (type == '0' || type == '\0') && *leafName != '\0' && size <= MAX_FILE_SIZE
+            && strlen(leafName) <= MAX_INTERNED_NAME_LENGTH && findChildNode(folder, leafName) == NULL)
+        {
+            Node *file = createDetachedNode(leafName, 0);
+            if (file == NULL)
+            {
+                break;
+            }
+            if (!appendChildNode(folder, file))
+            {
+                releaseInode(file);
+                batch->failed = 1;
+                break;
+            }
+            char *target = reserveImportData(batch, file, (int)size);
+            if (fread(target, 1, size, archive) != (size_t)size)
+            {
+                printf("%s is truncated.\n", archivePath);
+                abandonImportEntry(batch);
+                break;
+            }
+            consumed = (int)size;
+        }
+        else if (folder == NULL || type != '5')
+        {
+            batch->skippedCount++;
+        }
+
+        for (long remaining = paddedSize - consumed; remaining > 0; remaining -= TAR_BLOCK_SIZE)
+        {
+            size_t pieceLength = remaining < TAR_BLOCK_SIZE ? (size_t)remaining : TAR_BLOCK_SIZE;
+            if (fread(padding, 1, pieceLength, archive) != pieceLength)
+            {
+                break;
+            }
+        }
+    }
+    fclose(archive);
+}
+
+int hasTarSuffix(const char *path)
+{
+    size_t length = strlen(path);
+    return length > 4 && strcmp(path + length - 4, ".tar") == 0;
+}
+
+void importHostTree(char *hostPath)
+{
+    struct stat status;
+    if (stat(hostPath, &status) != 0)
+    {
+        printf("Cannot access %s.\n", hostPath);
+        return;
+    }
+    ImportBatch *batch = (ImportBatch *)malloc(sizeof(ImportBatch));
+    if (batch == NULL || !initializeImportBatch(batch))
+    {
+        free(batch);
+        return;
+    }
+    struct timespec startTime;
+    clock_gettime(CLOCK_MONOTONIC, &startTime);
+    if (S_ISDIR(status.st_mode))
+    {
+        importHostDirectory(hostPath, batch);
+    }
+    else
+    {
+        importTarArchive(hostPath, batch);
+    }
+    finishImportBatch(batch, &startTime);
+    free(batch);
+}
+
+int readWholeFile(Node *file, char *content)
+{
+    int offset = 0;
+    for (int chunkIndex = 0; chunkIndex < fileChunkCount(file); chunkIndex++)
+    {
+        int rawLength = readFileChunk(file, chunkIndex, content + offset);
+        if (rawLength < 0)
+        {
+            return -1;
+        }
+        offset += rawLength;
+    }
+    return offset;
+}
+
+void writeTarOctal(char *field, int length, long value)
+{
+    field[length - 1] = '\0';
+    for (int index = length - 2; index >= 0; index--)
+    {
+        field[index] = (char)('0' + (value & 7));
+        value >>= 3;
+    }
+}
+
+int writeTarHeader(FILE *archive, const char *path, int isFolder, int size)
+{
+    unsigned char header[TAR_BLOCK_SIZE];
+    memset(header, 0, sizeof(header));
+    size_t pathLength = strlen(path);
+    if (pathLength <= TAR_NAME_LENGTH)
+    {
+        memcpy(header, path, pathLength);
+    }
+    else
+    {
+        const char *split = path + pathLength - TAR_NAME_LENGTH - 1;
+        while (*split != '\0' && *split != '/')
+        {
+            split++;
+        }
+        if (*split == '\0' || split - path > TAR_PREFIX_LENGTH || split[1] == '\0')
+        {
+            return 0;
+        }
+        memcpy(header + 345, path, split - path);
+        memcpy(header, split + 1, strlen(split + 1));
+    }
+    writeTarOctal((char *)header + 100, 8, isFolder ? 0755 : 0644);
+    writeTarOctal((char *)header + 108, 8, 0);
+    writeTarOctal((char *)header + 116, 8, 0);
+    writeTarOctal((char *)header + 124, 12, size);
+    writeTarOctal((char *)header + 136, 12, (long)time(NULL));
+    header[156] = isFolder ? '5' : '0';
+    memcpy(header + 257, "ustar", 6);
+    memcpy(header + 263, "00", 2);
+    writeTarOctal((char *)header + 148, 7, tarHeaderChecksum(header));
+    header[155] = ' ';
+    return fwrite(header, 1, TAR_BLOCK_SIZE, archive) == TAR_BLOCK_SIZE;
+}
+
+int exportNodeToHost(Node *node, const char *hostPath, FILE *archive, const char *archivePath, char *content)
+{
+    if (node->isFolder)
+    {
+        if (archive != NULL)
+        {
+            char folderPath[MAX_PATH_LENGTH + 2];
+            snprintf(folderPath, sizeof(folderPath), "%s/", archivePath);
+            return writeTarHeader(archive, folderPath, 1, 0);
+        }
+        return mkdir(hostPath, 0755) == 0 || errno == EEXIST;
+    }
+
+    int length = readWholeFile(node, content);
+    if (length < 0)
+    {
+        return 0;
+    }
+    if (archive != NULL)
+    {
+        static const char zeroPadding[TAR_BLOCK_SIZE];
+        int paddingLength = (TAR_BLOCK_SIZE - length % TAR_BLOCK_SIZE) % TAR_BLOCK_SIZE;
+        return writeTarHeader(archive, archivePath, 0, length) && fwrite(content, 1, length, archive) == (size_t)length
+            && fwrite(zeroPadding, 1, paddingLength, archive) == (size_t)paddingLength;
+    }
+    int descriptor = open(hostPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (descriptor < 0)
+    {
+        return 0;
+    }
+    int written = write(descriptor, content, length) == length;
+    return close(descriptor) == 0 && written;
+}
+
+void exportHostTree(char *hostPath)
+{
+    FILE *archive = NULL;
+    if (hasTarSuffix(hostPath))
+    {
+        archive = fopen(hostPath, "wb");
+        if (archive == NULL)
+        {
+            printf("Cannot create %s.\n", hostPath);
+            return;
+        }
+        setvbuf(archive, NULL, _IOFBF, IMPORT_STREAM_BUFFER);
+    }
+    else if (mkdir(hostPath, 0755) != 0 && errno != EEXIST)
+    {
+        printf("Cannot create %s.\n", hostPath);
+        return;
+    }
+
+    char *content = (char *)malloc(MAX_FILE_SIZE);
+    NodeStack pendingNodes;
+    initializeNodeStack(&pendingNodes);
+    int exportedCount = 0;
+    int failedCount = 0;
+    long byteCount = 0;
+    char relativePath[MAX_PATH_LENGTH];
+    char nodePath[MAX_PATH_LENGTH];
+    char basePath[MAX_PATH_LENGTH];
+    char targetPath[PATH_MAX];
+    buildNodePath(currentDirectory, basePath, sizeof(basePath));
+    size_t baseLength = currentDirectory == rootDirectory ? 0 : strlen(basePath);
+
+    Node *node;
+    int pushed = content != NULL && pushChildrenInOrder(&pendingNodes, currentDirectory);
+    while (pushed && (node = popNode(&pendingNodes)) != NULL)
+    {
+        buildNodePath(node, nodePath, sizeof(nodePath));
+        snprintf(relativePath, sizeof(relativePath), "%s", nodePath + baseLength + 1);
+        snprintf(targetPath, sizeof(targetPath), "%s/%s", hostPath, relativePath);
+        if (exportNodeToHost(node, targetPath, archive, relativePath, content))
+        {
+            exportedCount++;
+            byteCount += node->isFolder ? 0 : node->dataSize;
+        }
+        else
+        {
+            printf("Cannot export %s.\n", relativePath);
+            failedCount++;
+        }
+        if (node->isFolder)
+        {
+            lockDirectoryForWalk(node, 0);
+            pushed = pushChildrenInOrder(&pendingNodes, node);
+            unlockDirectoryForWalk(node);
+        }
+    }
+    destroyNodeStack(&pendingNodes);
+    free(content);
+
+    if (archive != NULL)
+    {
+        static const char endOfArchive[2 * TAR_BLOCK_SIZE];
+        if (fwrite(endOfArchive, 1, sizeof(endOfArchive), archive) != sizeof(endOfArchive) || fclose(archive) != 0)
+        {
+            printf("Cannot finish %s.\n", hostPath);
+            return;
+        }
+    }
+    printf("Exported %d entries (%ld bytes) to %s, %d failed.\n", exportedCount, byteCount, hostPath, failedCount);
+}
+
+void freeAllBlocks()
+{
+    DiskBlock *temporaryNode = freeBlockListHead;
+    while (temporaryNode)
+    {
+        DiskBlock *next = temporaryNode->next;
+        free(temporaryNode);
+        temporaryNode = next;
+    }
+    freeBlockListHead = NULL;
+}
+
+void releaseAllNodes(Node *node)
+{
+    if (!node) {
+        return;
+    }
+    int releasedBlocks[TOTAL_DISK_BLOCKS];
+    int releasedCount = 0;
+    releaseSubtree(node, releasedBlocks, &releasedCount);
+    releaseBlocksInBulk(releasedBlocks, releasedCount);
+}
+
+void exitVFS()
+{
+    unmountImage();
+    reclaimRetiredSubtrees();
+    releaseAllNodes(rootDirectory);
+    rootDirectory = NULL;
+    currentDirectory = NULL;
+    releaseInodeTable();
+    freeAllBlocks();
+    printf("Memory released. Exiting program...\n");
+}
+
+typedef struct BenchmarkWorker
+{
+    pthread_t thread;
+    Node *directory;
+    int operations;
+    unsigned int randomState;
+} BenchmarkWorker;
+
+void *runBenchmarkReads(void *argument)
+{
+    BenchmarkWorker *worker = (BenchmarkWorker *)argument;
+    char chunkBuffer[COMPRESSION_CHUNK_SIZE];
+    char fileName[MAX_FILENAME_LENGTH];
+    pthread_rwlock_rdlock(&vfsBarrierLock);
+    setCurrentDirectory(worker->directory);
+
+    for (int operation = 0; operation < worker->operations; operation++)
+    {
+        snprintf(fileName, sizeof(fileName), "file%d", rand_r(&worker->randomState) % BENCH_FILES_PER_WORKER);
+        pthread_rwlock_rdlock(&currentDirectory->directory->lock);
+        Node *file = findChildNode(currentDirectory, fileName);
+        if (file != NULL)
+        {
+            readFileChunk(file, 0, chunkBuffer);
+        }
+        pthread_rwlock_unlock(&currentDirectory->directory->lock);
+    }
+
+    setCurrentDirectory(NULL);
+    pthread_rwlock_unlock(&vfsBarrierLock);
+    return NULL;
+}
+
+void *runBenchmarkWrites(void *argument)
+{
+    BenchmarkWorker *worker = (BenchmarkWorker *)argument;
+    char payload[BENCH_FILE_SIZE];
+    char fileName[MAX_FILENAME_LENGTH];
+    pthread_rwlock_rdlock(&vfsBarrierLock);
+    setCurrentDirectory(worker->directory);
+
+    for (int operation = 0; operation < worker->operations; operation++)
+    {
+        memset(payload, 'a' + operation % 26, sizeof(payload));
+        snprintf(fileName, sizeof(fileName), "file%d", rand_r(&worker->randomState) % BENCH_FILES_PER_WORKER);
+        pthread_rwlock_wrlock(&currentDirectory->directory->lock);
+        Node *file = findChildNode(currentDirectory, fileName);
+        if (file != NULL)
+        {
+            storeFileData(file, payload, sizeof(payload));
+        }
+        pthread_rwlock_unlock(&currentDirectory->directory->lock);
+    }
+
+    setCurrentDirectory(NULL);
+    releaseThreadBlockCache();
+    pthread_rwlock_unlock(&vfsBarrierLock);
+    return NULL;
+}
+
+double runBenchmarkPhase(BenchmarkWorker workers[], int workerCount, void *(*phase)(void *))
+{
+    struct timespec startTime;
+    struct timespec endTime;
+    clock_gettime(CLOCK_MONOTONIC, &startTime);
+    for (int index = 0; index < workerCount; index++)
+    {
+        pthread_create(&workers[index].thread, NULL, phase, &workers[index]);
+    }
+    for (int index = 0; index < workerCount; index++)
+    {
+        pthread_join(workers[index].thread, NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &endTime);
+    return (endTime.tv_sec - startTime.tv_sec) + (endTime.tv_nsec - startTime.tv_nsec) / 1e9;
+}
+
+Node *createBenchmarkDirectory(int workerId)
+{
+    char name[MAX_FILENAME_LENGTH];
+    char payload[BENCH_FILE_SIZE];
+    snprintf(name, sizeof(name), ".bench%d", workerId);
+    Node *directory = createDetachedNode(name, 1);
+    if (directory == NULL)
+    {
+        return NULL;
+    }
+    for (int fileIndex = 0; fileIndex < BENCH_FILES_PER_WORKER; fileIndex++)
+    {
+        snprintf(name, sizeof(name), "file%d", fileIndex);
+        Node *file = createDetachedNode(name, 0);
+        if (file == NULL)
+        {
+            break;
+        }
+        memset(payload, 'A' + fileIndex, sizeof(payload));
+        storeFileData(file, payload, sizeof(payload));
+        if (!appendChildNode(directory, file))
+        {
+            discardDetachedNode(file);
+            break;
+        }
+    }
+    pthread_rwlock_wrlock(&rootDirectory->directory->lock);
+    int attached = appendChildNode(rootDirectory, directory);
+    pthread_rwlock_unlock(&rootDirectory->directory->lock);
+    if (!attached)
+    {
+        releaseAllNodes(directory);
+        return NULL;
+    }
+    return directory;
+}
+
+void runConcurrencyBenchmark(int maxThreads, int operations)
+{
+    int blocksPerWorker = BENCH_FILES_PER_WORKER * (BENCH_FILE_SIZE / BLOCK_SIZE) * 2 + BLOCK_CACHE_BATCH;
+    if (maxThreads * blocksPerWorker > freeBlockCount)
+    {
+        maxThreads = freeBlockCount / blocksPerWorker;
+        printf("Limiting benchmark to %d threads to fit free blocks.\n", maxThreads);
+    }
+    if (maxThreads < 1 || operations < 1)
+    {
+        printf("Nothing to benchmark.\n");
+        return;
+    }
+
+    BenchmarkWorker *workers = (BenchmarkWorker *)calloc(maxThreads, sizeof(BenchmarkWorker));
+    if (workers == NULL)
+    {
+        printf("Memory allocation failed");
+        return;
+    }
+    int workerCount = 0;
+    for (int index = 0; index < maxThreads; index++)
+    {
+        workers[workerCount].directory = createBenchmarkDirectory(index);
+        workers[workerCount].operations = operations;
+        workers[workerCount].randomState = (unsigned int)index * 7919U + 1;
+        workerCount += workers[workerCount].directory != NULL;
+    }
+    if (workerCount < maxThreads)
+    {
+        printf("Only %d of %d benchmark directories could be created.\n", workerCount, maxThreads);
+        maxThreads = workerCount;
     }
-
-    Node *newFile = (Node *)malloc(sizeof(Node));
-    if (newFile == NULL) 
+    if (maxThreads == 0)
     {
-        printf("Memory allocation failed.");
+        free(workers);
         return;
     }
-    
-    strcpy(newFile->name, fileName);
-    newFile->isFolder = 0;
-    newFile->parent = currentDirectory;
-    newFile->firstChild = NULL;
-    newFile->dataSize = 0;
-    newFile->blockCount = 0;
 
-    for (int index = 0; index < MAX_BLOCKS_PER_FILE; index++)
+    printf("%-8s %-16s %-16s %-10s\n", "Threads", "Reads/sec", "Writes/sec", "Speedup");
+    double singleThreadReadRate = 0.0;
+    for (int threadCount = 1; threadCount <= maxThreads; threadCount *= 2)
     {
-        newFile->allocatedBlocks[index] = -1;
+        double readSeconds = runBenchmarkPhase(workers, threadCount, runBenchmarkReads);
+        double writeSeconds = runBenchmarkPhase(workers, threadCount, runBenchmarkWrites);
+        double readRate = (double)threadCount * operations / readSeconds;
+        double writeRate = (double)threadCount * operations / writeSeconds;
+        if (threadCount == 1)
+        {
+            singleThreadReadRate = readRate;
+        }
+        printf("%-8d %-16.0f %-16.0f %-10.2f\n", threadCount, readRate, writeRate, readRate / singleThreadReadRate);
+        if (threadCount < maxThreads && threadCount * 2 > maxThreads)
+        {
+            threadCount = maxThreads / 2;
+        }
     }
 
-    if (currentDirectory->firstChild == NULL)
+    pthread_rwlock_wrlock(&rootDirectory->directory->lock);
+    for (int index = 0; index < maxThreads; index++)
     {
-        currentDirectory->firstChild = newFile;
-        newFile->nextSibling = newFile;
+        int releasedCount = 0;
+        removeSubtree(rootDirectory, workers[index].directory, &releasedCount);
     }
-    else
+    pthread_rwlock_unlock(&rootDirectory->directory->lock);
+    free(workers);
+}
+
+void runSessionCommand(char *input);
+
+/* Every session shares the same few names, so they create, enter, walk and remove each other's directories. */
+void *runStressSession(void *argument)
+{
+    static const char *commandFormats[] = {"mkdir d%d", "cd d%d", "cd ..", "rm -r d%d", "rmdir d%d", "du", "find d*", "ls", "create f%d", "write f%d \"stress\"", "defrag"};
+    BenchmarkWorker *worker = (BenchmarkWorker *)argument;
+    char commandLine[MAX_INPUT_LENGTH];
+    setCurrentDirectory(worker->directory);
+
+    for (int operation = 0; operation < worker->operations; operation++)
     {
-        Node *temporaryNode = currentDirectory->firstChild;
-        while (temporaryNode->nextSibling != currentDirectory->firstChild)
+        const char *format = commandFormats[rand_r(&worker->randomState) % (sizeof(commandFormats) / sizeof(commandFormats[0]))];
+        int depth = nodeDepth(currentDirectory) - nodeDepth(worker->directory);
+        if (strcmp(format, "cd ..") == 0 && depth == 0)
+        {
+            format = "cd d%d";
+        }
+        else if (strcmp(format, "cd d%d") == 0 && depth >= STRESS_MAX_DEPTH)
         {
-            temporaryNode = temporaryNode->nextSibling;
+            format = "cd ..";
         }
-        newFile->nextSibling = temporaryNode->nextSibling;
-        temporaryNode->nextSibling = newFile;
+        snprintf(commandLine, sizeof(commandLine), format, rand_r(&worker->randomState) % STRESS_NAME_COUNT);
+        runSessionCommand(commandLine);
     }
-    printf("File '%s' created successfully.\n", fileName);
+
+    setCurrentDirectory(NULL);
+    releaseThreadBlockCache();
+    return NULL;
 }
 
-void writeContent(Node *file, char *data)
+/* Returns 0 if a folder's child ring, child count, name index or parent links disagree. */
+int checkSubtreeLinks(Node *subtreeRoot)
 {
-    if (!file || file->isFolder)
-    {
-        printf("Invalid file.\n");
-        return;
-    }
-    if (file->blockCount > 0)
-    {
-        releaseFileBlocks(file);
-    }
-    int length = strlen(data);
-    int blocksNeeded = (length + BLOCK_SIZE - 1) / BLOCK_SIZE;
-    file->dataSize = length;
-    file->blockCount = 0;
-    int offset = 0;
+    NodeStack pendingNodes;
+    initializeNodeStack(&pendingNodes);
+    int consistent = 1;
+    Node *folder = subtreeRoot;
 
-    for (int index = 0; index < blocksNeeded; index++)
+    while (folder && consistent)
     {
-        int temporaryIndex = allocateBlock();
-        if (temporaryIndex == -1)
+        uint32_t ringLength = 0;
+        Node *child = inodeAt(folder->firstChild);
+        while (child != NULL && consistent)
         {
-            return;
+            ringLength++;
+            consistent = child->parent == folder->inodeNumber && findChildNode(folder, nodeName(child)) == child
+                         && ringLength <= folder->directory->childCount && (!child->isFolder || pushNode(&pendingNodes, child));
+            child = inodeAt(child->nextSibling);
+            if (child == NULL || child->inodeNumber == folder->firstChild)
+            {
+                consistent = consistent && child != NULL;
+                break;
+            }
         }
-        file->allocatedBlocks[file->blockCount++] = temporaryIndex;
-        strncpy(diskMemory[temporaryIndex], data + offset, BLOCK_SIZE);
-        offset += BLOCK_SIZE;
+        consistent = consistent && ringLength == folder->directory->childCount;
+        folder = popNode(&pendingNodes);
     }
-    printf("Data written successfully(size = %d bytes)\n", file->dataSize);
+
+    destroyNodeStack(&pendingNodes);
+    return consistent;
 }
 
-void writeFile(char *fileName, char *data)
+/* Runs sessions through the real command dispatcher under .stress, then checks the tree and that every inode and block
+   came back. Command output is discarded while the sessions run. */
+void runStressTest(int sessionCount, int operations)
 {
-    if (data == NULL || strlen(data) < 2)
+    if (sessionCount < 1 || operations < 1)
     {
-        printf("Error: Missing or invalid data. Use quotes around your text.\n");
+        printf("Nothing to stress.\n");
         return;
     }
-
-    if (data[0] != '"' || data[strlen(data) - 1] != '"')
+    BenchmarkWorker *sessions = (BenchmarkWorker *)calloc(sessionCount, sizeof(BenchmarkWorker));
+    if (sessions == NULL)
     {
-        printf("Error: Data must be enclosed in double quotes. Example: write file \"Hello World\"\n");
+        printf("Memory allocation failed");
         return;
     }
 
-    data[strlen(data) - 1] = '\0';
-    data++;
-
-    int writeIndex = 0;
-    for (int index = 0; data[index] != '\0'; index++, writeIndex++)
+    pthread_rwlock_wrlock(&vfsBarrierLock);
+    sessionHasExclusiveAccess = 1;
+    reclaimRetiredSubtrees();
+    releaseThreadBlockCache();
+    uint32_t inodesBefore = liveInodeCount;
+    int freeBlocksBefore = freeBlockCount;
+    Node *stressRoot = findChildNode(rootDirectory, ".stress") == NULL ? createDetachedNode(".stress", 1) : NULL;
+    if (stressRoot != NULL && !appendChildNode(rootDirectory, stressRoot))
     {
-        if (data[index] == '\\' && data[index + 1] == 'n')
-        {
-            data[writeIndex] = '\n';
-            index++;
-        }
-        else
-        {
-            data[writeIndex] = data[index];
-        }
+        releaseInode(stressRoot);
+        stressRoot = NULL;
     }
-    data[writeIndex] = '\0';
-
-    Node *temporaryNode = currentDirectory->firstChild;
-    if (temporaryNode == NULL)
+    if (stressRoot != NULL)
     {
-        printf("Error: No files exist in the current directory.\n");
+        markNodeChanged(rootDirectory, 1);
+        journalBeginRecord(JOURNAL_MKDIR);
+        journalAppendPath(rootDirectory, ".stress");
+        journalAppendTimes(stressRoot);
+        journalAppendTimes(rootDirectory);
+        journalEndRecord();
+    }
+    sessionHasExclusiveAccess = 0;
+    pthread_rwlock_unlock(&vfsBarrierLock);
+    if (stressRoot == NULL)
+    {
+        printf("Cannot create /.stress; remove it first.\n");
+        free(sessions);
         return;
     }
 
-    do
+    fflush(stdout);
+    int savedOutput = dup(STDOUT_FILENO);
+    int discardOutput = open("/dev/null", O_WRONLY);
+    if (savedOutput >= 0 && discardOutput >= 0)
     {
-        if (strcmp(temporaryNode->name, fileName) == 0)
-        {
-            writeContent(temporaryNode, data);
-            return;
-        }
-        temporaryNode = temporaryNode->nextSibling;
-    } while (temporaryNode != currentDirectory->firstChild);
-
-    printf("Error: File '%s' not found in the current directory.\n", fileName);
-}
-
-void displayFileContent(Node *file)
-{
-    if (file->blockCount == 0)
+        dup2(discardOutput, STDOUT_FILENO);
+    }
+    struct timespec startTime;
+    struct timespec endTime;
+    clock_gettime(CLOCK_MONOTONIC, &startTime);
+    for (int index = 0; index < sessionCount; index++)
     {
-        printf("File is empty.\n");
-        return;
+        sessions[index].directory = stressRoot;
+        sessions[index].operations = operations;
+        sessions[index].randomState = (unsigned int)index * 7919U + 1;
+        pthread_create(&sessions[index].thread, NULL, runStressSession, &sessions[index]);
     }
-    for (int index = 0; index < file->blockCount; index++)
+    for (int index = 0; index < sessionCount; index++)
     {
-        int temporaryIndex = file->allocatedBlocks[index];
-        if (temporaryIndex >= 0)
-        {
-            printf("%s", diskMemory[temporaryIndex]);
-        }
+        pthread_join(sessions[index].thread, NULL);
     }
-    printf("\n");
+    clock_gettime(CLOCK_MONOTONIC, &endTime);
+    fflush(stdout);
+    if (savedOutput >= 0 && discardOutput >= 0)
+    {
+        dup2(savedOutput, STDOUT_FILENO);
+    }
+    if (savedOutput >= 0)
+    {
+        close(savedOutput);
+    }
+    if (discardOutput >= 0)
+    {
+        close(discardOutput);
+    }
+
+    pthread_rwlock_wrlock(&vfsBarrierLock);
+    sessionHasExclusiveAccess = 1;
+    int consistent = checkSubtreeLinks(stressRoot);
+    markNodeChanged(rootDirectory, 1);
+    journalBeginRecord(JOURNAL_REMOVE_TREE);
+    journalAppendPath(rootDirectory, ".stress");
+    journalAppendTimes(rootDirectory);
+    journalEndRecord();
+    int releasedCount = 0;
+    removeSubtree(rootDirectory, stressRoot, &releasedCount);
+    reclaimRetiredSubtrees();
+    long leakedInodes = (long)liveInodeCount - inodesBefore;
+    int leakedBlocks = freeBlocksBefore - freeBlockCount;
+    sessionHasExclusiveAccess = 0;
+    pthread_rwlock_unlock(&vfsBarrierLock);
+
+    double seconds = (endTime.tv_sec - startTime.tv_sec) + (endTime.tv_nsec - startTime.tv_nsec) / 1e9;
+    printf("Stress: %d sessions ran %d commands in %.2f s.\n", sessionCount, sessionCount * operations, seconds);
+    printf("Tree links %s, %ld inodes and %d blocks leaked.\n", consistent ? "consistent" : "CORRUPT", leakedInodes, leakedBlocks);
+    free(sessions);
 }
 
-void readFile(char *fileName)
+int commandLockMode(const char *command)
 {
-    Node *temporaryNode = currentDirectory->firstChild;
-    if (!temporaryNode)
+    static const char *readCommands[] = {"ls", "cd", "read", "find", "du", "export", "stat"};
+    static const char *writeCommands[] = {"mkdir", "create", "write", "delete", "rm", "rmdir", "cp", "compress"};
+    static const char *exclusiveCommands[] = {"dedup", "checkpoint", "import", "defrag", "exit"};
+    /* These start sessions of their own, so they must not hold the barrier while waiting for them. */
+    static const char *sessionCommands[] = {"stress"};
+    for (size_t index = 0; index < sizeof(readCommands) / sizeof(readCommands[0]); index++)
     {
-        printf("No file found.\n");
-        return;
+        if (strcmp(command, readCommands[index]) == 0)
+        {
+            return LOCK_MODE_READ;
+        }
     }
-    do
+    for (size_t index = 0; index < sizeof(writeCommands) / sizeof(writeCommands[0]); index++)
     {
-        if (strcmp(temporaryNode->name, fileName) == 0 && !temporaryNode->isFolder)
+        if (strcmp(command, writeCommands[index]) == 0)
         {
-            displayFileContent(temporaryNode);
-            return;
+            return LOCK_MODE_WRITE;
         }
-        temporaryNode = temporaryNode->nextSibling;
-    } while (temporaryNode != currentDirectory->firstChild);
-    printf("No file found with name %s.\n", fileName);
-}
-
-void removeFile(Node *file)
-{
-    releaseFileBlocks(file);
-    if (file->nextSibling == file)
-    {
-        currentDirectory->firstChild = NULL;
     }
-    else
+    for (size_t index = 0; index < sizeof(exclusiveCommands) / sizeof(exclusiveCommands[0]); index++)
     {
-        Node *temporaryNode = currentDirectory->firstChild;
-        while (temporaryNode->nextSibling != file && temporaryNode->nextSibling != currentDirectory->firstChild)
+        if (strcmp(command, exclusiveCommands[index]) == 0)
         {
-            temporaryNode = temporaryNode->nextSibling;
+            return LOCK_MODE_EXCLUSIVE;
         }
-        temporaryNode->nextSibling = file->nextSibling;
-        if (file == currentDirectory->firstChild)
+    }
+    for (size_t index = 0; index < sizeof(sessionCommands) / sizeof(sessionCommands[0]); index++)
+    {
+        if (strcmp(command, sessionCommands[index]) == 0)
         {
-            currentDirectory->firstChild = file->nextSibling;
+            return LOCK_MODE_SESSIONS;
         }
     }
-    free(file);
-    printf("File deleted successfully.\n");
+    return LOCK_MODE_NONE;
 }
 
-void deleteFileByName(char *fileName)
+void executeCommand(char *command, char **tokenState);
+
+/* Runs one command line for the calling session. strtok_r keeps concurrent sessions from sharing tokenizer state. */
+void runSessionCommand(char *input)
 {
-    if (currentDirectory->firstChild == NULL)
+    char *tokenState = NULL;
+    char *command = strtok_r(input, " ", &tokenState);
+    if (command == NULL)
     {
-        printf("No file found.\n");
         return;
     }
-    Node *temporaryNode = currentDirectory->firstChild;
-    do
-    {
-        if (strcmp(temporaryNode->name, fileName) == 0 && !temporaryNode->isFolder)
-        {
-            removeFile(temporaryNode);
-            return;
-        }
-        temporaryNode = temporaryNode->nextSibling;
-    } while (temporaryNode != currentDirectory->firstChild);
-    printf("No file found with name %s.\n", fileName);
-}
 
-void removeDirectory(char *dirName)
-{
-    if (currentDirectory->firstChild == NULL)
+    int lockMode = commandLockMode(command);
+    Node *lockedDirectory = currentDirectory;
+    if (lockMode == LOCK_MODE_EXCLUSIVE)
     {
-        printf("No directory found.\n");
-        return;
+        pthread_rwlock_wrlock(&vfsBarrierLock);
+        sessionHasExclusiveAccess = 1;
     }
-    Node *temporaryNode = currentDirectory->firstChild;
-    do
+    else if (lockMode != LOCK_MODE_SESSIONS)
     {
-        if (strcmp(temporaryNode->name, dirName) == 0)
+        pthread_rwlock_rdlock(&vfsBarrierLock);
+        if (lockMode == LOCK_MODE_READ)
         {
-            if (!temporaryNode->isFolder)
-            {
-                printf("%s is not a directory.\n", dirName);
-                return;
-            }
-            if (temporaryNode->firstChild != NULL)
-            {
-                printf("Directory not empty. Remove files first.\n");
-                return;
-            }
-            if (temporaryNode->nextSibling == temporaryNode)
-            {
-                currentDirectory->firstChild = NULL;
-            }
-            else
-            {
-                Node *node = currentDirectory->firstChild;
-                while (node->nextSibling != temporaryNode && node->nextSibling != currentDirectory->firstChild)
-                {
-                    node = node->nextSibling;
-                }
-                node->nextSibling = temporaryNode->nextSibling;
-                if (temporaryNode == currentDirectory->firstChild)
-                {
-                    currentDirectory->firstChild = temporaryNode->nextSibling;
-                }
-            }
-            free(temporaryNode);
-            printf("Directory removed successfully.\n");
-            return;
+            pthread_rwlock_rdlock(&lockedDirectory->directory->lock);
         }
-        temporaryNode = temporaryNode->nextSibling;
-    } while (temporaryNode != currentDirectory->firstChild);
-    printf("No directory found with name %s.\n", dirName);
-}
+        else if (lockMode == LOCK_MODE_WRITE)
+        {
+            pthread_rwlock_wrlock(&lockedDirectory->directory->lock);
+        }
+    }
 
-void showDiskUsage()
-{
-    int availableBlocks = 0;
-    DiskBlock *temporaryNode = freeBlockListHead;
-    while (temporaryNode)
+    executeCommand(command, &tokenState);
+
+    if (lockMode == LOCK_MODE_READ || lockMode == LOCK_MODE_WRITE)
     {
-        availableBlocks++;
-        temporaryNode = temporaryNode->next;
+        pthread_rwlock_unlock(&lockedDirectory->directory->lock);
     }
-    printf("Total blocks: %d\n", TOTAL_DISK_BLOCKS);
-    printf("Used blocks: %d\n", TOTAL_DISK_BLOCKS - availableBlocks);
-    printf("Free blocks: %d\n", availableBlocks);
-    printf("Disk usage: %.2f%%\n", (float)((TOTAL_DISK_BLOCKS - availableBlocks) * 100.0) / TOTAL_DISK_BLOCKS);
-}
-
-void freeAllBlocks()
-{
-    DiskBlock *temporaryNode = freeBlockListHead;
-    while (temporaryNode)
+    if (lockMode != LOCK_MODE_SESSIONS)
     {
-        DiskBlock *next = temporaryNode->next;
-        free(temporaryNode);
-        temporaryNode = next;
+        sessionHasExclusiveAccess = 0;
+        pthread_rwlock_unlock(&vfsBarrierLock);
     }
-    freeBlockListHead = NULL;
-}
 
-void releaseAllNodes(Node *node)
-{
-    if (!node) {
-        return;
-    }
-    Node *child = node->firstChild;
-    if (child)
+    if (checkpointRequested)
     {
-        Node *start = child;
-        do
-        {
-            Node *nextChild = child->nextSibling;
-            releaseAllNodes(child);
-            child = (nextChild == start) ? NULL : nextChild;
-        } while (child);
+        pthread_rwlock_wrlock(&vfsBarrierLock);
+        sessionHasExclusiveAccess = 1;
+        checkpointRequested = 0;
+        writeCheckpoint();
+        sessionHasExclusiveAccess = 0;
+        pthread_rwlock_unlock(&vfsBarrierLock);
     }
-    if (node->isFolder == 0)
+    /* If another session is mid-command the retired nodes wait for a later command. */
+    if (hasRetiredSubtrees() && pthread_rwlock_trywrlock(&vfsBarrierLock) == 0)
     {
-        releaseFileBlocks(node);
+        reclaimRetiredSubtrees();
+        pthread_rwlock_unlock(&vfsBarrierLock);
     }
-    free(node);
-}
-
-void exitVFS()
-{
-    releaseAllNodes(rootDirectory);
-    rootDirectory = NULL;
-    currentDirectory = NULL;
-    freeAllBlocks();
-    printf("Memory released. Exiting program...\n");
 }
 
 void handleUserInput()
 {
-    printf("%s > ", currentDirectory->name);
+    printf("%s > ", nodeName(currentDirectory));
     char input[MAX_INPUT_LENGTH];
     fgets(input, MAX_INPUT_LENGTH, stdin);
     input[strcspn(input, "\n")] = '\0';
+    runSessionCommand(input);
+}
 
-    char *command = strtok(input, " ");
-    if (command == NULL)
-    {
-        return;
-    }
-
+void executeCommand(char *command, char **tokenState)
+{
     if (strcmp(command, "mkdir") == 0)
     {
-        char *argument = strtok(NULL, " ");
+        char *argument = strtok_r(NULL, " ", tokenState);
         if (argument == NULL)
         {
             printf("Specify a directory name.\n");
@@ -610,7 +4507,7 @@ void handleUserInput()
     }
     else if (strcmp(command, "cd") == 0)
     {
-        char *argument = strtok(NULL, " ");
+        char *argument = strtok_r(NULL, " ", tokenState);
         if (argument == NULL)
         {
             printf("Specify a directory name.\n");
@@ -624,11 +4521,23 @@ void handleUserInput()
     }
     else if (strcmp(command, "ls") == 0)
     {
-        listDirectory();
+        listDirectory(strtok_r(NULL, " ", tokenState), tokenState);
+    }
+    else if (strcmp(command, "stat") == 0)
+    {
+        char *name = strtok_r(NULL, " ", tokenState);
+        if (name == NULL)
+        {
+            printf("Syntax: stat <name>\n");
+        }
+        else
+        {
+            showNodeStatus(name);
+        }
     }
     else if (strcmp(command, "create") == 0)
     {
-        char *argument = strtok(NULL, " ");
+        char *argument = strtok_r(NULL, " ", tokenState);
         if (argument == NULL)
         {
             printf("Specify a file name.\n");
@@ -638,8 +4547,8 @@ void handleUserInput()
     }
     else if (strcmp(command, "write") == 0)
     {
-        char *file = strtok(NULL, " ");
-        char *data = strtok(NULL, "\n");
+        char *file = strtok_r(NULL, " ", tokenState);
+        char *data = strtok_r(NULL, "\n", tokenState);
         if (!file || !data)
         {
             printf("Syntax: write filename \"data\"\n");
@@ -649,17 +4558,19 @@ void handleUserInput()
     }
     else if (strcmp(command, "read") == 0)
     {
-        char *file = strtok(NULL, " ");
+        char *file = strtok_r(NULL, " ", tokenState);
         if (!file)
         {
             printf("Specify a file name.\n");
             return;
         }
-        readFile(file);
+        char *offsetArgument = strtok_r(NULL, " ", tokenState);
+        char *lengthArgument = strtok_r(NULL, " ", tokenState);
+        readFile(file, offsetArgument ? atoi(offsetArgument) : 0, lengthArgument ? atoi(lengthArgument) : -1);
     }
     else if (strcmp(command, "delete") == 0)
     {
-        char *file = strtok(NULL, " ");
+        char *file = strtok_r(NULL, " ", tokenState);
         if (file == NULL)
         {
             printf("Specify a file name to delete.\n");
@@ -669,7 +4580,7 @@ void handleUserInput()
     }
     else if (strcmp(command, "rmdir") == 0)
     {
-        char *argument = strtok(NULL, " ");
+        char *argument = strtok_r(NULL, " ", tokenState);
         if (argument == NULL)
         {
             printf("Specify a directory to remove.\n");
@@ -677,6 +4588,58 @@ void handleUserInput()
         }
         removeDirectory(argument);
     }
+    else if (strcmp(command, "rm") == 0)
+    {
+        char *argument = strtok_r(NULL, " ", tokenState);
+        if (argument != NULL && strcmp(argument, "-r") == 0)
+        {
+            argument = strtok_r(NULL, " ", tokenState);
+            if (argument == NULL)
+            {
+                printf("Specify a file or directory to remove.\n");
+                return;
+            }
+            removeTreeRecursive(argument);
+            return;
+        }
+        if (argument == NULL)
+        {
+            printf("Specify a file name to delete.\n");
+            return;
+        }
+        deleteFileByName(argument);
+    }
+    else if (strcmp(command, "cp") == 0)
+    {
+        char *source = strtok_r(NULL, " ", tokenState);
+        int recursive = 0;
+        if (source != NULL && strcmp(source, "-r") == 0)
+        {
+            recursive = 1;
+            source = strtok_r(NULL, " ", tokenState);
+        }
+        char *destination = strtok_r(NULL, " ", tokenState);
+        if (source == NULL || destination == NULL)
+        {
+            printf("Syntax: cp [-r] source destination\n");
+            return;
+        }
+        copyTreeRecursive(source, destination, recursive);
+    }
+    else if (strcmp(command, "du") == 0)
+    {
+        showSubtreeUsage(strtok_r(NULL, " ", tokenState));
+    }
+    else if (strcmp(command, "find") == 0)
+    {
+        char *pattern = strtok_r(NULL, " ", tokenState);
+        if (pattern == NULL)
+        {
+            printf("Specify a name or pattern to find.\n");
+            return;
+        }
+        findNodes(pattern);
+    }
     else if (strcmp(command, "pwd") == 0)
     {
         printCurrentPath();
@@ -685,6 +4648,76 @@ void handleUserInput()
     {
         showDiskUsage();
     }
+    else if (strcmp(command, "compress") == 0)
+    {
+        char *file = strtok_r(NULL, " ", tokenState);
+        if (file == NULL)
+        {
+            printf("Specify a file name.\n");
+            return;
+        }
+        setFileCompression(file, strtok_r(NULL, " ", tokenState));
+    }
+    else if (strcmp(command, "dedup") == 0)
+    {
+        setDedupMode(strtok_r(NULL, " ", tokenState));
+    }
+    else if (strcmp(command, "sync") == 0)
+    {
+        if (journalFile == NULL)
+        {
+            printf("No image mounted.\n");
+            return;
+        }
+        if (commitJournal())
+        {
+            printf("Journal committed.\n");
+        }
+    }
+    else if (strcmp(command, "checkpoint") == 0)
+    {
+        if (journalFile == NULL)
+        {
+            printf("No image mounted.\n");
+            return;
+        }
+        if (writeCheckpoint())
+        {
+            printf("Checkpoint written to %s.\n", imagePath);
+        }
+    }
+    else if (strcmp(command, "import") == 0 || strcmp(command, "export") == 0)
+    {
+        char *hostPath = strtok_r(NULL, " ", tokenState);
+        if (hostPath == NULL)
+        {
+            printf("Syntax: %s <host-dir|archive.tar>\n", command);
+        }
+        else if (strcmp(command, "import") == 0)
+        {
+            importHostTree(hostPath);
+        }
+        else
+        {
+            exportHostTree(hostPath);
+        }
+    }
+    else if (strcmp(command, "defrag") == 0)
+    {
+        defragmentDisk();
+    }
+    else if (strcmp(command, "bench") == 0)
+    {
+        char *threadArgument = strtok_r(NULL, " ", tokenState);
+        char *operationArgument = strtok_r(NULL, " ", tokenState);
+        runConcurrencyBenchmark(threadArgument ? atoi(threadArgument) : 4, operationArgument ? atoi(operationArgument) : 200000);
+    }
+    else if (strcmp(command, "stress") == 0)
+    {
+        char *sessionArgument = strtok_r(NULL, " ", tokenState);
+        char *operationArgument = strtok_r(NULL, " ", tokenState);
+        runStressTest(sessionArgument ? atoi(sessionArgument) : 4, operationArgument ? atoi(operationArgument) : 20000);
+    }
     else if (strcmp(command, "exit") == 0)
     {
         exitVFS();
@@ -696,9 +4729,13 @@ void handleUserInput()
     }
 }
 
-int main()
+int main(int argc, char *argv[])
 {
     initializeVFS();
+    if (argc > 1 && !mountImage(argv[1]))
+    {
+        return 1;
+    }
     while (1)
     {
         handleUserInput();